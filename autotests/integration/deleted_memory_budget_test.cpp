@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "kwin_wayland_test.h"
+
+#include "abstract_client.h"
+#include "composite.h"
+#include "deleted.h"
+#include "effectloader.h"
+#include "platform.h"
+#include "surfaceitem.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <KConfigGroup>
+
+#include <DWayland/Client/surface.h>
+
+using namespace KWin;
+
+static const QString s_socketName = QStringLiteral("wayland_test_deleted_memory_budget-0");
+
+class DeletedMemoryBudgetTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testDropUnpaintedBurst();
+};
+
+void DeletedMemoryBudgetTest::initTestCase()
+{
+    // every kept window is over the budget
+    qputenv("KWIN_DELETED_MEMORY_BUDGET", QByteArrayLiteral("0"));
+
+    qRegisterMetaType<KWin::Deleted *>();
+    qRegisterMetaType<KWin::AbstractClient *>();
+    QSignalSpy applicationStartedSpy(kwinApp(), &Application::started);
+    QVERIFY(applicationStartedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName));
+
+    // no effect animates the closed windows
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    KConfigGroup plugins(config, QStringLiteral("Plugins"));
+    const auto builtinNames = EffectLoader().listOfKnownEffects();
+    for (const QString &name : builtinNames) {
+        plugins.writeEntry(name + QStringLiteral("Enabled"), false);
+    }
+    config->sync();
+    kwinApp()->setConfig(config);
+
+    qputenv("KWIN_COMPOSE", QByteArrayLiteral("O2"));
+
+    kwinApp()->start();
+    QVERIFY(applicationStartedSpy.wait());
+    Test::initWaylandWorkspace();
+    QVERIFY(Compositor::self());
+}
+
+void DeletedMemoryBudgetTest::init()
+{
+    QVERIFY(Test::setupWaylandConnection());
+}
+
+void DeletedMemoryBudgetTest::cleanup()
+{
+    Test::destroyWaylandConnection();
+}
+
+void DeletedMemoryBudgetTest::testDropUnpaintedBurst()
+{
+    // This test verifies that the contents of windows closed at once are dropped once
+    // they went unpainted for a while, even though nothing else touches them afterwards.
+
+    const int windowCount = 5;
+    QVector<KWayland::Client::Surface *> surfaces;
+    QVector<Test::XdgToplevel *> shellSurfaces;
+    QVector<Deleted *> deletedWindows;
+    for (int i = 0; i < windowCount; ++i) {
+        KWayland::Client::Surface *surface = Test::createSurface(this);
+        Test::XdgToplevel *shellSurface = Test::createXdgToplevelSurface(surface);
+        AbstractClient *client = Test::renderAndWaitForShown(surface, QSize(100, 50), Qt::blue);
+        QVERIFY(client);
+        // keep the deleted window around like a close animation would, without painting it
+        connect(client, &AbstractClient::windowClosed, this, [&deletedWindows](Toplevel *, Deleted *deleted) {
+            deleted->refWindow();
+            deletedWindows.append(deleted);
+        });
+        surfaces.append(surface);
+        shellSurfaces.append(shellSurface);
+    }
+
+    const quint64 droppedCount = Deleted::droppedSnapshotCount();
+    const quint64 retainedCount = Deleted::retainedSnapshotCount();
+
+    qDeleteAll(shellSurfaces);
+    qDeleteAll(surfaces);
+    QTRY_COMPARE(deletedWindows.count(), windowCount);
+
+    // all of them are within the grace period at first
+    QCOMPARE(Deleted::retainedSnapshotCount(), retainedCount + windowCount);
+    for (Deleted *deleted : qAsConst(deletedWindows)) {
+        QCOMPARE(deleted->retainedBytes(), quint64(100 * 50 * 4));
+        QVERIFY(deleted->surfaceItem());
+        QVERIFY(deleted->surfaceItem()->pixmap());
+    }
+
+    QTRY_COMPARE(Deleted::droppedSnapshotCount(), droppedCount + windowCount);
+    QCOMPARE(Deleted::retainedSnapshotCount(), retainedCount);
+    for (Deleted *deleted : qAsConst(deletedWindows)) {
+        QCOMPARE(deleted->retainedBytes(), quint64(0));
+        QVERIFY(!deleted->readyForPainting());
+        QVERIFY(deleted->surfaceItem());
+        QVERIFY(!deleted->surfaceItem()->pixmap());
+        deleted->unrefWindow();
+    }
+}
+
+WAYLANDTEST_MAIN(DeletedMemoryBudgetTest)
+#include "deleted_memory_budget_test.moc"
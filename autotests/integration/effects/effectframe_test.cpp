@@ -0,0 +1,167 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "kwin_wayland_test.h"
+
+#include "composite.h"
+#include "cursor.h"
+#include "effectloader.h"
+#include "effects.h"
+#include "platform.h"
+#include "renderbackend.h"
+#include "scene.h"
+#include "wayland_server.h"
+
+#include <KConfigGroup>
+
+#include <QFontDatabase>
+#include <QPainter>
+
+using namespace KWin;
+
+static const QString s_socketName = QStringLiteral("wayland_test_effects_effectframe-0");
+// the frame and the margin around it that has to stay untouched
+static const QRect s_frameGeometry(100, 100, 240, 60);
+static const int s_margin = 20;
+
+Q_DECLARE_METATYPE(Qt::Alignment)
+
+class EffectFrameTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testTextMatchesPainter_data();
+    void testTextMatchesPainter();
+};
+
+void EffectFrameTest::initTestCase()
+{
+    QSignalSpy applicationStartedSpy(kwinApp(), &Application::started);
+    QVERIFY(applicationStartedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName));
+
+    // nothing but the frame is painted on top of the empty scene
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    KConfigGroup plugins(config, QStringLiteral("Plugins"));
+    const auto builtinNames = EffectLoader().listOfKnownEffects();
+    for (const QString &name : builtinNames) {
+        plugins.writeEntry(name + QStringLiteral("Enabled"), false);
+    }
+    config->sync();
+    kwinApp()->setConfig(config);
+
+    qputenv("KWIN_COMPOSE", QByteArrayLiteral("O2"));
+
+    kwinApp()->start();
+    QVERIFY(applicationStartedSpy.wait());
+    QVERIFY(Compositor::self());
+    QCOMPARE(Compositor::self()->backend()->compositingType(), KWin::OpenGLCompositing);
+
+    Cursors::self()->mouse()->setPos(QPoint(1279, 1023));
+}
+
+/**
+ * Returns the rows and columns covered by text in @p image.
+ */
+static QRect inkBounds(const QImage &image)
+{
+    QRect bounds;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            if (qGray(image.pixel(x, y)) > 96) {
+                bounds |= QRect(x, y, 1, 1);
+            }
+        }
+    }
+    return bounds;
+}
+
+/**
+ * Returns the number of separate bands of rows covered by text, i.e. the visible lines.
+ */
+static int inkLines(const QImage &image)
+{
+    int lines = 0;
+    bool previousRowInked = false;
+    for (int y = 0; y < image.height(); ++y) {
+        bool inked = false;
+        for (int x = 0; x < image.width() && !inked; ++x) {
+            inked = qGray(image.pixel(x, y)) > 96;
+        }
+        if (inked && !previousRowInked) {
+            lines++;
+        }
+        previousRowInked = inked;
+    }
+    return lines;
+}
+
+void EffectFrameTest::testTextMatchesPainter_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<Qt::Alignment>("alignment");
+    QTest::addColumn<int>("lines");
+
+    QTest::newRow("single line") << QStringLiteral("Caption") << Qt::Alignment(Qt::AlignCenter) << 1;
+    QTest::newRow("multi line") << QStringLiteral("First\nSecond") << Qt::Alignment(Qt::AlignCenter) << 2;
+    QTest::newRow("multi line right") << QStringLiteral("First\nSecond") << Qt::Alignment(Qt::AlignRight | Qt::AlignTop) << 2;
+    QTest::newRow("elided") << QStringLiteral("A caption that is a lot wider than the frame it is shown in")
+                            << Qt::Alignment(Qt::AlignLeft | Qt::AlignVCenter) << 1;
+    QTest::newRow("clipped") << QStringLiteral("First\nSecond\nThird\nFourth") << Qt::Alignment(Qt::AlignLeft | Qt::AlignTop) << 3;
+}
+
+void EffectFrameTest::testTextMatchesPainter()
+{
+    // the effect frame texts drawn from the glyph atlas have to be laid out and clipped
+    // like QPainter::drawText() draws them
+    QFETCH(QString, text);
+    QFETCH(Qt::Alignment, alignment);
+
+    QFont font = QFontDatabase::systemFont(QFontDatabase::GeneralFont);
+    font.setPixelSize(20);
+
+    QScopedPointer<EffectFrame> frame(effects->effectFrame(EffectFrameNone, true, QPoint(), alignment));
+    frame->setFont(font);
+    frame->setGeometry(s_frameGeometry);
+    frame->setText(text);
+
+    Scene *scene = Compositor::self()->scene();
+    const QMetaObject::Connection connection = connect(scene, &Scene::frameRendered, this, [&frame]() {
+        frame->render();
+    });
+    const QRect grabRect = s_frameGeometry.adjusted(-s_margin, -s_margin, s_margin, s_margin);
+    const QImage image = Test::renderAndGrabFrame(grabRect);
+    disconnect(connection);
+    QVERIFY(!image.isNull());
+
+    // what the frame used to paint into a texture of its size
+    QImage reference(grabRect.size(), QImage::Format_RGB32);
+    reference.fill(Qt::black);
+    QPainter painter(&reference);
+    const QRect frameRect(QPoint(s_margin, s_margin), s_frameGeometry.size());
+    painter.setClipRect(frameRect);
+    painter.setFont(font);
+    painter.setPen(Qt::white);
+    painter.drawText(frameRect, alignment, QFontMetrics(font).elidedText(text, Qt::ElideRight, frameRect.width()));
+    painter.end();
+
+    QTEST(inkLines(image), "lines");
+    QCOMPARE(inkLines(image), inkLines(reference));
+
+    const QRect bounds = inkBounds(image);
+    const QRect referenceBounds = inkBounds(reference);
+    QVERIFY(frameRect.contains(bounds));
+    // the glyphs are placed on whole pixels
+    QVERIFY2(qAbs(bounds.left() - referenceBounds.left()) <= 2 && qAbs(bounds.right() - referenceBounds.right()) <= 2
+                 && qAbs(bounds.top() - referenceBounds.top()) <= 2 && qAbs(bounds.bottom() - referenceBounds.bottom()) <= 2,
+             qPrintable(QStringLiteral("%1,%2 %3x%4 != %5,%6 %7x%8")
+                            .arg(bounds.x()).arg(bounds.y()).arg(bounds.width()).arg(bounds.height())
+                            .arg(referenceBounds.x()).arg(referenceBounds.y()).arg(referenceBounds.width()).arg(referenceBounds.height())));
+}
+
+WAYLANDTEST_MAIN(EffectFrameTest)
+#include "effectframe_test.moc"
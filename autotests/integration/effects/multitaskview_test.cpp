@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "kwin_wayland_test.h"
+
+#include "abstract_client.h"
+#include "composite.h"
+#include "cursor.h"
+#include "effectloader.h"
+#include "effects.h"
+#include "platform.h"
+#include "renderbackend.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <KConfigGroup>
+
+#include <DWayland/Client/surface.h>
+
+using namespace KWin;
+
+static const QString s_socketName = QStringLiteral("wayland_test_effects_multitaskview-0");
+static const QString s_effectName = QStringLiteral("multitaskview");
+
+class MultitaskViewTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testThumbnailMatchesWindows();
+    void testRelayoutKeepsUnchangedLayout();
+};
+
+void MultitaskViewTest::initTestCase()
+{
+    qputenv("XDG_DATA_DIRS", QCoreApplication::applicationDirPath().toUtf8());
+
+    qRegisterMetaType<KWin::AbstractClient *>();
+    QSignalSpy applicationStartedSpy(kwinApp(), &Application::started);
+    QVERIFY(applicationStartedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName));
+    QMetaObject::invokeMethod(kwinApp()->platform(), "setVirtualOutputs", Qt::DirectConnection, Q_ARG(int, 1));
+
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    KConfigGroup plugins(config, QStringLiteral("Plugins"));
+    const auto builtinNames = EffectLoader().listOfKnownEffects();
+    for (const QString &name : builtinNames) {
+        plugins.writeEntry(name + QStringLiteral("Enabled"), false);
+    }
+    config->sync();
+    kwinApp()->setConfig(config);
+
+    qputenv("KWIN_COMPOSE", QByteArrayLiteral("O2"));
+
+    kwinApp()->start();
+    QVERIFY(applicationStartedSpy.wait());
+    Test::initWaylandWorkspace();
+
+    QVERIFY(Compositor::self());
+    QCOMPARE(Compositor::self()->backend()->compositingType(), KWin::OpenGLCompositing);
+}
+
+void MultitaskViewTest::init()
+{
+    QVERIFY(Test::setupWaylandConnection());
+    // keep the pointer away from the previews, hovering highlights them
+    Cursors::self()->mouse()->setPos(QPoint(1279, 1023));
+}
+
+void MultitaskViewTest::cleanup()
+{
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    QVERIFY(effectsImpl);
+    effectsImpl->unloadAllEffects();
+    QVERIFY(effectsImpl->loadedEffects().isEmpty());
+    qunsetenv("KWIN_MULTITASKVIEW_NO_THUMBNAILS");
+
+    Test::destroyWaylandConnection();
+}
+
+void MultitaskViewTest::testThumbnailMatchesWindows()
+{
+    // the workspace previews are painted from a cached thumbnail once the windows settled,
+    // that must look the same as painting the windows one by one
+    const QVector<QColor> colors{Qt::red, Qt::green, Qt::blue};
+    QVector<KWayland::Client::Surface *> surfaces;
+    QVector<Test::XdgToplevel *> shellSurfaces;
+    for (int i = 0; i < colors.count(); ++i) {
+        KWayland::Client::Surface *surface = Test::createSurface(this);
+        Test::XdgToplevel *shellSurface = Test::createXdgToplevelSurface(surface);
+        AbstractClient *client = Test::renderAndWaitForShown(surface, QSize(400, 300), colors.at(i));
+        QVERIFY(client);
+        client->move(QPoint(100 + i * 150, 100 + i * 100));
+        surfaces.append(surface);
+        shellSurfaces.append(shellSurface);
+    }
+    // the opacity of a window has to reach the thumbnail exactly once
+    workspace()->activeClient()->setOpacity(0.5);
+
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    QVERIFY(effectsImpl);
+
+    QImage frames[2];
+    for (int i = 0; i < 2; ++i) {
+        if (i == 1) {
+            qputenv("KWIN_MULTITASKVIEW_NO_THUMBNAILS", QByteArrayLiteral("1"));
+        }
+        QVERIFY(effectsImpl->loadEffect(s_effectName));
+        Effect *effect = effectsImpl->findEffect(s_effectName);
+        QVERIFY(effect);
+
+        QVERIFY(QMetaObject::invokeMethod(effect, "toggle"));
+        QTRY_VERIFY(effect->isActive());
+        // let the pop up and the windows in the previews settle
+        QTest::qWait(1000);
+        frames[i] = Test::renderAndGrabFrame();
+        QVERIFY(!frames[i].isNull());
+
+        QVERIFY(QMetaObject::invokeMethod(effect, "toggle"));
+        QTRY_VERIFY(!effect->isActive());
+        effectsImpl->unloadAllEffects();
+    }
+
+    QCOMPARE(frames[0].size(), frames[1].size());
+    for (int y = 0; y < frames[0].height(); ++y) {
+        for (int x = 0; x < frames[0].width(); ++x) {
+            const QColor thumbnail = frames[0].pixelColor(x, y);
+            const QColor direct = frames[1].pixelColor(x, y);
+            // blending into the thumbnail first may round differently
+            const bool same = qAbs(thumbnail.red() - direct.red()) <= 2
+                && qAbs(thumbnail.green() - direct.green()) <= 2
+                && qAbs(thumbnail.blue() - direct.blue()) <= 2;
+            QVERIFY2(same, qPrintable(QStringLiteral("pixel %1,%2: %3 != %4").arg(x).arg(y).arg(thumbnail.name(), direct.name())));
+        }
+    }
+
+    qDeleteAll(shellSurfaces);
+    qDeleteAll(surfaces);
+}
+
+void MultitaskViewTest::testRelayoutKeepsUnchangedLayout()
+{
+    // the windows of a screen are only laid out again if the screen or its windows changed
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    AbstractClient *client = Test::renderAndWaitForShown(surface.data(), QSize(400, 300), Qt::red);
+    QVERIFY(client);
+    QScopedPointer<KWayland::Client::Surface> otherSurface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> otherShellSurface(Test::createXdgToplevelSurface(otherSurface.data()));
+    AbstractClient *otherClient = Test::renderAndWaitForShown(otherSurface.data(), QSize(400, 300), Qt::green);
+    QVERIFY(otherClient);
+
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    QVERIFY(effectsImpl);
+    QVERIFY(effectsImpl->loadEffect(s_effectName));
+    Effect *effect = effectsImpl->findEffect(s_effectName);
+    QVERIFY(effect);
+    QVERIFY(QMetaObject::invokeMethod(effect, "toggle"));
+    QTRY_VERIFY(effect->isActive());
+    QTest::qWait(1000);
+
+    // a popup isn't shown in the multitask view, closing it leaves the layout as it is
+    QScopedPointer<Test::XdgPositioner> positioner(Test::createXdgPositioner());
+    positioner->set_size(50, 50);
+    positioner->set_anchor_rect(10, 10, 10, 10);
+    QScopedPointer<KWayland::Client::Surface> popupSurface(Test::createSurface());
+    QScopedPointer<Test::XdgPopup> popup(Test::createXdgPopupSurface(popupSurface.data(), shellSurface->xdgSurface(), positioner.data()));
+    AbstractClient *popupClient = Test::renderAndWaitForShown(popupSurface.data(), QSize(50, 50), Qt::blue);
+    QVERIFY(popupClient);
+
+    const int layoutCount = effect->property("layoutCount").toInt();
+    QVERIFY(layoutCount > 0);
+    QSignalSpy windowDeletedSpy(effects, &EffectsHandler::windowDeleted);
+    QVERIFY(windowDeletedSpy.isValid());
+    popup.reset();
+    popupSurface.reset();
+    QVERIFY(windowDeletedSpy.wait());
+    QCOMPARE(effect->property("layoutCount").toInt(), layoutCount);
+
+    // closing a window that is shown moves the others to new slots
+    otherShellSurface.reset();
+    otherSurface.reset();
+    QVERIFY(windowDeletedSpy.wait());
+    QVERIFY(effect->property("layoutCount").toInt() > layoutCount);
+
+    QVERIFY(QMetaObject::invokeMethod(effect, "toggle"));
+    QTRY_VERIFY(!effect->isActive());
+}
+
+WAYLANDTEST_MAIN(MultitaskViewTest)
+#include "multitaskview_test.moc"
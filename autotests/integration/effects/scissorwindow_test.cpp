@@ -0,0 +1,382 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "kwin_wayland_test.h"
+
+#include "abstract_client.h"
+#include "abstract_output.h"
+#include "composite.h"
+#include "effectloader.h"
+#include "effects.h"
+#include "performancemonitor.h"
+#include "platform.h"
+#include "renderbackend.h"
+#include "scene.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <KConfigGroup>
+
+#include <QPainterPath>
+
+#include <DWayland/Client/surface.h>
+
+Q_DECLARE_METATYPE(QPainterPath)
+
+using namespace KWin;
+
+static const QString s_socketName = QStringLiteral("wayland_test_effects_scissorwindow-0");
+static const QString s_effectName = QStringLiteral("scissor");
+// ScissorWindow::WindowRadiusRole
+static const int s_windowRadiusRole = KWin::DataRole::LanczosCacheRole + 101;
+// ScissorWindow::WindowClipPathRole
+static const int s_windowClipPathRole = KWin::DataRole::LanczosCacheRole + 102;
+
+class ScissorWindowTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testRoundedCorners_data();
+    void testRoundedCorners();
+    void testNineSliceMatchesRasterizedMask();
+    void testClipMaskAfterClose();
+    void testClipMaskAfterResize();
+    void testClipMaskEviction();
+    void benchmarkStackedWindows_data();
+    void benchmarkStackedWindows();
+};
+
+void ScissorWindowTest::initTestCase()
+{
+    qputenv("XDG_DATA_DIRS", QCoreApplication::applicationDirPath().toUtf8());
+
+    qRegisterMetaType<KWin::AbstractClient *>();
+    QSignalSpy applicationStartedSpy(kwinApp(), &Application::started);
+    QVERIFY(applicationStartedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName));
+    QMetaObject::invokeMethod(kwinApp()->platform(), "setVirtualOutputs", Qt::DirectConnection, Q_ARG(int, 1));
+
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    KConfigGroup plugins(config, QStringLiteral("Plugins"));
+    const auto builtinNames = EffectLoader().listOfKnownEffects();
+    for (const QString &name : builtinNames) {
+        plugins.writeEntry(name + QStringLiteral("Enabled"), false);
+    }
+    config->sync();
+    kwinApp()->setConfig(config);
+
+    qputenv("KWIN_COMPOSE", QByteArrayLiteral("O2"));
+
+    kwinApp()->start();
+    QVERIFY(applicationStartedSpy.wait());
+    Test::initWaylandWorkspace();
+
+    QVERIFY(Compositor::self());
+    QCOMPARE(Compositor::self()->backend()->compositingType(), KWin::OpenGLCompositing);
+}
+
+void ScissorWindowTest::init()
+{
+    QVERIFY(Test::setupWaylandConnection());
+
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    QVERIFY(effectsImpl);
+    QVERIFY(effectsImpl->loadEffect(s_effectName));
+}
+
+void ScissorWindowTest::cleanup()
+{
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    QVERIFY(effectsImpl);
+    effectsImpl->unloadAllEffects();
+    QVERIFY(effectsImpl->loadedEffects().isEmpty());
+
+    Test::destroyWaylandConnection();
+}
+
+void ScissorWindowTest::testRoundedCorners_data()
+{
+    QTest::addColumn<bool>("clipPath");
+
+    QTest::newRow("radius") << false;
+    QTest::newRow("clip path") << true;
+}
+
+void ScissorWindowTest::testRoundedCorners()
+{
+    // the corners of the window have to show what is beneath it, and only the corners
+    // must be taken out of the region the window hides
+    QFETCH(bool, clipPath);
+    const int radius = 16;
+
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    AbstractClient *client = Test::renderAndWaitForShown(surface.data(), QSize(200, 150), Qt::blue);
+    QVERIFY(client);
+    client->move(QPoint(100, 100));
+    const QRect geometry = client->frameGeometry();
+    if (clipPath) {
+        QPainterPath roundedRect;
+        roundedRect.addRoundedRect(QRectF(QPointF(0, 0), geometry.size()), radius, radius);
+        client->effectWindow()->setData(s_windowClipPathRole, QVariant::fromValue(roundedRect));
+    } else {
+        client->effectWindow()->setData(s_windowRadiusRole, QPointF(radius, radius));
+    }
+
+    const QImage image = Test::renderAndGrabFrame(geometry);
+    QVERIFY(!image.isNull());
+    const QRgb background = qRgb(0, 0, 0);
+    const QRgb blue = QColor(Qt::blue).rgb();
+    QCOMPARE(image.pixel(0, 0), background);
+    QCOMPARE(image.pixel(geometry.width() - 1, 0), background);
+    QCOMPARE(image.pixel(0, geometry.height() - 1), background);
+    QCOMPARE(image.pixel(geometry.width() - 1, geometry.height() - 1), background);
+    QCOMPARE(image.pixel(geometry.width() / 2, geometry.height() / 2), blue);
+    QCOMPARE(image.pixel(geometry.width() / 2, 0), blue);
+    QCOMPARE(image.pixel(0, geometry.height() / 2), blue);
+    QCOMPARE(image.pixel(geometry.width() - 1, geometry.height() / 2), blue);
+    QCOMPARE(image.pixel(geometry.width() / 2, geometry.height() - 1), blue);
+
+    WindowPrePaintData data;
+    data.mask = 0;
+    data.paint = geometry;
+    data.clip = geometry;
+    effects->prePaintWindow(client->effectWindow(), data, std::chrono::milliseconds::zero());
+    QCOMPARE(data.paint, QRegion(geometry));
+    if (clipPath) {
+        // a clip path can have any shape
+        QVERIFY(data.clip.isEmpty());
+    } else {
+        QRegion clip(geometry);
+        clip -= QRect(geometry.topLeft(), QSize(radius, radius));
+        clip -= QRect(geometry.right() - radius + 1, geometry.top(), radius, radius);
+        clip -= QRect(geometry.left(), geometry.bottom() - radius + 1, radius, radius);
+        clip -= QRect(geometry.right() - radius + 1, geometry.bottom() - radius + 1, radius, radius);
+        QCOMPARE(data.clip, clip);
+    }
+}
+
+/**
+ * Returns the path of a rounded rectangle that isn't recognized as one, so that it is
+ * rasterized as a whole instead of being drawn from a corner tile.
+ */
+static QPainterPath rasterizedRoundedRect(const QRectF &rect, qreal radius)
+{
+    QPainterPath path;
+    path.addRoundedRect(rect, radius, radius);
+    // an empty subpath doesn't change the shape
+    path.moveTo(rect.topLeft());
+    return path;
+}
+
+void ScissorWindowTest::testNineSliceMatchesRasterizedMask()
+{
+    // a rounded rectangle clip path is drawn from one corner tile stretched along the sides,
+    // that has to look like the whole path rasterized
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    Effect *effect = effectsImpl->findEffect(s_effectName);
+    QVERIFY(effect);
+
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    AbstractClient *client = Test::renderAndWaitForShown(surface.data(), QSize(200, 150), Qt::blue);
+    QVERIFY(client);
+    client->move(QPoint(100, 100));
+    const QRect geometry = client->frameGeometry();
+    const QRectF bounds(QPointF(0, 0), geometry.size());
+
+    QPainterPath roundedRect;
+    roundedRect.addRoundedRect(bounds, 16, 16);
+    client->effectWindow()->setData(s_windowClipPathRole, QVariant::fromValue(roundedRect));
+    const int clipMaskCount = effect->property("clipMaskCount").toInt();
+    const QImage nineSlice = Test::renderAndGrabFrame(geometry);
+    QVERIFY(!nineSlice.isNull());
+    QCOMPARE(effect->property("clipMaskCount").toInt(), clipMaskCount);
+
+    client->effectWindow()->setData(s_windowClipPathRole, QVariant::fromValue(rasterizedRoundedRect(bounds, 16)));
+    const QImage rasterized = Test::renderAndGrabFrame(geometry);
+    QVERIFY(!rasterized.isNull());
+    QCOMPARE(effect->property("clipMaskCount").toInt(), clipMaskCount + 1);
+
+    for (int y = 0; y < geometry.height(); ++y) {
+        for (int x = 0; x < geometry.width(); ++x) {
+            const QColor expected = rasterized.pixelColor(x, y);
+            const QColor actual = nineSlice.pixelColor(x, y);
+            // both masks are sampled with linear filtering, just at different places
+            const bool same = qAbs(expected.red() - actual.red()) <= 8
+                && qAbs(expected.green() - actual.green()) <= 8
+                && qAbs(expected.blue() - actual.blue()) <= 8;
+            QVERIFY2(same, qPrintable(QStringLiteral("pixel %1,%2: %3 != %4").arg(x).arg(y).arg(actual.name(), expected.name())));
+        }
+    }
+}
+
+void ScissorWindowTest::testClipMaskAfterClose()
+{
+    // a window that changes its clip path gets the new mask rasterized in the background,
+    // the window may be gone by the time it is done
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    Effect *effect = effectsImpl->findEffect(s_effectName);
+    QVERIFY(effect);
+
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    // a large mask keeps the job busy for a while
+    AbstractClient *client = Test::renderAndWaitForShown(surface.data(), QSize(1000, 800), Qt::blue);
+    QVERIFY(client);
+    client->move(QPoint(0, 0));
+
+    QPainterPath ellipse;
+    ellipse.addEllipse(QRectF(0, 0, 1000, 800));
+    client->effectWindow()->setData(s_windowClipPathRole, QVariant::fromValue(ellipse));
+    QVERIFY(!Test::renderAndGrabFrame().isNull());
+    const int clipMaskCount = effect->property("clipMaskCount").toInt();
+
+    QPainterPath smallerEllipse;
+    smallerEllipse.addEllipse(QRectF(100, 100, 800, 600));
+    client->effectWindow()->setData(s_windowClipPathRole, QVariant::fromValue(smallerEllipse));
+    QVERIFY(!Test::renderAndGrabFrame().isNull());
+
+    shellSurface.reset();
+    surface.reset();
+    QVERIFY(Test::waitForWindowDestroyed(client));
+
+    QTRY_COMPARE(effect->property("clipMaskCount").toInt(), clipMaskCount + 1);
+    QVERIFY(!Test::renderAndGrabFrame().isNull());
+}
+
+void ScissorWindowTest::testClipMaskAfterResize()
+{
+    // the mask of a resized window is rasterized in the background while the previous one is
+    // shown, resizing again meanwhile must end up with the mask of the last size
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    AbstractClient *client = Test::renderAndWaitForShown(surface.data(), QSize(200, 150), Qt::blue);
+    QVERIFY(client);
+    client->move(QPoint(100, 100));
+
+    // the path doesn't grow with the window, the rest of it is cut off
+    client->effectWindow()->setData(s_windowClipPathRole, QVariant::fromValue(rasterizedRoundedRect(QRectF(0, 0, 200, 150), 16)));
+    QVERIFY(!Test::renderAndGrabFrame().isNull());
+
+    QSignalSpy frameGeometryChangedSpy(client, &AbstractClient::frameGeometryChanged);
+    QVERIFY(frameGeometryChangedSpy.isValid());
+    Test::render(surface.data(), QSize(300, 200), Qt::blue);
+    QVERIFY(frameGeometryChangedSpy.wait());
+    QVERIFY(!Test::renderAndGrabFrame().isNull());
+    Test::render(surface.data(), QSize(400, 300), Qt::blue);
+    QVERIFY(frameGeometryChangedSpy.wait());
+    QCOMPARE(client->frameGeometry(), QRect(100, 100, 400, 300));
+
+    const QRgb background = qRgb(0, 0, 0);
+    const QRgb blue = QColor(Qt::blue).rgb();
+    QTRY_COMPARE(Test::renderAndGrabFrame(QRect(100 + 350, 100 + 250, 1, 1)).pixel(0, 0), background);
+    QCOMPARE(Test::renderAndGrabFrame(QRect(100 + 250, 100 + 100, 1, 1)).pixel(0, 0), background);
+    QCOMPARE(Test::renderAndGrabFrame(QRect(100 + 100, 100 + 75, 1, 1)).pixel(0, 0), blue);
+}
+
+void ScissorWindowTest::testClipMaskEviction()
+{
+    // the rasterized clip paths are shared by all windows and must not take more than 64 MiB
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    Effect *effect = effectsImpl->findEffect(s_effectName);
+    QVERIFY(effect);
+    const qint64 budget = 64 * 1024 * 1024;
+    // masks are rasterized at twice the size with four bytes per pixel
+    const qint64 maskBytes = qint64(1000) * 800 * 4 * 4;
+
+    QVector<KWayland::Client::Surface *> surfaces;
+    QVector<Test::XdgToplevel *> shellSurfaces;
+    const int windowCount = 6;
+    for (int i = 0; i < windowCount; ++i) {
+        KWayland::Client::Surface *surface = Test::createSurface(this);
+        Test::XdgToplevel *shellSurface = Test::createXdgToplevelSurface(surface);
+        AbstractClient *client = Test::renderAndWaitForShown(surface, QSize(1000, 800), Qt::blue);
+        QVERIFY(client);
+        client->move(QPoint(20 * i, 20 * i));
+        // a mask of its own for every window, the first one is rasterized right away
+        QPainterPath ellipse;
+        ellipse.addEllipse(QRectF(i, i, 1000 - 2 * i, 800 - 2 * i));
+        client->effectWindow()->setData(s_windowClipPathRole, QVariant::fromValue(ellipse));
+        QVERIFY(!Test::renderAndGrabFrame().isNull());
+        surfaces.append(surface);
+        shellSurfaces.append(shellSurface);
+    }
+
+    QVERIFY(effect->property("clipMaskBytes").toLongLong() <= budget);
+    QCOMPARE(effect->property("clipMaskCount").toInt(), int(budget / maskBytes));
+    QCOMPARE(effect->property("clipMaskBytes").toLongLong(), maskBytes * (budget / maskBytes));
+
+    qDeleteAll(shellSurfaces);
+    qDeleteAll(surfaces);
+}
+
+void ScissorWindowTest::benchmarkStackedWindows_data()
+{
+    QTest::addColumn<int>("windowCount");
+    QTest::addColumn<bool>("clipPath");
+
+    QTest::newRow("10") << 10 << false;
+    QTest::newRow("50") << 50 << false;
+    QTest::newRow("10 clip path") << 10 << true;
+    QTest::newRow("50 clip path") << 50 << true;
+}
+
+void ScissorWindowTest::benchmarkStackedWindows()
+{
+    // the average time it takes to render a frame of cascaded windows with rounded corners,
+    // run it with LIBGL_ALWAYS_SOFTWARE=1 to compare the results on llvmpipe
+    QFETCH(int, windowCount);
+    QFETCH(bool, clipPath);
+
+    QPainterPath roundedRect;
+    roundedRect.addRoundedRect(QRectF(0, 0, 600, 400), 8, 8);
+
+    QVector<KWayland::Client::Surface *> surfaces;
+    QVector<Test::XdgToplevel *> shellSurfaces;
+    for (int i = 0; i < windowCount; ++i) {
+        KWayland::Client::Surface *surface = Test::createSurface(this);
+        Test::XdgToplevel *shellSurface = Test::createXdgToplevelSurface(surface);
+        AbstractClient *client = Test::renderAndWaitForShown(surface, QSize(600, 400), Qt::blue);
+        QVERIFY(client);
+        client->move(QPoint(20 + (i % 20) * 30, 20 + (i % 20) * 25));
+        if (clipPath) {
+            client->effectWindow()->setData(s_windowClipPathRole, QVariant::fromValue(roundedRect));
+        } else {
+            client->effectWindow()->setData(s_windowRadiusRole, QPointF(8, 8));
+        }
+        surfaces.append(surface);
+        shellSurfaces.append(shellSurface);
+    }
+
+    Scene *scene = Compositor::self()->scene();
+    QSignalSpy frameRenderedSpy(scene, &Scene::frameRendered);
+    QVERIFY(frameRenderedSpy.isValid());
+
+    const AbstractOutput *output = kwinApp()->platform()->enabledOutputs().constFirst();
+    FrameStatistics *statistics = PerformanceMonitor::self()->frameStatistics(output->name());
+    statistics->snapshot(true);
+
+    const int frameCount = 60;
+    for (int i = 0; i < frameCount; ++i) {
+        scene->addRepaintFull();
+        QVERIFY(frameRenderedSpy.wait());
+    }
+
+    const QVariantMap renderTime = statistics->snapshot(true).value(QStringLiteral("renderTime")).toMap();
+    const quint64 count = renderTime.value(QStringLiteral("count")).toULongLong();
+    QVERIFY(count > 0);
+    QTest::setBenchmarkResult(renderTime.value(QStringLiteral("sum")).toULongLong() / qreal(count), QTest::WalltimeNanoseconds);
+
+    qDeleteAll(shellSurfaces);
+    qDeleteAll(surfaces);
+}
+
+WAYLANDTEST_MAIN(ScissorWindowTest)
+#include "scissorwindow_test.moc"
@@ -38,6 +38,7 @@ private Q_SLOTS:
     void testAnimateToplevels();
     void testDontAnimatePopups_data();
     void testDontAnimatePopups();
+    void testRetainedSnapshot();
 };
 
 void ToplevelOpenCloseAnimationTest::initTestCase()
@@ -204,5 +205,42 @@ void ToplevelOpenCloseAnimationTest::testDontAnimatePopups()
     QVERIFY(Test::waitForWindowDestroyed(mainWindow));
 }
 
+void ToplevelOpenCloseAnimationTest::testRetainedSnapshot()
+{
+    // This test verifies that the contents of a closed window are accounted for
+    // while the close animation runs, and released afterwards.
+
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    QVERIFY(effectsImpl);
+    QVERIFY(effectsImpl->loadEffect(QStringLiteral("glide")));
+    Effect *effect = effectsImpl->findEffect(QStringLiteral("glide"));
+    QVERIFY(effect);
+
+    const quint64 retainedCount = Deleted::retainedSnapshotCount();
+    const quint64 retainedBytes = Deleted::retainedSnapshotBytes();
+
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    AbstractClient *client = Test::renderAndWaitForShown(surface.data(), QSize(100, 50), Qt::blue);
+    QVERIFY(client);
+    QTRY_VERIFY(!effect->isActive());
+
+    QSignalSpy windowClosedSpy(client, &AbstractClient::windowClosed);
+    shellSurface.reset();
+    surface.reset();
+    QVERIFY(windowClosedSpy.wait());
+    QVERIFY(effect->isActive());
+
+    Deleted *deleted = windowClosedSpy.first().at(1).value<Deleted *>();
+    QVERIFY(deleted);
+    QCOMPARE(deleted->retainedBytes(), quint64(100 * 50 * 4));
+    QCOMPARE(Deleted::retainedSnapshotCount(), retainedCount + 1);
+    QCOMPARE(Deleted::retainedSnapshotBytes(), retainedBytes + deleted->retainedBytes());
+
+    QTRY_VERIFY(!effect->isActive());
+    QTRY_COMPARE(Deleted::retainedSnapshotCount(), retainedCount);
+    QCOMPARE(Deleted::retainedSnapshotBytes(), retainedBytes);
+}
+
 WAYLANDTEST_MAIN(ToplevelOpenCloseAnimationTest)
 #include "toplevel_open_close_animation_test.moc"
@@ -11,6 +11,7 @@
 #include "composite.h"
 #include "effectloader.h"
 #include "cursor.h"
+#include "performancemonitor.h"
 #include "platform.h"
 #include "renderbackend.h"
 #include "scene.h"
@@ -18,6 +19,8 @@
 
 #include <KConfigGroup>
 
+#include <DWayland/Client/surface.h>
+
 using namespace KWin;
 static const QString s_socketName = QStringLiteral("wayland_test_kwin_scene_opengl-0");
 
@@ -86,3 +89,38 @@ void GenericSceneOpenGLTest::testRestart()
     // TODO: introduce frameRendered signal in SceneOpenGL
     QTest::qWait(100);
 }
+
+void GenericSceneOpenGLTest::testRenderNodeCacheAcrossDamage()
+{
+    // painting a window again with a different clip must not walk its item tree again
+    QVERIFY(Test::setupWaylandConnection());
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    AbstractClient *client = Test::renderAndWaitForShown(surface.data(), QSize(400, 300), Qt::blue);
+    QVERIFY(client);
+
+    Scene *scene = Compositor::self()->scene();
+    QSignalSpy frameRenderedSpy(scene, &Scene::frameRendered);
+    QVERIFY(frameRenderedSpy.isValid());
+    scene->addRepaintFull();
+    QVERIFY(frameRenderedSpy.wait());
+
+    PerformanceMonitor::self()->reset();
+    const QRect geometry = client->frameGeometry();
+    const QVector<QRect> damage = {
+        QRect(geometry.topLeft() + QPoint(10, 10), QSize(20, 20)),
+        QRect(geometry.topLeft() + QPoint(200, 100), QSize(50, 10)),
+        QRect(geometry.topLeft() + QPoint(0, 250), QSize(400, 50)),
+    };
+    for (const QRect &rect : damage) {
+        scene->addRepaint(rect);
+        QVERIFY(frameRenderedSpy.wait());
+    }
+
+    const QVariantMap statistics = PerformanceMonitor::self()->snapshot().value(QStringLiteral("renderNodeCache")).toMap();
+    QCOMPARE(statistics.value(QStringLiteral("rebuilt")).toULongLong(), quint64(0));
+    QVERIFY(statistics.value(QStringLiteral("reused")).toULongLong() >= quint64(damage.count()));
+
+    shellSurface.reset();
+    QVERIFY(Test::waitForWindowDestroyed(client));
+}
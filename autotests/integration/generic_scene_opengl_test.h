@@ -22,6 +22,7 @@ private Q_SLOTS:
     void initTestCase();
     void cleanup();
     void testRestart();
+    void testRenderNodeCacheAcrossDamage();
 
 private:
     QByteArray m_envVariable;
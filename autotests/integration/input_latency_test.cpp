@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "kwin_wayland_test.h"
+#include "abstract_client.h"
+#include "abstract_output.h"
+#include "composite.h"
+#include "cursor.h"
+#include "input.h"
+#include "inputdevice.h"
+#include "performancemonitor.h"
+#include "platform.h"
+#include "renderloop.h"
+#include "wayland_server.h"
+#include "workspace.h"
+
+#include <DWayland/Client/fakeinput.h>
+#include <DWayland/Client/keyboard.h>
+#include <DWayland/Client/pointer.h>
+#include <DWayland/Client/registry.h>
+#include <DWayland/Client/seat.h>
+#include <DWayland/Client/surface.h>
+
+#include <linux/input.h>
+
+using namespace KWin;
+using namespace KWayland::Client;
+
+static const QString s_socketName = QStringLiteral("wayland_test_kwin_input_latency-0");
+
+class InputLatencyTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testKeyboard();
+    void testPointerMotion();
+    void testNoReaction();
+
+private:
+    quint64 latencySamples() const;
+
+    Registry *m_registry = nullptr;
+    FakeInput *m_fakeInput = nullptr;
+    QString m_deviceName;
+};
+
+void InputLatencyTest::initTestCase()
+{
+    qRegisterMetaType<KWin::AbstractClient *>();
+    qRegisterMetaType<KWin::InputDevice *>();
+
+    QSignalSpy applicationStartedSpy(kwinApp(), &Application::started);
+    QVERIFY(applicationStartedSpy.isValid());
+    kwinApp()->platform()->setInitialWindowSize(QSize(1280, 1024));
+    QVERIFY(waylandServer()->init(s_socketName));
+    QMetaObject::invokeMethod(kwinApp()->platform(), "setVirtualOutputs", Qt::DirectConnection, Q_ARG(int, 1));
+
+    kwinApp()->start();
+    QVERIFY(applicationStartedSpy.wait());
+    Test::initWaylandWorkspace();
+    QVERIFY(PerformanceMonitor::self());
+}
+
+void InputLatencyTest::init()
+{
+    QVERIFY(Test::setupWaylandConnection(Test::AdditionalWaylandInterface::Seat));
+    QVERIFY(Test::waitForWaylandPointer());
+    QVERIFY(Test::waitForWaylandKeyboard());
+
+    m_registry = new Registry(this);
+    QSignalSpy interfacesAnnouncedSpy(m_registry, &Registry::interfacesAnnounced);
+    m_registry->create(Test::waylandConnection());
+    m_registry->setup();
+    QVERIFY(interfacesAnnouncedSpy.wait());
+
+    QSignalSpy deviceAddedSpy(input(), &InputRedirection::deviceAdded);
+    const auto fakeInputData = m_registry->interface(Registry::Interface::FakeInput);
+    m_fakeInput = m_registry->createFakeInput(fakeInputData.name, fakeInputData.version, this);
+    QVERIFY(m_fakeInput->isValid());
+    m_fakeInput->authenticate(QStringLiteral("test"), QStringLiteral("input latency"));
+    QVERIFY(deviceAddedSpy.wait());
+    m_deviceName = deviceAddedSpy.last().first().value<InputDevice *>()->name();
+
+    workspace()->setActiveOutput(QPoint(640, 512));
+    Cursors::self()->mouse()->setPos(QPoint(640, 512));
+    PerformanceMonitor::self()->reset();
+}
+
+void InputLatencyTest::cleanup()
+{
+    delete m_fakeInput;
+    m_fakeInput = nullptr;
+    delete m_registry;
+    m_registry = nullptr;
+    Test::destroyWaylandConnection();
+}
+
+quint64 InputLatencyTest::latencySamples() const
+{
+    const QVariantMap latency = PerformanceMonitor::self()->snapshot().value(QStringLiteral("inputLatency")).toMap();
+    return latency.value(m_deviceName).toMap().value(QStringLiteral("count")).toULongLong();
+}
+
+void InputLatencyTest::testKeyboard()
+{
+    // a key press is measured once the focused client has committed in reaction to it
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    AbstractClient *client = Test::renderAndWaitForShown(surface.data(), QSize(100, 50), Qt::blue);
+    QVERIFY(client);
+    QVERIFY(client->isActive());
+
+    QScopedPointer<Keyboard> keyboard(Test::waylandSeat()->createKeyboard());
+    QSignalSpy enteredSpy(keyboard.data(), &Keyboard::entered);
+    QVERIFY(enteredSpy.wait());
+    QSignalSpy keyChangedSpy(keyboard.data(), &Keyboard::keyChanged);
+
+    m_fakeInput->requestKeyboardKeyPress(KEY_A);
+    QVERIFY(keyChangedSpy.wait());
+    QCOMPARE(latencySamples(), quint64(0));
+
+    QSignalSpy framePresentedSpy(kwinApp()->platform()->enabledOutputs().first()->renderLoop(), &RenderLoop::framePresented);
+    Test::render(surface.data(), QSize(100, 50), Qt::red);
+    QVERIFY(framePresentedSpy.wait());
+    QTRY_COMPARE(latencySamples(), quint64(1));
+
+    m_fakeInput->requestKeyboardKeyRelease(KEY_A);
+    QVERIFY(keyChangedSpy.wait());
+}
+
+void InputLatencyTest::testPointerMotion()
+{
+    // pointer motion over a client is measured through the client's commit as well
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    AbstractClient *client = Test::renderAndWaitForShown(surface.data(), QSize(400, 300), Qt::blue);
+    QVERIFY(client);
+    client->move(QPoint(440, 362));
+
+    QScopedPointer<Pointer> pointer(Test::waylandSeat()->createPointer());
+    QSignalSpy motionSpy(pointer.data(), &Pointer::motion);
+    m_fakeInput->requestPointerMove(QSizeF(10, 10));
+    QVERIFY(motionSpy.wait());
+
+    Test::render(surface.data(), QSize(400, 300), Qt::red);
+    QTRY_COMPARE(latencySamples(), quint64(1));
+}
+
+void InputLatencyTest::testNoReaction()
+{
+    // events that nobody reacts to are not measured
+    QScopedPointer<KWayland::Client::Surface> surface(Test::createSurface());
+    QScopedPointer<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.data()));
+    QVERIFY(Test::renderAndWaitForShown(surface.data(), QSize(100, 50), Qt::blue));
+
+    QScopedPointer<Keyboard> keyboard(Test::waylandSeat()->createKeyboard());
+    QSignalSpy enteredSpy(keyboard.data(), &Keyboard::entered);
+    QVERIFY(enteredSpy.wait());
+    QSignalSpy keyChangedSpy(keyboard.data(), &Keyboard::keyChanged);
+    m_fakeInput->requestKeyboardKeyPress(KEY_B);
+    QVERIFY(keyChangedSpy.wait());
+    m_fakeInput->requestKeyboardKeyRelease(KEY_B);
+    QVERIFY(keyChangedSpy.wait());
+
+    // force an unrelated frame
+    QSignalSpy framePresentedSpy(kwinApp()->platform()->enabledOutputs().first()->renderLoop(), &RenderLoop::framePresented);
+    Compositor::self()->scheduleRepaint();
+    QVERIFY(framePresentedSpy.wait());
+    QCOMPARE(latencySamples(), quint64(0));
+}
+
+WAYLANDTEST_MAIN(InputLatencyTest)
+#include "input_latency_test.moc"
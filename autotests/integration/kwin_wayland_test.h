@@ -562,6 +562,13 @@ AbstractClient *renderAndWaitForShown(KWayland::Client::Surface *surface, const
  */
 bool waitForWindowDestroyed(AbstractClient *client);
 
+/**
+ * Repaints the whole scene and reads back @p rect of the rendered frame, the whole
+ * screen if @p rect is invalid. Only works with the OpenGL compositor.
+ * Returns a null image if no frame got rendered.
+ */
+QImage renderAndGrabFrame(const QRect &rect = QRect());
+
 /**
  * Locks the screen and waits till the screen is locked.
  * @returns @c true if the screen could be locked, @c false otherwise
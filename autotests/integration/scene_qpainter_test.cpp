@@ -7,11 +7,13 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "kwin_wayland_test.h"
+#include "abstract_output.h"
 #include "composite.h"
 #include "effectloader.h"
 #include "x11client.h"
 #include "cursor.h"
 #include "effects.h"
+#include "performancemonitor.h"
 #include "platform.h"
 #include "wayland_server.h"
 #include "workspace.h"
@@ -40,6 +42,8 @@ private Q_SLOTS:
     void cleanup();
     void testStartFrame();
     void testCursorMoving();
+    void testCursorOnlyFrame();
+    void testCursorOnlyFrameWithActiveEffect();
     void testWindow();
     void testWindowScaled();
     void testCompositorRestart();
@@ -139,6 +143,70 @@ void SceneQPainterTest::testCursorMoving()
     QCOMPARE(referenceImage, *scene->qpainterRenderBuffer(outputs.constFirst()));
 }
 
+void SceneQPainterTest::testCursorOnlyFrame()
+{
+    // this test verifies that moving the cursor alone only repaints the cursor
+    auto scene = Compositor::self()->scene();
+    QVERIFY(scene);
+    QSignalSpy frameRenderedSpy(scene, &Scene::frameRendered);
+    QVERIFY(frameRenderedSpy.isValid());
+    scene->addRepaintFull();
+    QVERIFY(frameRenderedSpy.wait());
+
+    const auto outputs = kwinApp()->platform()->enabledOutputs();
+    FrameStatistics *statistics = PerformanceMonitor::self()->frameStatistics(outputs.constFirst()->name());
+    const quint64 cursorOnlyFrames = statistics->cursorOnlyFrames;
+
+    KWin::Cursors::self()->mouse()->setPos(100, 100);
+    QVERIFY(frameRenderedSpy.wait());
+    KWin::Cursors::self()->mouse()->setPos(105, 110);
+    QVERIFY(frameRenderedSpy.wait());
+    QVERIFY(statistics->cursorOnlyFrames > cursorOnlyFrames);
+
+    // the old cursor position has been restored from the last frame
+    QImage referenceImage(QSize(1280, 1024), QImage::Format_RGB32);
+    referenceImage.fill(Qt::black);
+    QPainter p(&referenceImage);
+
+    auto cursor = Cursors::self()->currentCursor();
+    const QImage cursorImage = cursor->image();
+    QVERIFY(!cursorImage.isNull());
+    p.drawImage(QPoint(105, 110) - cursor->hotspot(), cursorImage);
+    QCOMPARE(referenceImage, *scene->qpainterRenderBuffer(outputs.constFirst()));
+}
+
+void SceneQPainterTest::testCursorOnlyFrameWithActiveEffect()
+{
+    // this test verifies that an active effect gets to paint every frame the cursor moves in
+    auto scene = Compositor::self()->scene();
+    QVERIFY(scene);
+    auto effectsImpl = qobject_cast<EffectsHandlerImpl *>(effects);
+    QVERIFY(effectsImpl);
+    QVERIFY(effectsImpl->loadEffect(QStringLiteral("showpaint")));
+    Effect *effect = effectsImpl->findEffect(QStringLiteral("showpaint"));
+    QVERIFY(effect);
+    QVERIFY(QMetaObject::invokeMethod(effect, "toggle"));
+    QVERIFY(effect->isActive());
+
+    QSignalSpy frameRenderedSpy(scene, &Scene::frameRendered);
+    QVERIFY(frameRenderedSpy.isValid());
+    scene->addRepaintFull();
+    QVERIFY(frameRenderedSpy.wait());
+
+    const auto outputs = kwinApp()->platform()->enabledOutputs();
+    FrameStatistics *statistics = PerformanceMonitor::self()->frameStatistics(outputs.constFirst()->name());
+    const quint64 cursorOnlyFrames = statistics->cursorOnlyFrames;
+
+    KWin::Cursors::self()->mouse()->setPos(200, 200);
+    QVERIFY(frameRenderedSpy.wait());
+    KWin::Cursors::self()->mouse()->setPos(205, 210);
+    QVERIFY(frameRenderedSpy.wait());
+    QCOMPARE(quint64(statistics->cursorOnlyFrames), cursorOnlyFrames);
+
+    effectsImpl->unloadAllEffects();
+    QVERIFY(effectsImpl->loadedEffects().isEmpty());
+}
+
 void SceneQPainterTest::testWindow()
 {
     KWin::Cursors::self()->mouse()->setPos(45, 45);
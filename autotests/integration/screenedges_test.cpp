@@ -20,6 +20,8 @@
 #include "workspace.h"
 
 #include <KConfigGroup>
+
+#include <QMouseEvent>
 #include <DWayland/Client/surface.h>
 
 Q_DECLARE_METATYPE(KWin::ElectricBorder)
@@ -60,6 +62,9 @@ private Q_SLOTS:
     void testClientEdge();
     void testObjectEdge_data();
     void testObjectEdge();
+    void testStopApproaching();
+    void benchmarkPointerMotion_data();
+    void benchmarkPointerMotion();
 };
 
 void ScreenEdgesTest::initTestCase()
@@ -343,6 +348,67 @@ void ScreenEdgesTest::testObjectEdge()
     QCOMPARE(spy.count(), 2);
 }
 
+void ScreenEdgesTest::testStopApproaching()
+{
+    // This test verifies that an edge stops approaching once the pointer moves away from all edges.
+
+    TestObject callback;
+    ScreenEdges::self()->reserve(ElectricLeft, &callback, "callback");
+    QSignalSpy approachingSpy(ScreenEdges::self(), &ScreenEdges::approaching);
+
+    qint64 timestamp = 0;
+    kwinApp()->platform()->pointerMotion(QPointF(1, 512), timestamp++);
+    QCOMPARE(approachingSpy.count(), 1);
+
+    kwinApp()->platform()->pointerMotion(QPointF(640, 512), timestamp++);
+    QCOMPARE(approachingSpy.count(), 2);
+
+    // far away from the edges nothing happens anymore
+    kwinApp()->platform()->pointerMotion(QPointF(600, 400), timestamp++);
+    QCOMPARE(approachingSpy.count(), 2);
+
+    ScreenEdges::self()->unreserve(ElectricLeft, &callback);
+}
+
+void ScreenEdgesTest::benchmarkPointerMotion_data()
+{
+    QTest::addColumn<QRect>("area");
+
+    QTest::newRow("center") << QRect(200, 200, 880, 624);
+    QTest::newRow("everywhere") << QRect(0, 0, 1280, 1024);
+}
+
+void ScreenEdgesTest::benchmarkPointerMotion()
+{
+    // the time it takes to run synthetic pointer motion through the screen edges
+    // with all borders reserved
+    TestObject callback;
+    const QVector<ElectricBorder> borders{ElectricTop, ElectricTopRight, ElectricRight, ElectricBottomRight,
+                                          ElectricBottom, ElectricBottomLeft, ElectricLeft, ElectricTopLeft};
+    for (ElectricBorder border : borders) {
+        ScreenEdges::self()->reserve(border, &callback, "callback");
+    }
+
+    QFETCH(QRect, area);
+    QVector<QPoint> positions;
+    for (int i = 0; i < 1000; ++i) {
+        positions.append(QPoint(area.x() + (i * 37) % area.width(), area.y() + (i * 53) % area.height()));
+    }
+
+    ulong timestamp = 0;
+    QBENCHMARK {
+        for (const QPoint &pos : qAsConst(positions)) {
+            QMouseEvent event(QEvent::MouseMove, pos, pos, Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+            event.setTimestamp(timestamp++);
+            ScreenEdges::self()->isEntered(&event);
+        }
+    }
+
+    for (ElectricBorder border : borders) {
+        ScreenEdges::self()->unreserve(border, &callback);
+    }
+}
+
 } // namespace KWin
 
 WAYLANDTEST_MAIN(KWin::ScreenEdgesTest)
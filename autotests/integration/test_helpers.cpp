@@ -7,11 +7,16 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "kwin_wayland_test.h"
+#include "composite.h"
+#include "scene.h"
 #include "screenlockerwatcher.h"
+#include "screens.h"
 #include "wayland_server.h"
 #include "workspace.h"
 #include "inputmethod.h"
 
+#include <deepin_kwinglutils.h>
+
 #include <DWayland/Client/compositor.h>
 #include <DWayland/Client/connection_thread.h>
 #include <DWayland/Client/event_queue.h>
@@ -893,6 +898,26 @@ bool waitForWindowDestroyed(AbstractClient *client)
     return destroyedSpy.wait();
 }
 
+QImage renderAndGrabFrame(const QRect &rect)
+{
+    Scene *scene = Compositor::self()->scene();
+    const QRect area = rect.isValid() ? rect : screens()->geometry();
+    QImage image;
+    // the frame is still bound when the scene announces it, read it back before the swap
+    const QMetaObject::Connection connection = QObject::connect(scene, &Scene::frameRendered, [&image, area]() {
+        const int framebufferHeight = screens()->size().height();
+        QImage frame(area.size(), QImage::Format_RGBA8888);
+        glReadnPixels(area.x(), framebufferHeight - area.y() - area.height(), area.width(), area.height(),
+                      GL_RGBA, GL_UNSIGNED_BYTE, frame.sizeInBytes(), static_cast<GLvoid *>(frame.bits()));
+        image = frame.mirrored().convertToFormat(QImage::Format_RGB32);
+    });
+    QSignalSpy frameRenderedSpy(scene, &Scene::frameRendered);
+    scene->addRepaintFull();
+    frameRenderedSpy.wait();
+    QObject::disconnect(connection);
+    return image;
+}
+
 bool lockScreen()
 {
     if (waylandServer()->isScreenLocked()) {
@@ -51,6 +51,8 @@ private Q_SLOTS:
     void testFullscreenWindowGroups();
     void testActivateFocusedWindow();
     void testReentrantMoveResize();
+    void testFindClientByWindowId();
+    void benchmarkFindClient();
 };
 
 void X11ClientTest::initTestCase()
@@ -1099,5 +1101,101 @@ void X11ClientTest::testReentrantMoveResize()
     QVERIFY(Test::waitForWindowDestroyed(client));
 }
 
+void X11ClientTest::testFindClientByWindowId()
+{
+    // this test verifies that all windows of a client can be looked up by their id
+    QScopedPointer<xcb_connection_t, XcbConnectionDeleter> c(xcb_connect(nullptr, nullptr));
+    QVERIFY(!xcb_connection_has_error(c.data()));
+    const QRect windowGeometry(0, 0, 100, 200);
+    xcb_window_t w = xcb_generate_id(c.data());
+    xcb_create_window(c.data(), XCB_COPY_FROM_PARENT, w, rootWindow(),
+                      windowGeometry.x(),
+                      windowGeometry.y(),
+                      windowGeometry.width(),
+                      windowGeometry.height(),
+                      0, XCB_WINDOW_CLASS_INPUT_OUTPUT, XCB_COPY_FROM_PARENT, 0, nullptr);
+    xcb_size_hints_t hints;
+    memset(&hints, 0, sizeof(hints));
+    xcb_icccm_size_hints_set_position(&hints, 1, windowGeometry.x(), windowGeometry.y());
+    xcb_icccm_size_hints_set_size(&hints, 1, windowGeometry.width(), windowGeometry.height());
+    xcb_icccm_set_wm_normal_hints(c.data(), w, &hints);
+    xcb_map_window(c.data(), w);
+    xcb_flush(c.data());
+
+    QSignalSpy windowCreatedSpy(workspace(), &Workspace::clientAdded);
+    QVERIFY(windowCreatedSpy.isValid());
+    QVERIFY(windowCreatedSpy.wait());
+    X11Client *client = windowCreatedSpy.first().first().value<X11Client *>();
+    QVERIFY(client);
+    QCOMPARE(client->window(), w);
+
+    QCOMPARE(workspace()->findClient(Predicate::WindowMatch, client->window()), client);
+    QCOMPARE(workspace()->findClient(Predicate::WrapperIdMatch, client->wrapperId()), client);
+    QCOMPARE(workspace()->findClient(Predicate::FrameIdMatch, client->frameId()), client);
+    QCOMPARE(workspace()->findClientOwningWindow(client->window()), client);
+    QCOMPARE(workspace()->findClientOwningWindow(client->wrapperId()), client);
+    QCOMPARE(workspace()->findClientOwningWindow(client->frameId()), client);
+    if (client->inputId() != XCB_WINDOW_NONE) {
+        QCOMPARE(workspace()->findClient(Predicate::InputIdMatch, client->inputId()), client);
+        QCOMPARE(workspace()->findClientOwningWindow(client->inputId()), client);
+    }
+    // the predicate has to match the kind of window
+    QVERIFY(!workspace()->findClient(Predicate::FrameIdMatch, client->window()));
+    QVERIFY(!workspace()->findClient(Predicate::WindowMatch, client->frameId()));
+    QVERIFY(!workspace()->findUnmanaged(client->window()));
+
+    const xcb_window_t frame = client->frameId();
+    const xcb_window_t wrapper = client->wrapperId();
+
+    // and destroy the window again
+    xcb_unmap_window(c.data(), w);
+    xcb_flush(c.data());
+    QSignalSpy windowClosedSpy(client, &X11Client::windowClosed);
+    QVERIFY(windowClosedSpy.isValid());
+    QVERIFY(windowClosedSpy.wait());
+
+    QVERIFY(!workspace()->findClient(Predicate::WindowMatch, w));
+    QVERIFY(!workspace()->findClientOwningWindow(w));
+    QVERIFY(!workspace()->findClientOwningWindow(wrapper));
+    QVERIFY(!workspace()->findClientOwningWindow(frame));
+    xcb_destroy_window(c.data(), w);
+    c.reset();
+}
+
+void X11ClientTest::benchmarkFindClient()
+{
+    // the lookups done for an event on a window that isn't managed, with 500 clients
+    QScopedPointer<xcb_connection_t, XcbConnectionDeleter> c(xcb_connect(nullptr, nullptr));
+    QVERIFY(!xcb_connection_has_error(c.data()));
+    const int clientCount = workspace()->clientList().count();
+    const int windowCount = 500;
+    QVector<xcb_window_t> windows;
+    for (int i = 0; i < windowCount; ++i) {
+        xcb_window_t w = xcb_generate_id(c.data());
+        xcb_create_window(c.data(), XCB_COPY_FROM_PARENT, w, rootWindow(),
+                          0, 0, 100, 100,
+                          0, XCB_WINDOW_CLASS_INPUT_OUTPUT, XCB_COPY_FROM_PARENT, 0, nullptr);
+        xcb_map_window(c.data(), w);
+        windows.append(w);
+    }
+    xcb_flush(c.data());
+    QTRY_COMPARE_WITH_TIMEOUT(workspace()->clientList().count(), clientCount + windowCount, 30000);
+
+    const xcb_window_t unknown = xcb_generate_id(c.data());
+    QBENCHMARK {
+        QVERIFY(!workspace()->findClient(Predicate::WindowMatch, unknown));
+        QVERIFY(!workspace()->findClient(Predicate::WrapperIdMatch, unknown));
+        QVERIFY(!workspace()->findClient(Predicate::FrameIdMatch, unknown));
+        QVERIFY(!workspace()->findClient(Predicate::InputIdMatch, unknown));
+        QVERIFY(!workspace()->findUnmanaged(unknown));
+    }
+
+    for (xcb_window_t w : qAsConst(windows)) {
+        xcb_destroy_window(c.data(), w);
+    }
+    xcb_flush(c.data());
+    QTRY_COMPARE_WITH_TIMEOUT(workspace()->clientList().count(), clientCount, 30000);
+}
+
 WAYLANDTEST_MAIN(X11ClientTest)
 #include "x11_client_test.moc"
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <deepin_kwinnaturallayout.h>
+
+#include <QtTest>
+
+#include <QRandomGenerator>
+
+using KWin::NaturalLayout;
+
+static const QRect s_area(0, 0, 1920, 1080);
+
+// cascaded windows of random sizes, with some of them stacked exactly on top of each other
+static QVector<QRect> syntheticWindows(int count)
+{
+    QRandomGenerator generator(count);
+    QVector<QRect> windows;
+    windows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (i % 5 == 4) {
+            windows.append(windows.last());
+            continue;
+        }
+        const QSize size(generator.bounded(200, 1400), generator.bounded(150, 900));
+        const QPoint position(generator.bounded(s_area.width() - size.width()), generator.bounded(s_area.height() - size.height()));
+        windows.append(QRect(position, size));
+    }
+    return windows;
+}
+
+class NaturalLayoutTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testSeparate_data();
+    void testSeparate();
+    void testDeterministic();
+    void testFillGaps();
+    void benchmarkLayout_data();
+    void benchmarkLayout();
+};
+
+void NaturalLayoutTest::testSeparate_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("50") << 50;
+    QTest::newRow("200") << 200;
+}
+
+void NaturalLayoutTest::testSeparate()
+{
+    QFETCH(int, count);
+
+    NaturalLayout layout(syntheticWindows(count));
+    QRect bounds = s_area;
+    QVERIFY(layout.separate(bounds));
+
+    const QVector<QRect> &targets = layout.targets();
+    QCOMPARE(targets.count(), count);
+    const QMargins margins(5, 5, 5, 5);
+    for (int i = 0; i < targets.count(); ++i) {
+        QVERIFY(bounds.contains(targets[i]));
+        for (int j = i + 1; j < targets.count(); ++j) {
+            QVERIFY(!targets[i].marginsAdded(margins).intersects(targets[j].marginsAdded(margins)));
+        }
+    }
+}
+
+void NaturalLayoutTest::testDeterministic()
+{
+    const QVector<QRect> windows = syntheticWindows(50);
+
+    NaturalLayout first(windows);
+    QRect firstBounds;
+    first.separate(firstBounds);
+
+    NaturalLayout second(windows);
+    QRect secondBounds;
+    second.separate(secondBounds);
+
+    QCOMPARE(firstBounds, secondBounds);
+    QCOMPARE(first.targets(), second.targets());
+}
+
+void NaturalLayoutTest::testFillGaps()
+{
+    // a small window is enlarged up to twice its size, but not into the border
+    NaturalLayout layout({QRect(0, 0, 100, 50)});
+    QRegion border(s_area.adjusted(-200, -200, 200, 200));
+    border ^= s_area;
+    layout.fillGaps(border);
+
+    const QRect target = layout.targets().constFirst();
+    QCOMPARE(target.size(), QSize(200, 100));
+    QVERIFY(s_area.contains(target));
+}
+
+void NaturalLayoutTest::benchmarkLayout_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("50") << 50;
+    QTest::newRow("200") << 200;
+}
+
+void NaturalLayoutTest::benchmarkLayout()
+{
+    QFETCH(int, count);
+    const QVector<QRect> windows = syntheticWindows(count);
+
+    QBENCHMARK {
+        NaturalLayout layout(windows);
+        QRect bounds = s_area;
+        layout.separate(bounds);
+
+        const qreal scale = std::min(s_area.width() / qreal(bounds.width()), s_area.height() / qreal(bounds.height()));
+        layout.map(bounds, scale, s_area.topLeft());
+
+        QRegion border(s_area.adjusted(-200, -200, 200, 200));
+        border ^= s_area;
+        layout.fillGaps(border);
+    }
+}
+
+QTEST_MAIN(NaturalLayoutTest)
+
+#include "naturallayouttest.moc"
@@ -0,0 +1,505 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <deepin_kwineffects.h>
+
+#include <QtTest>
+
+using namespace KWin;
+
+class MockEffectWindow : public EffectWindow
+{
+    Q_OBJECT
+public:
+    MockEffectWindow(QObject *parent = nullptr);
+    QVariant data(int role) const override;
+    QRect decorationInnerRect() const override;
+    void deleteProperty(long int atom) const override;
+    void disablePainting(int reason) override;
+    void enablePainting(int reason) override;
+    void addRepaint(const QRect &r) override;
+    void addRepaint(int x, int y, int w, int h) override;
+    void addRepaintFull() override;
+    void addLayerRepaint(const QRect &r) override;
+    void addLayerRepaint(int x, int y, int w, int h) override;
+    EffectWindow *findModal() override;
+    EffectWindow *transientFor() override;
+    const EffectWindowGroup *group() const override;
+    bool isPaintingEnabled() override;
+    EffectWindowList mainWindows() const override;
+    QByteArray readProperty(long int atom, long int type, int format) const override;
+    void refWindow() override;
+    void unrefWindow() override;
+    void setData(int role, const QVariant &data) override;
+    void minimize() override;
+    void unminimize() override;
+    void closeWindow() override;
+    void referencePreviousWindowPixmap() override {}
+    void unreferencePreviousWindowPixmap() override {}
+    QWindow *internalWindow() const override {
+        return nullptr;
+    }
+    bool isDeleted() const override {
+        return false;
+    }
+    bool isMinimized() const override {
+        return false;
+    }
+    double opacity() const override {
+        return 1.0;
+    }
+    void setGeometry(const QRect &geometry) {
+        m_geometry = geometry;
+    }
+    bool hasAlpha() const override {
+        return true;
+    }
+    QStringList activities() const override {
+        return QStringList();
+    }
+    int desktop() const override {
+        return 0;
+    }
+    QVector<uint> desktops() const override {
+        return {};
+    }
+    int x() const override {
+        return m_geometry.x();
+    }
+    int y() const override {
+        return m_geometry.y();
+    }
+    int width() const override {
+        return m_geometry.width();
+    }
+    int height() const override {
+        return m_geometry.height();
+    }
+    QSize basicUnit() const override {
+        return QSize();
+    }
+    QRect geometry() const override {
+        return m_geometry;
+    }
+    QRect expandedGeometry() const override {
+        return m_geometry;
+    }
+    QRect frameGeometry() const override {
+        return m_geometry;
+    }
+    QRect bufferGeometry() const override {
+        return m_geometry;
+    }
+    QRect clientGeometry() const override {
+        return m_geometry;
+    }
+    EffectScreen *screen() const override {
+        return nullptr;
+    }
+    QPoint pos() const override {
+        return m_geometry.topLeft();
+    }
+    QSize size() const override {
+        return m_geometry.size();
+    }
+    QRect rect() const override {
+        return QRect(QPoint(0, 0), m_geometry.size());
+    }
+    bool isMovable() const override {
+        return true;
+    }
+    bool isMovableAcrossScreens() const override {
+        return true;
+    }
+    bool isUserMove() const override {
+        return false;
+    }
+    bool isUserResize() const override {
+        return false;
+    }
+    QRect iconGeometry() const override {
+        return QRect();
+    }
+    bool isDesktop() const override {
+        return false;
+    }
+    bool isDock() const override {
+        return false;
+    }
+    bool isToolbar() const override {
+        return false;
+    }
+    bool isMenu() const override {
+        return false;
+    }
+    bool isNormalWindow() const override {
+        return true;
+    }
+    bool isSpecialWindow() const override {
+        return false;
+    }
+    bool isDialog() const override {
+        return false;
+    }
+    bool isSplash() const override {
+        return false;
+    }
+    bool isUtility() const override {
+        return false;
+    }
+    bool isDropdownMenu() const override {
+        return false;
+    }
+    bool isPopupMenu() const override {
+        return false;
+    }
+    bool isTooltip() const override {
+        return false;
+    }
+    bool isNotification() const override {
+        return false;
+    }
+    bool isCriticalNotification() const override {
+        return false;
+    }
+    bool isOnScreenDisplay() const override  {
+        return false;
+    }
+    bool isComboBox() const override {
+        return false;
+    }
+    bool isDNDIcon() const override {
+        return false;
+    }
+    QRect contentsRect() const override {
+        return QRect();
+    }
+    bool decorationHasAlpha() const override {
+        return false;
+    }
+    QString caption() const override {
+        return QString();
+    }
+    QIcon icon() const override {
+        return QIcon();
+    }
+    QString windowClass() const override {
+        return QString();
+    }
+    QString windowRole() const override {
+        return QString();
+    }
+    NET::WindowType windowType() const override {
+        return NET::Normal;
+    }
+    bool acceptsFocus() const override {
+        return true;
+    }
+    bool keepAbove() const override {
+        return false;
+    }
+    bool keepBelow() const override {
+        return false;
+    }
+    bool isModal() const override {
+        return false;
+    }
+    bool isSkipSwitcher() const override {
+        return false;
+    }
+    bool isCurrentTab() const override {
+        return true;
+    }
+    bool skipsCloseAnimation() const override {
+        return false;
+    }
+    KWaylandServer::SurfaceInterface *surface() const override {
+        return nullptr;
+    }
+    bool isFullScreen() const override {
+        return false;
+    }
+    bool isUnresponsive() const override {
+        return false;
+    }
+    bool isPopupWindow() const override {
+        return false;
+    }
+    bool isManaged() const override {
+        return true;
+    }
+    bool isWaylandClient() const override {
+        return true;
+    }
+    bool isX11Client() const override {
+        return false;
+    }
+    bool isOutline() const override {
+        return false;
+    }
+    bool isSwitcherWin() const override {
+        return false;
+    }
+    bool isLockScreen() const override {
+        return false;
+    }
+    pid_t pid() const override {
+        return 0;
+    }
+    qlonglong windowId() const override {
+        return 0;
+    }
+
+private:
+    QRect m_geometry;
+};
+
+MockEffectWindow::MockEffectWindow(QObject *parent)
+    : EffectWindow(parent)
+{
+}
+
+QVariant MockEffectWindow::data(int role) const
+{
+    Q_UNUSED(role)
+    return QVariant();
+}
+
+QRect MockEffectWindow::decorationInnerRect() const
+{
+    return QRect();
+}
+
+void MockEffectWindow::deleteProperty(long int atom) const
+{
+    Q_UNUSED(atom)
+}
+
+void MockEffectWindow::disablePainting(int reason)
+{
+    Q_UNUSED(reason)
+}
+
+void MockEffectWindow::enablePainting(int reason)
+{
+    Q_UNUSED(reason)
+}
+
+void MockEffectWindow::addRepaint(const QRect &r)
+{
+    Q_UNUSED(r)
+}
+
+void MockEffectWindow::addRepaint(int x, int y, int w, int h)
+{
+    Q_UNUSED(x)
+    Q_UNUSED(y)
+    Q_UNUSED(w)
+    Q_UNUSED(h)
+}
+
+void MockEffectWindow::addRepaintFull()
+{
+}
+
+void MockEffectWindow::addLayerRepaint(const QRect &r)
+{
+    Q_UNUSED(r)
+}
+
+void MockEffectWindow::addLayerRepaint(int x, int y, int w, int h)
+{
+    Q_UNUSED(x)
+    Q_UNUSED(y)
+    Q_UNUSED(w)
+    Q_UNUSED(h)
+}
+
+EffectWindow *MockEffectWindow::findModal()
+{
+    return nullptr;
+}
+
+EffectWindow *MockEffectWindow::transientFor()
+{
+    return nullptr;
+}
+
+const EffectWindowGroup *MockEffectWindow::group() const
+{
+    return nullptr;
+}
+
+bool MockEffectWindow::isPaintingEnabled()
+{
+    return true;
+}
+
+EffectWindowList MockEffectWindow::mainWindows() const
+{
+    return EffectWindowList();
+}
+
+QByteArray MockEffectWindow::readProperty(long int atom, long int type, int format) const
+{
+    Q_UNUSED(atom)
+    Q_UNUSED(type)
+    Q_UNUSED(format)
+    return QByteArray();
+}
+
+void MockEffectWindow::refWindow()
+{
+}
+
+void MockEffectWindow::setData(int role, const QVariant &data)
+{
+    Q_UNUSED(role)
+    Q_UNUSED(data)
+}
+
+void MockEffectWindow::minimize()
+{
+}
+
+void MockEffectWindow::unminimize()
+{
+}
+
+void MockEffectWindow::closeWindow()
+{
+}
+
+void MockEffectWindow::unrefWindow()
+{
+}
+
+
+class WindowMotionManagerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testManageAtRest();
+    void testMoveWindow();
+    void testSetTransformedGeometry();
+    void testSetTransformedGeometryAtTarget();
+    void testUnmanage();
+};
+
+// steps the motions until all of them settled, returns false if they never do
+static bool settle(WindowMotionManager &manager)
+{
+    for (int i = 0; i < 1000 && manager.areWindowsMoving(); ++i) {
+        manager.calculate(16);
+    }
+    return !manager.areWindowsMoving();
+}
+
+void WindowMotionManagerTest::testManageAtRest()
+{
+    MockEffectWindow window;
+    window.setGeometry(QRect(100, 200, 300, 400));
+
+    WindowMotionManager manager(false);
+    manager.manage(&window);
+    QVERIFY(manager.isManaging(&window));
+    QVERIFY(!manager.areWindowsMoving());
+    QCOMPARE(manager.transformedGeometry(&window), QRectF(100, 200, 300, 400));
+    QCOMPARE(manager.targetGeometry(&window), QRectF(100, 200, 300, 400));
+
+    // a managed window at rest stays where it is
+    manager.calculate(16);
+    QVERIFY(!manager.areWindowsMoving());
+    QCOMPARE(manager.transformedGeometry(&window), QRectF(100, 200, 300, 400));
+}
+
+void WindowMotionManagerTest::testMoveWindow()
+{
+    MockEffectWindow moved;
+    moved.setGeometry(QRect(100, 200, 300, 400));
+    MockEffectWindow resting;
+    resting.setGeometry(QRect(500, 600, 100, 100));
+
+    WindowMotionManager manager(false);
+    manager.manage(&moved);
+    manager.manage(&resting);
+
+    manager.moveWindow(&moved, QPoint(0, 0), 0.5);
+    QVERIFY(manager.areWindowsMoving());
+    QCOMPARE(manager.targetGeometry(&moved), QRectF(0, 0, 150, 200));
+
+    manager.calculate(16);
+    const QRectF step = manager.transformedGeometry(&moved);
+    QVERIFY(step != QRectF(100, 200, 300, 400));
+    QVERIFY(step != QRectF(0, 0, 150, 200));
+
+    QVERIFY(settle(manager));
+    QCOMPARE(manager.transformedGeometry(&moved), QRectF(0, 0, 150, 200));
+    QCOMPARE(manager.transformedGeometry(&resting), QRectF(500, 600, 100, 100));
+
+    // moving to where the window already is doesn't start a motion
+    manager.moveWindow(&moved, QPoint(0, 0), 0.5);
+    QVERIFY(!manager.areWindowsMoving());
+}
+
+void WindowMotionManagerTest::testSetTransformedGeometry()
+{
+    MockEffectWindow window;
+    window.setGeometry(QRect(100, 200, 300, 400));
+
+    WindowMotionManager manager(false);
+    manager.manage(&window);
+
+    // a window at rest that is displaced moves back towards its target
+    manager.setTransformedGeometry(&window, QRectF(0, 0, 150, 200));
+    QCOMPARE(manager.transformedGeometry(&window), QRectF(0, 0, 150, 200));
+    QVERIFY(manager.areWindowsMoving());
+
+    manager.calculate(16);
+    QVERIFY(manager.transformedGeometry(&window) != QRectF(0, 0, 150, 200));
+
+    QVERIFY(settle(manager));
+    QCOMPARE(manager.transformedGeometry(&window), QRectF(100, 200, 300, 400));
+}
+
+void WindowMotionManagerTest::testSetTransformedGeometryAtTarget()
+{
+    MockEffectWindow window;
+    window.setGeometry(QRect(100, 200, 300, 400));
+
+    WindowMotionManager manager(false);
+    manager.manage(&window);
+    manager.moveWindow(&window, QPoint(0, 0), 0.5);
+    QVERIFY(manager.areWindowsMoving());
+
+    // placing the window at its target finishes the motion with the next step
+    manager.setTransformedGeometry(&window, QRectF(0, 0, 150, 200));
+    manager.calculate(16);
+    QVERIFY(!manager.areWindowsMoving());
+    QCOMPARE(manager.transformedGeometry(&window), QRectF(0, 0, 150, 200));
+
+    // and doesn't start one for a window at rest
+    manager.setTransformedGeometry(&window, QRectF(0, 0, 150, 200));
+    QVERIFY(!manager.areWindowsMoving());
+}
+
+void WindowMotionManagerTest::testUnmanage()
+{
+    MockEffectWindow window;
+    window.setGeometry(QRect(100, 200, 300, 400));
+
+    WindowMotionManager manager(false);
+    manager.manage(&window);
+    manager.moveWindow(&window, QPoint(0, 0));
+    QVERIFY(manager.areWindowsMoving());
+
+    manager.unmanage(&window);
+    QVERIFY(!manager.isManaging(&window));
+    QVERIFY(!manager.areWindowsMoving());
+    QCOMPARE(manager.transformedGeometry(&window), QRectF(100, 200, 300, 400));
+}
+
+QTEST_MAIN(WindowMotionManagerTest)
+#include "windowmotionmanagertest.moc"
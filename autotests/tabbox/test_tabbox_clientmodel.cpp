@@ -79,5 +79,45 @@ void TestTabBoxClientModel::testCreateClientListActiveClientNotInFocusChain()
     QCOMPARE(clientModel->rowCount(), 1);
 }
 
+void TestTabBoxClientModel::testCreateClientListIncremental()
+{
+    MockTabBoxHandler tabboxhandler;
+    tabboxhandler.setConfig(TabBox::TabBoxConfig());
+    TabBox::ClientModel *clientModel = new TabBox::ClientModel(&tabboxhandler);
+    QWeakPointer<TabBox::TabBoxClient> first = tabboxhandler.createMockWindow(QString("test"));
+    QWeakPointer<TabBox::TabBoxClient> second = tabboxhandler.createMockWindow(QString("test2"));
+    QWeakPointer<TabBox::TabBoxClient> third = tabboxhandler.createMockWindow(QString("test3"));
+    clientModel->createClientList();
+    QCOMPARE(clientModel->clientList(), TabBox::TabBoxClientList({third, first, second}));
+
+    QSignalSpy resetSpy(clientModel, &QAbstractItemModel::modelReset);
+    QSignalSpy movedSpy(clientModel, &QAbstractItemModel::rowsMoved);
+    QSignalSpy insertedSpy(clientModel, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removedSpy(clientModel, &QAbstractItemModel::rowsRemoved);
+
+    // activating another window only moves rows
+    tabboxhandler.setActiveClient(first);
+    clientModel->createClientList();
+    QCOMPARE(clientModel->clientList(), TabBox::TabBoxClientList({first, second, third}));
+    QVERIFY(!movedSpy.isEmpty());
+    QVERIFY(insertedSpy.isEmpty());
+    QVERIFY(removedSpy.isEmpty());
+
+    // a new window is inserted
+    QWeakPointer<TabBox::TabBoxClient> fourth = tabboxhandler.createMockWindow(QString("test4"));
+    clientModel->createClientList();
+    QCOMPARE(clientModel->clientList(), TabBox::TabBoxClientList({fourth, first, second, third}));
+    QCOMPARE(insertedSpy.count(), 1);
+
+    // a closed window is removed
+    tabboxhandler.closeWindow(second.toStrongRef().data());
+    clientModel->createClientList();
+    QCOMPARE(clientModel->clientList(), TabBox::TabBoxClientList({fourth, first, third}));
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(clientModel->rowCount(), 3);
+
+    QVERIFY(resetSpy.isEmpty());
+}
+
 Q_CONSTRUCTOR_FUNCTION(forceXcb)
 QTEST_MAIN(TestTabBoxClientModel)
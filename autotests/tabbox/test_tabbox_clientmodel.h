@@ -37,6 +37,11 @@ private Q_SLOTS:
      * See BUG: 306260
      */
     void testCreateClientListActiveClientNotInFocusChain();
+    /**
+     * Tests that recreating the Client list moves, inserts and removes
+     * rows instead of resetting the model.
+     */
+    void testCreateClientListIncremental();
 };
 
 #endif
@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "utils/cliprectlist.h"
+
+#include <QTest>
+
+#include <cmath>
+
+using namespace KWin;
+
+// A stack of windows with rounded corners, the way the occlusion pass sees them:
+// every corner contributes one band per scanline.
+static QRegion roundedWindow(const QRect &geometry, int radius)
+{
+    QRegion region(geometry.adjusted(0, radius, 0, -radius));
+    for (int i = 0; i < radius; ++i) {
+        const int inset = radius - qRound(std::sqrt(qreal(radius * radius - (radius - i) * (radius - i))));
+        region += QRect(geometry.x() + inset, geometry.y() + i, geometry.width() - 2 * inset, 1);
+        region += QRect(geometry.x() + inset, geometry.bottom() - i, geometry.width() - 2 * inset, 1);
+    }
+    return region;
+}
+
+static QRegion stackedWindows(int count)
+{
+    QRegion region;
+    for (int i = 0; i < count; ++i) {
+        region += roundedWindow(QRect(40 * i, 30 * i, 800, 600), 8);
+    }
+    return region;
+}
+
+static QVector<QRectF> tiles(const QRect &area, int size)
+{
+    QVector<QRectF> ret;
+    for (int y = area.top(); y < area.bottom(); y += size) {
+        for (int x = area.left(); x < area.right(); x += size) {
+            ret.append(QRectF(x, y, size, size));
+        }
+    }
+    return ret;
+}
+
+static QVector<QRectF> clipWithRegion(const QVector<QRectF> &rects, const QRegion &clip)
+{
+    QVector<QRectF> ret;
+    for (const QRectF &rect : rects) {
+        for (const QRect &r : clip) {
+            const QRectF intersected = QRectF(r).intersected(rect);
+            if (intersected.isValid()) {
+                ret.append(intersected);
+            }
+        }
+    }
+    return ret;
+}
+
+static QVector<QRectF> clipWithList(const QVector<QRectF> &rects, const ClipRectList &clip)
+{
+    QVector<QRectF> ret;
+    for (const QRectF &rect : rects) {
+        clip.forEachIntersection(rect, [&](const QRectF &r) {
+            const QRectF intersected = r.intersected(rect);
+            if (intersected.isValid()) {
+                ret.append(intersected);
+            }
+            return true;
+        });
+    }
+    return ret;
+}
+
+class ClipRectListTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEmpty();
+    void testIntersects_data();
+    void testIntersects();
+    void testClip_data();
+    void testClip();
+    void benchmarkRegion_data();
+    void benchmarkRegion();
+    void benchmarkList_data();
+    void benchmarkList();
+};
+
+void ClipRectListTest::testEmpty()
+{
+    const ClipRectList list;
+    QVERIFY(list.isEmpty());
+    QCOMPARE(list.count(), 0);
+    QVERIFY(!list.intersects(QRect(0, 0, 100, 100)));
+}
+
+void ClipRectListTest::testIntersects_data()
+{
+    QTest::addColumn<QRegion>("region");
+    QTest::addColumn<QRect>("rect");
+
+    const QRegion rounded = roundedWindow(QRect(0, 0, 100, 100), 8);
+    QTest::newRow("inside") << rounded << QRect(40, 40, 10, 10);
+    QTest::newRow("corner") << rounded << QRect(0, 0, 2, 2);
+    QTest::newRow("edge") << rounded << QRect(99, 50, 5, 5);
+    QTest::newRow("touching") << rounded << QRect(100, 50, 5, 5);
+    QTest::newRow("below") << rounded << QRect(0, 200, 5, 5);
+    QTest::newRow("stacked") << stackedWindows(4) << QRect(820, 10, 20, 20);
+    QTest::newRow("gap") << (QRegion(0, 0, 10, 10) + QRegion(20, 0, 10, 10)) << QRect(10, 0, 10, 10);
+}
+
+void ClipRectListTest::testIntersects()
+{
+    QFETCH(QRegion, region);
+    QFETCH(QRect, rect);
+
+    const ClipRectList list(region);
+    QCOMPARE(list.count(), region.rectCount());
+    QCOMPARE(list.boundingRect(), region.boundingRect());
+    QCOMPARE(list.intersects(rect), region.intersects(rect));
+}
+
+void ClipRectListTest::testClip_data()
+{
+    QTest::addColumn<QRegion>("region");
+
+    QTest::newRow("rounded") << roundedWindow(QRect(10, 10, 300, 200), 8);
+    QTest::newRow("stacked") << stackedWindows(8);
+    QTest::newRow("disjoint") << (QRegion(0, 0, 50, 50) + QRegion(400, 300, 50, 50));
+}
+
+void ClipRectListTest::testClip()
+{
+    QFETCH(QRegion, region);
+
+    const QVector<QRectF> rects = tiles(QRect(0, 0, 1200, 900), 64);
+    QCOMPARE(clipWithList(rects, ClipRectList(region)), clipWithRegion(rects, region));
+}
+
+void ClipRectListTest::benchmarkRegion_data()
+{
+    QTest::addColumn<int>("windows");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("8") << 8;
+    QTest::newRow("16") << 16;
+}
+
+void ClipRectListTest::benchmarkRegion()
+{
+    QFETCH(int, windows);
+
+    const QRegion region = stackedWindows(windows);
+    const QVector<QRectF> rects = tiles(QRect(0, 0, 1920, 1080), 64);
+    QBENCHMARK {
+        clipWithRegion(rects, region);
+    }
+}
+
+void ClipRectListTest::benchmarkList_data()
+{
+    benchmarkRegion_data();
+}
+
+void ClipRectListTest::benchmarkList()
+{
+    QFETCH(int, windows);
+
+    const QRegion region = stackedWindows(windows);
+    const QVector<QRectF> rects = tiles(QRect(0, 0, 1920, 1080), 64);
+    QBENCHMARK {
+        clipWithList(rects, ClipRectList(region));
+    }
+}
+
+QTEST_MAIN(ClipRectListTest)
+#include "test_cliprectlist.moc"
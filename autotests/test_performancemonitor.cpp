@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "performancemonitor.h"
+
+#include <QTest>
+
+#include <algorithm>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestPerformanceMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    TestPerformanceMonitor();
+private Q_SLOTS:
+    void testHistogram();
+    void testTakeSnapshot();
+    void testEffectStatistics();
+    void testEffectCosts();
+    void testEffectProfiling();
+    void testX11SyncStatistics();
+    void benchmarkRecord();
+};
+
+TestPerformanceMonitor::TestPerformanceMonitor()
+{
+    PerformanceMonitor::create(this);
+}
+
+void TestPerformanceMonitor::testHistogram()
+{
+    PerformanceHistogram histogram;
+    histogram.record(500us);
+    histogram.record(1500us);
+    histogram.record(16ms);
+    histogram.record(1s);
+
+    const QVariantMap snapshot = histogram.snapshot();
+    QCOMPARE(snapshot.value(QStringLiteral("count")).toULongLong(), quint64(4));
+    QCOMPARE(snapshot.value(QStringLiteral("max")).toULongLong(), quint64(std::chrono::nanoseconds(1s).count()));
+
+    const QVariantList buckets = snapshot.value(QStringLiteral("buckets")).toList();
+    QCOMPARE(buckets.count(), PerformanceHistogram::BucketCount);
+    QCOMPARE(snapshot.value(QStringLiteral("bucketLimits")).toList().count(), PerformanceHistogram::BucketCount - 1);
+    QCOMPARE(buckets.at(0).toULongLong(), quint64(1));
+    QCOMPARE(buckets.at(1).toULongLong(), quint64(1));
+    QCOMPARE(buckets.at(8).toULongLong(), quint64(1));
+    QCOMPARE(buckets.last().toULongLong(), quint64(1));
+}
+
+void TestPerformanceMonitor::testTakeSnapshot()
+{
+    PerformanceMonitor *monitor = PerformanceMonitor::self();
+    FrameStatistics *statistics = monitor->frameStatistics(QStringLiteral("Virtual-0"));
+    QCOMPARE(monitor->frameStatistics(QStringLiteral("Virtual-0")), statistics);
+
+    statistics->presentedFrames += 4;
+    statistics->directScanoutFrames += 1;
+    statistics->renderTime.record(2ms);
+
+    QVariantMap output = monitor->snapshot(true).value(QStringLiteral("outputs")).toMap().value(QStringLiteral("Virtual-0")).toMap();
+    QCOMPARE(output.value(QStringLiteral("presentedFrames")).toULongLong(), quint64(4));
+    QCOMPARE(output.value(QStringLiteral("directScanoutRate")).toDouble(), 0.25);
+    QCOMPARE(output.value(QStringLiteral("renderTime")).toMap().value(QStringLiteral("count")).toULongLong(), quint64(1));
+
+    output = monitor->snapshot().value(QStringLiteral("outputs")).toMap().value(QStringLiteral("Virtual-0")).toMap();
+    QCOMPARE(output.value(QStringLiteral("presentedFrames")).toULongLong(), quint64(0));
+    QCOMPARE(output.value(QStringLiteral("renderTime")).toMap().value(QStringLiteral("count")).toULongLong(), quint64(0));
+}
+
+void TestPerformanceMonitor::testEffectStatistics()
+{
+    PerformanceMonitor *monitor = PerformanceMonitor::self();
+    EffectStatistics *statistics = monitor->effectStatistics(QStringLiteral("blur"));
+    statistics->record(EffectStatistics::PaintScreen, 3ms);
+    statistics->record(EffectStatistics::PaintScreen, 1ms);
+
+    const QVariantMap paintScreen = monitor->snapshot().value(QStringLiteral("effects")).toMap()
+        .value(QStringLiteral("blur")).toMap().value(QStringLiteral("paintScreen")).toMap();
+    QCOMPARE(paintScreen.value(QStringLiteral("calls")).toULongLong(), quint64(2));
+    QCOMPARE(paintScreen.value(QStringLiteral("time")).toULongLong(), quint64(std::chrono::nanoseconds(4ms).count()));
+}
+
+void TestPerformanceMonitor::testEffectCosts()
+{
+    PerformanceMonitor *monitor = PerformanceMonitor::self();
+    EffectStatistics *statistics = monitor->effectStatistics(QStringLiteral("zoom"));
+    statistics->record(EffectStatistics::PrePaintScreen, 1ms);
+    statistics->record(EffectStatistics::PaintWindow, 2ms);
+    statistics->recordGpu(EffectStatistics::PaintWindow, 5ms);
+
+    const QVector<EffectCost> costs = monitor->effectCosts();
+    auto it = std::find_if(costs.begin(), costs.end(), [](const EffectCost &cost) {
+        return cost.name == QLatin1String("zoom");
+    });
+    QVERIFY(it != costs.end());
+    QCOMPARE(it->cpuTime, std::chrono::nanoseconds(3ms));
+    QCOMPARE(it->gpuTime, std::chrono::nanoseconds(5ms));
+}
+
+void TestPerformanceMonitor::testEffectProfiling()
+{
+    PerformanceMonitor *monitor = PerformanceMonitor::self();
+    QVERIFY(!monitor->isEffectProfilingEnabled());
+    monitor->beginEffectProfiling();
+    monitor->beginEffectProfiling();
+    QVERIFY(monitor->isEffectProfilingEnabled());
+    monitor->endEffectProfiling();
+    QVERIFY(monitor->isEffectProfilingEnabled());
+    monitor->endEffectProfiling();
+    QVERIFY(!monitor->isEffectProfilingEnabled());
+}
+
+void TestPerformanceMonitor::testX11SyncStatistics()
+{
+    // the size of the fence ring is a gauge and survives a reset
+    PerformanceMonitor *monitor = PerformanceMonitor::self();
+    X11SyncStatistics *statistics = monitor->x11SyncStatistics();
+    statistics->fenceLatency.record(3ms);
+    statistics->stallTime.record(17ms);
+    statistics->skippedFrames += 2;
+    statistics->fenceCount = 6;
+
+    QVariantMap sync = monitor->snapshot(true).value(QStringLiteral("x11Sync")).toMap();
+    QCOMPARE(sync.value(QStringLiteral("fenceLatency")).toMap().value(QStringLiteral("count")).toULongLong(), quint64(1));
+    QCOMPARE(sync.value(QStringLiteral("stallTime")).toMap().value(QStringLiteral("sum")).toULongLong(), quint64(std::chrono::nanoseconds(17ms).count()));
+    QCOMPARE(sync.value(QStringLiteral("skippedFrames")).toULongLong(), quint64(2));
+    QCOMPARE(sync.value(QStringLiteral("fenceCount")).toULongLong(), quint64(6));
+
+    sync = monitor->snapshot().value(QStringLiteral("x11Sync")).toMap();
+    QCOMPARE(sync.value(QStringLiteral("skippedFrames")).toULongLong(), quint64(0));
+    QCOMPARE(sync.value(QStringLiteral("fenceCount")).toULongLong(), quint64(6));
+}
+
+void TestPerformanceMonitor::benchmarkRecord()
+{
+    PerformanceHistogram histogram;
+    QBENCHMARK {
+        histogram.record(8ms);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestPerformanceMonitor)
+#include "test_performancemonitor.moc"
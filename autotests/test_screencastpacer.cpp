@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "plugins/screencast/screencastpacer.h"
+
+#include <QTest>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+// 30 frames per second
+static const std::chrono::nanoseconds s_interval = std::chrono::nanoseconds(1s) / 30;
+
+class TestScreenCastPacer : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testNothingPending();
+    void testFirstFrame();
+    void testPaced();
+    void testUnlimited();
+    void testAccumulateDamage();
+    void testCursorUpdate();
+};
+
+void TestScreenCastPacer::testNothingPending()
+{
+    ScreenCastPacer pacer;
+    QVERIFY(!pacer.hasPendingUpdate());
+    pacer.addDamage(QRegion());
+    QVERIFY(!pacer.hasPendingUpdate());
+}
+
+void TestScreenCastPacer::testFirstFrame()
+{
+    // nothing was captured yet, the first update doesn't wait
+    ScreenCastPacer pacer;
+    pacer.addDamage(QRect(0, 0, 10, 10));
+    QVERIFY(pacer.hasPendingUpdate());
+    QCOMPARE(pacer.delay(ScreenCastPacer::Clock::now(), s_interval), 0ms);
+}
+
+void TestScreenCastPacer::testPaced()
+{
+    const auto start = ScreenCastPacer::Clock::now();
+
+    ScreenCastPacer pacer;
+    pacer.addDamage(QRect(0, 0, 10, 10));
+    pacer.takeDamage(start);
+
+    // an update right after a frame waits for the next slot
+    pacer.addDamage(QRect(0, 0, 10, 10));
+    QCOMPARE(pacer.delay(start, s_interval), 34ms);
+    QCOMPARE(pacer.delay(start + 10ms, s_interval), 24ms);
+    // a partial millisecond is waited for, the update is never captured early
+    QCOMPARE(pacer.delay(start + 33ms, s_interval), 1ms);
+    QCOMPARE(pacer.delay(start + s_interval, s_interval), 0ms);
+    QCOMPARE(pacer.delay(start + 100ms, s_interval), 0ms);
+}
+
+void TestScreenCastPacer::testUnlimited()
+{
+    // without a negotiated max framerate every update is captured
+    const auto start = ScreenCastPacer::Clock::now();
+
+    ScreenCastPacer pacer;
+    pacer.addDamage(QRect(0, 0, 10, 10));
+    pacer.takeDamage(start);
+    pacer.addDamage(QRect(0, 0, 10, 10));
+    QCOMPARE(pacer.delay(start, std::chrono::nanoseconds::zero()), 0ms);
+}
+
+void TestScreenCastPacer::testAccumulateDamage()
+{
+    // the damage of the skipped repaints goes into the next frame, and only into it
+    const auto start = ScreenCastPacer::Clock::now();
+
+    ScreenCastPacer pacer;
+    pacer.addDamage(QRect(0, 0, 10, 10));
+    QCOMPARE(pacer.takeDamage(start), QRegion(0, 0, 10, 10));
+    QVERIFY(!pacer.hasPendingUpdate());
+
+    pacer.addDamage(QRect(20, 20, 10, 10));
+    pacer.addDamage(QRect(40, 40, 10, 10));
+    QCOMPARE(pacer.pendingDamage(), QRegion(20, 20, 10, 10) | QRegion(40, 40, 10, 10));
+    QCOMPARE(pacer.takeDamage(start + s_interval), QRegion(20, 20, 10, 10) | QRegion(40, 40, 10, 10));
+    QVERIFY(!pacer.hasPendingUpdate());
+    QVERIFY(pacer.pendingDamage().isEmpty());
+}
+
+void TestScreenCastPacer::testCursorUpdate()
+{
+    // a cursor update is paced like a repaint
+    const auto start = ScreenCastPacer::Clock::now();
+
+    ScreenCastPacer pacer;
+    pacer.addDamage(QRect(0, 0, 10, 10));
+    pacer.takeDamage(start);
+
+    pacer.addCursorUpdate();
+    QVERIFY(pacer.hasPendingUpdate());
+    QVERIFY(pacer.hasPendingCursorUpdate());
+    QVERIFY(pacer.pendingDamage().isEmpty());
+    QCOMPARE(pacer.delay(start + 10ms, s_interval), 24ms);
+
+    // it goes with the next buffer, whether that carries contents or not
+    QVERIFY(pacer.takeDamage(start + s_interval).isEmpty());
+    QVERIFY(!pacer.hasPendingUpdate());
+    QVERIFY(!pacer.hasPendingCursorUpdate());
+
+    // and the interval to the buffer after it starts over
+    pacer.addCursorUpdate();
+    pacer.addDamage(QRect(0, 0, 10, 10));
+    QCOMPARE(pacer.delay(start + s_interval, s_interval), 34ms);
+    QCOMPARE(pacer.takeDamage(start + 2 * s_interval), QRegion(0, 0, 10, 10));
+    QVERIFY(!pacer.hasPendingCursorUpdate());
+}
+
+QTEST_MAIN(TestScreenCastPacer)
+#include "test_screencastpacer.moc"
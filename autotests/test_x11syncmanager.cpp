@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "x11syncmanager.h"
+#include "performancemonitor.h"
+
+#include <QTest>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+// A fence that is signaled when the test says so, without talking to the X server
+class FakeSyncObject : public X11SyncObject
+{
+public:
+    FakeSyncObject()
+        : X11SyncObject(Unmanaged())
+    {
+    }
+
+    void trigger() override
+    {
+        QVERIFY(m_state == Ready);
+        m_state = TriggerSent;
+        m_triggerTime = std::chrono::steady_clock::now();
+    }
+    void wait() override
+    {
+        if (m_state == TriggerSent) {
+            m_state = Waiting;
+        }
+    }
+    bool isSignaled() override
+    {
+        if (m_state == Done) {
+            return true;
+        }
+        if (!signaled) {
+            return false;
+        }
+        m_state = Done;
+        return true;
+    }
+    void reset() override
+    {
+        m_state = Resetting;
+    }
+    bool pollResetting() override
+    {
+        m_state = Ready;
+        signaled = false;
+        return true;
+    }
+
+    // pretends the fence has been triggered @p age ago
+    void age(std::chrono::milliseconds age)
+    {
+        m_triggerTime -= age;
+    }
+
+    bool signaled = false;
+};
+
+class TestX11SyncManager : public QObject
+{
+    Q_OBJECT
+public:
+    TestX11SyncManager();
+private Q_SLOTS:
+    void testSignaledFencesAreReused();
+    void testRingGrowsWhileBusy();
+    void testStuckFenceTimesOut();
+};
+
+TestX11SyncManager::TestX11SyncManager()
+{
+    PerformanceMonitor::create(this);
+}
+
+void TestX11SyncManager::testSignaledFencesAreReused()
+{
+    QVector<FakeSyncObject *> fences;
+    X11SyncManager manager([&fences]() {
+        fences.append(new FakeSyncObject);
+        return fences.last();
+    });
+    QCOMPARE(manager.fenceCount(), int(X11SyncManager::MinFences));
+
+    // the X server keeps up, so the ring doesn't need to grow
+    for (int i = 0; i < 3 * X11SyncManager::MinFences; ++i) {
+        QCOMPARE(manager.triggerFence(), X11SyncManager::TriggerResult::Triggered);
+        manager.insertWait();
+        QVERIFY(manager.endFrame());
+        for (FakeSyncObject *fence : qAsConst(fences)) {
+            fence->signaled = true;
+        }
+    }
+    QCOMPARE(manager.fenceCount(), int(X11SyncManager::MinFences));
+}
+
+void TestX11SyncManager::testRingGrowsWhileBusy()
+{
+    X11SyncManager manager([]() {
+        return new FakeSyncObject;
+    });
+
+    // no fence is ever signaled, every frame takes a new one until the ring is full
+    for (int i = 0; i < X11SyncManager::MaxFences; ++i) {
+        QCOMPARE(manager.triggerFence(), X11SyncManager::TriggerResult::Triggered);
+        QVERIFY(manager.endFrame());
+    }
+    QCOMPARE(manager.fenceCount(), int(X11SyncManager::MaxFences));
+    QCOMPARE(manager.triggerFence(), X11SyncManager::TriggerResult::Busy);
+    QCOMPARE(manager.triggerFence(), X11SyncManager::TriggerResult::Busy);
+}
+
+void TestX11SyncManager::testStuckFenceTimesOut()
+{
+    QVector<FakeSyncObject *> fences;
+    X11SyncManager manager([&fences]() {
+        fences.append(new FakeSyncObject);
+        return fences.last();
+    });
+
+    // fill the ring with fences that never get signaled
+    for (int i = 0; i < X11SyncManager::MaxFences; ++i) {
+        QCOMPARE(manager.triggerFence(), X11SyncManager::TriggerResult::Triggered);
+        QVERIFY(manager.endFrame());
+    }
+    QCOMPARE(manager.triggerFence(), X11SyncManager::TriggerResult::Busy);
+
+    // from now on every frame is skipped, so endFrame() is not called anymore and the
+    // timeout has to be reported by triggerFence() itself
+    for (FakeSyncObject *fence : qAsConst(fences)) {
+        fence->age(2s);
+    }
+    QCOMPARE(manager.triggerFence(), X11SyncManager::TriggerResult::TimedOut);
+    QCOMPARE(manager.triggerFence(), X11SyncManager::TriggerResult::TimedOut);
+}
+
+QTEST_GUILESS_MAIN(TestX11SyncManager)
+#include "test_x11syncmanager.moc"
@@ -17,8 +17,10 @@ class XkbTest : public QObject
 {
     Q_OBJECT
 private Q_SLOTS:
+    void initTestCase();
     void testToQtKey_data();
     void testToQtKey();
+    void testKeymapCache();
 };
 
 // from kwindowsystem/src/platforms/xcb/kkeyserver.cpp
@@ -461,6 +463,12 @@ static const TransKey g_rgQtToSymX[] = {
     { Qt::Key_9, XKB_KEY_KP_9, Qt::KeypadModifier }
 };
 
+void XkbTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/xkb")).removeRecursively();
+}
+
 void XkbTest::testToQtKey_data()
 {
     QTest::addColumn<Qt::Key>("qt");
@@ -478,5 +486,37 @@ void XkbTest::testToQtKey()
     QTEST(xkb.toQtKey(keySym), "qt");
 }
 
+void XkbTest::testKeymapCache()
+{
+    // a compiled keymap is stored on disk and is loaded from there by the next instance
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    KConfigGroup layout = config->group("Layout");
+    layout.writeEntry("LayoutList", QStringLiteral("de,us"));
+    layout.writeEntry("VariantList", QStringLiteral("neo,"));
+
+    const QDir cacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/xkb"));
+
+    Xkb compiled;
+    compiled.setConfig(config);
+    compiled.reconfigure();
+    QVERIFY(compiled.keymap());
+    QCOMPARE(compiled.numberOfLayouts(), 2u);
+    QCOMPARE(cacheDirectory.entryList({QStringLiteral("*.xkb")}, QDir::Files).count(), 1);
+
+    // the same rules are not compiled again
+    xkb_keymap *keymap = compiled.keymap();
+    compiled.reconfigure();
+    QCOMPARE(compiled.keymap(), keymap);
+
+    Xkb cached;
+    cached.setConfig(config);
+    cached.reconfigure();
+    QVERIFY(cached.keymap());
+    QCOMPARE(cached.numberOfLayouts(), 2u);
+    QCOMPARE(cached.layoutName(0), compiled.layoutName(0));
+    QCOMPARE(cached.layoutName(1), compiled.layoutName(1));
+    QCOMPARE(cacheDirectory.entryList({QStringLiteral("*.xkb")}, QDir::Files).count(), 1);
+}
+
 QTEST_MAIN(XkbTest)
 #include "test_xkb.moc"
@@ -5,6 +5,7 @@
 */
 
 #include "fakeinputdevice.h"
+#include "inputlatencytracker.h"
 
 #include <unistd.h>
 #include "workspace.h"
@@ -32,30 +33,35 @@ FakeInputDevice::FakeInputDevice(KWaylandServer::FakeInputDevice *device, QObjec
     );
     connect(device, &KWaylandServer::FakeInputDevice::pointerMotionRequested, this,
         [this] (const QSizeF &delta) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             Q_EMIT pointerMotion(delta, delta, 0, 0, this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::pointerMotionAbsoluteRequested, this,
         [this] (const QPointF &pos) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             Q_EMIT pointerMotionAbsolute(pos, 0, this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::pointerButtonPressRequested, this,
         [this] (quint32 button) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             Q_EMIT pointerButtonChanged(button, InputRedirection::PointerButtonPressed, 0, this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::pointerButtonReleaseRequested, this,
         [this] (quint32 button) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             Q_EMIT pointerButtonChanged(button, InputRedirection::PointerButtonReleased, 0, this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::pointerAxisRequested, this,
         [this] (Qt::Orientation orientation, qreal delta) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             InputRedirection::PointerAxis axis;
             switch (orientation) {
@@ -124,40 +130,47 @@ FakeInputDevice::FakeInputDevice(KWaylandServer::FakeInputDevice *device, QObjec
     );
     connect(device, &KWaylandServer::FakeInputDevice::touchDownRequested, this,
         [this] (qint32 id, const QPointF &pos) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             Q_EMIT touchDown(id, pos, 0, this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::touchMotionRequested, this,
         [this] (qint32 id, const QPointF &pos) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             Q_EMIT touchMotion(id, pos, 0, this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::touchUpRequested, this,
         [this] (qint32 id) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             Q_EMIT touchUp(id, 0, this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::touchCancelRequested, this,
         [this] () {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             Q_EMIT touchCanceled(this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::touchFrameRequested, this,
         [this] () {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             Q_EMIT touchFrame(this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::keyboardKeyPressRequested, this,
         [this] (quint32 button) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             Q_EMIT keyChanged(button, InputRedirection::KeyboardKeyPressed, 0, this);
         }
     );
     connect(device, &KWaylandServer::FakeInputDevice::keyboardKeyReleaseRequested, this,
         [this] (quint32 button) {
+            InputLatencyTracker::Scope latencyScope(this, InputLatencyTracker::currentTimestamp());
             // TODO: Fix time
             Q_EMIT keyChanged(button, InputRedirection::KeyboardKeyReleased, 0, this);
         }
@@ -21,6 +21,7 @@
 #endif
 
 #include "input_event.h"
+#include "inputlatencytracker.h"
 #include "session.h"
 #include "udev.h"
 #include "libinput_logging.h"
@@ -183,10 +184,12 @@ void Connection::handleEvent()
     const bool wasEmpty = m_eventQueue.isEmpty();
     do {
         m_input->dispatch();
+        const std::chrono::nanoseconds timestamp = InputLatencyTracker::currentTimestamp();
         Event *event = m_input->event();
         if (!event) {
             break;
         }
+        event->setReadTimestamp(timestamp);
         m_eventQueue << event;
     } while (true);
     if (wasEmpty && !m_eventQueue.isEmpty()) {
@@ -284,6 +287,9 @@ void Connection::processEvents()
     QMutexLocker locker(&m_mutex);
     while (!m_eventQueue.isEmpty()) {
         QScopedPointer<Event> event(m_eventQueue.takeFirst());
+        // device hotplug is not input, everything else is dispatched within a latency scope
+        const bool isInput = event->type() != LIBINPUT_EVENT_DEVICE_ADDED && event->type() != LIBINPUT_EVENT_DEVICE_REMOVED;
+        InputLatencyTracker::Scope latencyScope(isInput ? event->device() : nullptr, event->readTimestamp());
         switch (event->type()) {
             case LIBINPUT_EVENT_DEVICE_ADDED: {
                 auto device = new Device(event->nativeDevice());
@@ -13,6 +13,8 @@
 
 #include <libinput.h>
 
+#include <chrono>
+
 namespace KWin
 {
 namespace LibInput
@@ -29,6 +31,16 @@ public:
     Device *device() const;
     libinput_device *nativeDevice() const;
 
+    /**
+     * The time the event has been read from libinput, used to measure input latency.
+     */
+    std::chrono::nanoseconds readTimestamp() const {
+        return m_readTimestamp;
+    }
+    void setReadTimestamp(std::chrono::nanoseconds timestamp) {
+        m_readTimestamp = timestamp;
+    }
+
     operator libinput_event*() {
         return m_event;
     }
@@ -45,6 +57,7 @@ private:
     libinput_event *m_event;
     libinput_event_type m_type;
     mutable Device *m_device;
+    std::chrono::nanoseconds m_readTimestamp = std::chrono::nanoseconds::zero();
 };
 
 class KeyEvent : public Event
@@ -34,7 +34,9 @@ QImage *VirtualQPainterBackend::bufferForScreen(AbstractOutput *output)
 
 QRegion VirtualQPainterBackend::beginFrame(AbstractOutput *output)
 {
-    return output->geometry();
+    Q_UNUSED(output)
+    // the back buffer is never swapped, it always holds the previous frame
+    return QRegion();
 }
 
 void VirtualQPainterBackend::createOutputs()
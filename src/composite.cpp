@@ -17,9 +17,11 @@
 #include "internal_client.h"
 #include "openglbackend.h"
 #include "overlaywindow.h"
+#include "performancemonitor.h"
 #include "platform.h"
 #include "qpainterbackend.h"
 #include "renderloop.h"
+#include "renderloop_p.h"
 #include "scene.h"
 #include "scenes/opengl/scene_opengl.h"
 #include "scenes/qpainter/scene_qpainter.h"
@@ -150,6 +152,7 @@ Compositor::Compositor(QObject* workspace)
 
     // register DBus
     new CompositorDBusInterface(this);
+    new PerformanceDBusInterface(PerformanceMonitor::create(this));
     FTraceLogger::create();
 }
 
@@ -403,6 +406,7 @@ void Compositor::registerRenderLoop(RenderLoop *renderLoop, AbstractOutput *outp
 {
     Q_ASSERT(!m_renderLoops.contains(renderLoop));
     m_renderLoops.insert(renderLoop, output);
+    RenderLoopPrivate::get(renderLoop)->statistics = PerformanceMonitor::self()->frameStatistics(output ? output->name() : QStringLiteral("X11"));
     connect(renderLoop, &RenderLoop::frameRequested, this, &Compositor::handleFrameRequested);
 }
 
@@ -410,6 +414,7 @@ void Compositor::unregisterRenderLoop(RenderLoop *renderLoop)
 {
     Q_ASSERT(m_renderLoops.contains(renderLoop));
     m_renderLoops.remove(renderLoop);
+    RenderLoopPrivate::get(renderLoop)->statistics = nullptr;
     disconnect(renderLoop, &RenderLoop::frameRequested, this, &Compositor::handleFrameRequested);
 }
 
@@ -630,9 +635,14 @@ void Compositor::composite(RenderLoop *renderLoop)
     const auto windows = windowsToRender();
 
     const QRegion repaints = m_scene->repaints(output);
+    const QRegion cursorRepaints = m_scene->cursorRepaints(output);
     m_scene->resetRepaints(output);
 
-    m_scene->paint(output, repaints, windows, renderLoop);
+    // moving the pointer alone doesn't need to go through the scene and the effects
+    if (!repaints.isEmpty() || cursorRepaints.isEmpty()
+            || !m_scene->paintCursorOnly(output, cursorRepaints, windows, renderLoop)) {
+        m_scene->paint(output, repaints | cursorRepaints, windows, renderLoop);
+    }
 
     if (waylandServer()) {
         const std::chrono::milliseconds frameTime =
@@ -811,6 +821,7 @@ void X11Compositor::start()
 void X11Compositor::stop()
 {
     m_syncManager.reset();
+    m_frameSkipped = false;
     Compositor::stop();
 }
 
@@ -833,9 +844,23 @@ void X11Compositor::composite(RenderLoop *renderLoop)
         }
     }
 
-    if (dirtyItems.count() > 0) {
+    // The damage held back by a skipped frame has to be fenced as well, even if no
+    // window got damaged since
+    bool skipFrame = false;
+    if (dirtyItems.count() > 0 || m_frameSkipped) {
         if (m_syncManager) {
-            m_syncManager->triggerFence();
+            switch (m_syncManager->triggerFence()) {
+            case X11SyncManager::TriggerResult::Triggered:
+                break;
+            case X11SyncManager::TriggerResult::Busy:
+                skipFrame = true;
+                break;
+            case X11SyncManager::TriggerResult::TimedOut:
+                qCDebug(KWIN_CORE) << "Aborting explicit synchronization with the X command stream.";
+                qCDebug(KWIN_CORE) << "Future frames will be rendered unsynchronized.";
+                m_syncManager.reset();
+                break;
+            }
         }
         xcb_flush(kwinApp()->x11Connection());
     }
@@ -845,6 +870,16 @@ void X11Compositor::composite(RenderLoop *renderLoop)
         item->waitForDamage();
     }
 
+    m_frameSkipped = skipFrame;
+    if (skipFrame) {
+        // The X server hasn't caught up with the previous frames yet. Rather than waiting
+        // for it, keep the damage and try again on the next vblank.
+        QMetaObject::invokeMethod(renderLoop, [renderLoop]() {
+            renderLoop->scheduleRepaint();
+        }, Qt::QueuedConnection);
+        return;
+    }
+
     if (m_framesToTestForSafety > 0 && (backend()->compositingType() & OpenGLCompositing)) {
         kwinApp()->platform()->createOpenGLSafePoint(Platform::OpenGLSafePoint::PreFrame);
     }
@@ -243,6 +243,7 @@ public Q_SLOTS:
 private:
     explicit X11Compositor(QObject *parent);
     QScopedPointer<X11SyncManager> m_syncManager;
+    bool m_frameSkipped = false;
     /**
      * Whether the Compositor is currently suspended, 8 bits encoding the reason
      */
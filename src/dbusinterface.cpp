@@ -10,6 +10,7 @@
 // own
 #include "dbusinterface.h"
 #include "compositingadaptor.h"
+#include "performanceadaptor.h"
 #include "pluginsadaptor.h"
 #include "virtualdesktopmanageradaptor.h"
 
@@ -20,6 +21,7 @@
 #include "cursor.h"
 #include "debug_console.h"
 #include "main.h"
+#include "performancemonitor.h"
 #include "placement.h"
 #include "platform.h"
 #include "pluginmanager.h"
@@ -587,6 +589,47 @@ void VirtualDesktopManagerDBusInterface::removeDesktop(const QString &id)
     m_manager->removeVirtualDesktop(id);
 }
 
+PerformanceDBusInterface::PerformanceDBusInterface(PerformanceMonitor *parent)
+    : QObject(parent)
+    , m_monitor(parent)
+{
+    new PerformanceAdaptor(this);
+    QDBusConnection::sessionBus().registerObject(QStringLiteral("/Performance"), this);
+}
+
+bool PerformanceDBusInterface::isEffectProfiling() const
+{
+    return m_monitor->isEffectProfilingEnabled();
+}
+
+void PerformanceDBusInterface::setEffectProfiling(bool enabled)
+{
+    if (m_effectProfiling == enabled) {
+        return;
+    }
+    m_effectProfiling = enabled;
+    if (enabled) {
+        m_monitor->beginEffectProfiling();
+    } else {
+        m_monitor->endEffectProfiling();
+    }
+}
+
+QVariantMap PerformanceDBusInterface::snapshot()
+{
+    return m_monitor->snapshot();
+}
+
+QVariantMap PerformanceDBusInterface::takeSnapshot()
+{
+    return m_monitor->snapshot(true);
+}
+
+void PerformanceDBusInterface::reset()
+{
+    m_monitor->reset();
+}
+
 PluginManagerDBusInterface::PluginManagerDBusInterface(PluginManager *manager)
     : QObject(manager)
     , m_manager(manager)
@@ -19,6 +19,7 @@ namespace KWin
 {
 
 class Compositor;
+class PerformanceMonitor;
 class PluginManager;
 class VirtualDesktopManager;
 
@@ -209,6 +210,61 @@ private:
     Compositor *m_compositor;
 };
 
+/**
+ * @brief Exports the counters of the PerformanceMonitor as the org.deepin.KWin.Performance
+ * D-Bus interface on the object /Performance.
+ *
+ * A snapshot is a map with the following entries:
+ * @li @c interval nanoseconds since the counters were reset
+ * @li @c outputs frame time histograms, missed vblanks and direct scanout rate per output
+ * @li @c effects cumulative time spent in the paint hooks per effect, in nanoseconds
+ * @li @c inputLatency input to presentation latency histograms per input device
+ * @li @c textures number and estimated size of the textures allocated by the compositor
+ */
+class PerformanceDBusInterface : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.KWin.Performance")
+
+    /**
+     * @brief Whether the window hooks of effects are measured too, including their GPU time.
+     *
+     * Unless it is enabled, the time effects spend in window hooks is accounted to the
+     * entry named "scene".
+     */
+    Q_PROPERTY(bool effectProfiling READ isEffectProfiling WRITE setEffectProfiling)
+
+public:
+    explicit PerformanceDBusInterface(PerformanceMonitor *parent);
+    ~PerformanceDBusInterface() override = default;
+
+    bool isEffectProfiling() const;
+    void setEffectProfiling(bool enabled);
+
+public Q_SLOTS:
+    /**
+     * @brief Returns all counters collected since the last reset.
+     */
+    QVariantMap snapshot();
+
+    /**
+     * @brief Returns all counters collected since the last reset and resets them.
+     *
+     * Counters are cleared while they are read, so polling this method does not lose
+     * samples between two calls.
+     */
+    QVariantMap takeSnapshot();
+
+    /**
+     * @brief Resets all counters.
+     */
+    void reset();
+
+private:
+    PerformanceMonitor *m_monitor;
+    bool m_effectProfiling = false;
+};
+
 //TODO: disable all of this in case of kiosk?
 
 class VirtualDesktopManagerDBusInterface : public QObject
@@ -13,6 +13,7 @@
 #include "internal_client.h"
 #include "keyboard_input.h"
 #include "main.h"
+#include "performancemonitor.h"
 #include "scene.h"
 #include "unmanaged.h"
 #include "utils/subsurfacemonitor.h"
@@ -22,6 +23,7 @@
 #include "x11client.h"
 #include <deepin_kwinglplatform.h>
 #include <deepin_kwinglutils.h>
+#include <algorithm>
 #include <cerrno>
 
 #include "ui_debug_console.h"
@@ -619,6 +621,10 @@ DebugConsole::DebugConsole()
                 m_inputFilter.reset(new DebugConsoleFilter(m_ui->inputTextEdit));
                 input()->installInputEventSpy(m_inputFilter.data());
             }
+            // effect profiling is expensive, only enable it while someone is looking
+            if (index == 7 && !m_ui->effectsView->model()) {
+                m_ui->effectsView->setModel(new EffectCostModel(this));
+            }
             if (index == 5) {
                 updateKeyboardTab();
                 connect(input(), &InputRedirection::keyStateChanged, this, &DebugConsole::updateKeyboardTab);
@@ -1630,6 +1636,106 @@ int DataSourceModel::rowCount(const QModelIndex &parent) const
     return 0;
 }
 
+EffectCostModel::EffectCostModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+    if (PerformanceMonitor *monitor = PerformanceMonitor::self()) {
+        monitor->beginEffectProfiling();
+    }
+    m_timer.setInterval(1000);
+    connect(&m_timer, &QTimer::timeout, this, &EffectCostModel::update);
+    m_timer.start();
+    update();
+}
+
+EffectCostModel::~EffectCostModel()
+{
+    if (PerformanceMonitor *monitor = PerformanceMonitor::self()) {
+        monitor->endEffectProfiling();
+    }
+}
+
+int EffectCostModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 3;
+}
+
+int EffectCostModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_entries.count();
+}
+
+QVariant EffectCostModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::ParentIsInvalid | CheckIndexOption::IndexIsValid)) {
+        return QVariant();
+    }
+    const Entry &entry = m_entries.at(index.row());
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case 0:
+            return entry.name;
+        case 1:
+            return i18nc("Time spent per second", "%1 ms/s", QString::number(entry.cpuLoad, 'f', 2));
+        case 2:
+            return i18nc("Time spent per second", "%1 ms/s", QString::number(entry.gpuLoad, 'f', 2));
+        }
+    }
+    return QVariant();
+}
+
+QVariant EffectCostModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QVariant();
+    }
+    switch (section) {
+    case 0:
+        return i18nc("@title:column", "Effect");
+    case 1:
+        return i18nc("@title:column", "CPU");
+    case 2:
+        return i18nc("@title:column", "GPU");
+    default:
+        return QVariant();
+    }
+}
+
+void EffectCostModel::update()
+{
+    PerformanceMonitor *monitor = PerformanceMonitor::self();
+    if (!monitor) {
+        return;
+    }
+    const qreal seconds = m_interval.isValid() ? m_interval.restart() / 1000.0 : 0;
+    if (!m_interval.isValid()) {
+        m_interval.start();
+    }
+
+    const QVector<EffectCost> costs = monitor->effectCosts();
+    QVector<Entry> entries;
+    entries.reserve(costs.count());
+    for (const EffectCost &cost : costs) {
+        const EffectCost previous = m_previousCosts.value(cost.name);
+        m_previousCosts.insert(cost.name, cost);
+        if (seconds <= 0) {
+            continue;
+        }
+        // the counters go backwards when they are reset over D-Bus
+        const auto cpuTime = std::max(std::chrono::nanoseconds::zero(), cost.cpuTime - previous.cpuTime);
+        const auto gpuTime = std::max(std::chrono::nanoseconds::zero(), cost.gpuTime - previous.gpuTime);
+        entries.append(Entry{cost.name, cpuTime.count() / 1e6 / seconds, gpuTime.count() / 1e6 / seconds});
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.cpuLoad + a.gpuLoad > b.cpuLoad + b.gpuLoad;
+    });
+
+    beginResetModel();
+    m_entries = entries;
+    endResetModel();
+}
+
 QVariant DataSourceModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
     if (role != Qt::DisplayRole || orientation != Qt::Horizontal || section >= 2) {
@@ -10,12 +10,15 @@
 #define KWIN_DEBUG_CONSOLE_H
 
 #include <deepin_kwin_export.h>
+#include <deepin_kwineffectsex.h>
 #include <config-kwin.h>
 #include "input.h"
 #include "input_event_spy.h"
 
 #include <QAbstractItemModel>
+#include <QElapsedTimer>
 #include <QStyledItemDelegate>
+#include <QTimer>
 #include <QVector>
 #include <functional>
 
@@ -184,6 +187,37 @@ private:
     QList<InputDevice *> m_devices;
 };
 
+/**
+ * Lists the cost of the paint hooks of every effect over the last second. Effect profiling
+ * is enabled for as long as the model exists.
+ */
+class EffectCostModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit EffectCostModel(QObject *parent = nullptr);
+    ~EffectCostModel() override;
+
+    int columnCount(const QModelIndex &parent) const override;
+    int rowCount(const QModelIndex &parent) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    void update();
+
+    struct Entry
+    {
+        QString name;
+        qreal cpuLoad;
+        qreal gpuLoad;
+    };
+    QVector<Entry> m_entries;
+    QHash<QString, EffectCost> m_previousCosts;
+    QElapsedTimer m_interval;
+    QTimer m_timer;
+};
+
 class DataSourceModel : public QAbstractItemModel
 {
 public:
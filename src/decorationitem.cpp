@@ -87,6 +87,11 @@ void DecorationRenderer::setDevicePixelRatio(qreal dpr)
     }
 }
 
+QPoint DecorationRenderer::textureOrigin() const
+{
+    return QPoint(0, 0);
+}
+
 QImage DecorationRenderer::renderToImage(const QRect &geo)
 {
     Q_ASSERT(m_client);
@@ -142,6 +147,8 @@ DecorationItem::DecorationItem(KDecoration2::Decoration *decoration, AbstractCli
 
     connect(renderer(), &DecorationRenderer::damaged,
             this, &DecorationItem::scheduleRepaint);
+    connect(renderer(), &DecorationRenderer::textureOriginChanged,
+            this, &DecorationItem::discardQuads);
 
     setSize(window->size());
     handleOutputChanged();
@@ -254,10 +261,10 @@ WindowQuadList DecorationItem::buildQuads() const
     const int bottomHeight = std::ceil(bottom.height() * devicePixelRatio);
     const int leftWidth = std::ceil(left.width() * devicePixelRatio);
 
-    const QPoint topPosition(0, 0);
-    const QPoint bottomPosition(0, topPosition.y() + topHeight + (2 * texturePad));
-    const QPoint leftPosition(0, bottomPosition.y() + bottomHeight + (2 * texturePad));
-    const QPoint rightPosition(0, leftPosition.y() + leftWidth + (2 * texturePad));
+    const QPoint topPosition = m_renderer->textureOrigin();
+    const QPoint bottomPosition(topPosition.x(), topPosition.y() + topHeight + (2 * texturePad));
+    const QPoint leftPosition(topPosition.x(), bottomPosition.y() + bottomHeight + (2 * texturePad));
+    const QPoint rightPosition(topPosition.x(), leftPosition.y() + leftWidth + (2 * texturePad));
 
     WindowQuadList list;
     if (left.isValid()) {
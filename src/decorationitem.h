@@ -42,11 +42,18 @@ public:
     qreal devicePixelRatio() const;
     void setDevicePixelRatio(qreal dpr);
 
+    /**
+     * Returns the position of the decoration parts inside the renderer's texture. It is
+     * not at the origin if several decorations share one texture.
+     */
+    virtual QPoint textureOrigin() const;
+
     // Reserve some space for padding. We pad decoration parts to avoid texture bleeding.
     static const int TexturePad = 1;
 
 Q_SIGNALS:
     void damaged(const QRegion &region);
+    void textureOriginChanged();
 
 protected:
     explicit DecorationRenderer(Decoration::DecoratedClientImpl *client);
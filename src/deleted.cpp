@@ -11,16 +11,75 @@
 
 #include "workspace.h"
 #include "abstract_client.h"
+#include "effects.h"
 #include "group.h"
 #include "netinfo.h"
 #include "shadow.h"
+#include "surfaceitem.h"
 #include "virtualdesktops.h"
 
 #include <QDebug>
+#include <QTimer>
 
 namespace KWin
 {
 
+static quint64 s_retainedSnapshotCount = 0;
+static quint64 s_retainedSnapshotBytes = 0;
+static quint64 s_droppedSnapshotCount = 0;
+static bool s_memoryBudgetCheckScheduled = false;
+// deleted windows that no effect painted for this long are not animated anymore
+static const std::chrono::milliseconds s_paintGracePeriod(500);
+
+/**
+ * The budget for the contents of deleted windows, in bytes. It can be overridden with
+ * the KWIN_DELETED_MEMORY_BUDGET environment variable, in MiB.
+ **/
+static quint64 memoryBudget()
+{
+    static const quint64 budget = [] {
+        bool ok = false;
+        const int megabytes = qEnvironmentVariableIntValue("KWIN_DELETED_MEMORY_BUDGET", &ok);
+        return quint64(ok && megabytes >= 0 ? megabytes : 256) << 20;
+    }();
+    return budget;
+}
+
+static quint64 pixmapBytes(const SurfacePixmap *pixmap)
+{
+    return quint64(pixmap->size().width()) * pixmap->size().height() * 4;
+}
+
+static quint64 surfaceBytes(SurfaceItem *item)
+{
+    quint64 bytes = 0;
+    SurfacePixmap *pixmap = item->pixmap();
+    if (pixmap) {
+        bytes += pixmapBytes(pixmap);
+    }
+    if (SurfacePixmap *previous = item->previousPixmap(); previous && previous != pixmap) {
+        bytes += pixmapBytes(previous);
+    }
+    const QList<Item *> children = item->childItems();
+    for (Item *child : children) {
+        if (SurfaceItem *surfaceItem = qobject_cast<SurfaceItem *>(child)) {
+            bytes += surfaceBytes(surfaceItem);
+        }
+    }
+    return bytes;
+}
+
+static void releaseSurfacePixmaps(SurfaceItem *item)
+{
+    item->releasePixmaps();
+    const QList<Item *> children = item->childItems();
+    for (Item *child : children) {
+        if (SurfaceItem *surfaceItem = qobject_cast<SurfaceItem *>(child)) {
+            releaseSurfacePixmaps(surfaceItem);
+        }
+    }
+}
+
 Deleted::Deleted()
     : Toplevel()
     , delete_refcount(1)
@@ -48,6 +107,7 @@ Deleted::~Deleted()
     if (workspace()) {
         workspace()->removeDeleted(this);
     }
+    releaseSnapshot();
     deleteEffectWindow();
     deleteShadow();
 }
@@ -56,10 +116,113 @@ Deleted* Deleted::create(Toplevel* c)
 {
     Deleted* d = new Deleted();
     d->copyToDeleted(c);
+    d->m_lastPainted = std::chrono::steady_clock::now();
     workspace()->addDeleted(d, c);
+    if (SurfaceItem *item = d->surfaceItem()) {
+        d->m_hasSnapshot = true;
+        d->m_retainedBytes = surfaceBytes(item);
+        s_retainedSnapshotCount++;
+        s_retainedSnapshotBytes += d->m_retainedBytes;
+        enforceMemoryBudget();
+    }
     return d;
 }
 
+void Deleted::markAsPainted()
+{
+    m_lastPainted = std::chrono::steady_clock::now();
+}
+
+quint64 Deleted::retainedSnapshotCount()
+{
+    return s_retainedSnapshotCount;
+}
+
+quint64 Deleted::retainedSnapshotBytes()
+{
+    return s_retainedSnapshotBytes;
+}
+
+quint64 Deleted::droppedSnapshotCount()
+{
+    return s_droppedSnapshotCount;
+}
+
+void Deleted::releaseSnapshot()
+{
+    if (!m_hasSnapshot) {
+        return;
+    }
+    m_hasSnapshot = false;
+    s_retainedSnapshotCount--;
+    s_retainedSnapshotBytes -= m_retainedBytes;
+    m_retainedBytes = 0;
+}
+
+void Deleted::dropSnapshot()
+{
+    if (!m_hasSnapshot) {
+        return;
+    }
+    addWorkspaceRepaint(visibleGeometry());
+    if (SurfaceItem *item = surfaceItem()) {
+        releaseSurfacePixmaps(item);
+    }
+    m_internalFBO.reset();
+    m_internalImage = QImage();
+    ready_for_painting = false;
+    releaseSnapshot();
+}
+
+/**
+ * Closing many windows at once may keep the contents of all of them around. Once they
+ * exceed the memory budget, the oldest windows that no effect is animating anymore are
+ * dropped. A deleted window is only painted if an effect enables its painting, so the
+ * windows that are being animated out are the ones painted within the last frames, or
+ * the ones whose close animation has been grabbed.
+ *
+ * Windows closed in one go are all within their grace period at first, the budget is
+ * checked again once the first of them went unpainted for long enough.
+ **/
+void Deleted::enforceMemoryBudget()
+{
+    if (!workspace() || s_retainedSnapshotBytes <= memoryBudget()) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration nextCheck = std::chrono::steady_clock::duration::max();
+    const QList<Deleted *> deletedWindows = workspace()->deletedList();
+    for (Deleted *deleted : deletedWindows) {
+        if (s_retainedSnapshotBytes <= memoryBudget()) {
+            break;
+        }
+        if (!deleted->m_hasSnapshot) {
+            continue;
+        }
+        if (now - deleted->m_lastPainted < s_paintGracePeriod) {
+            nextCheck = std::min(nextCheck, deleted->m_lastPainted + s_paintGracePeriod - now);
+            continue;
+        }
+        const EffectWindowImpl *window = deleted->effectWindow();
+        if (window && window->data(WindowClosedGrabRole).isValid()) {
+            continue;
+        }
+        qCDebug(KWIN_CORE) << "Dropping the contents of" << deleted << "to stay within the memory budget";
+        deleted->dropSnapshot();
+        s_droppedSnapshotCount++;
+    }
+
+    if (s_retainedSnapshotBytes > memoryBudget() && nextCheck != std::chrono::steady_clock::duration::max()
+            && !s_memoryBudgetCheckScheduled) {
+        s_memoryBudgetCheckScheduled = true;
+        const auto interval = std::chrono::ceil<std::chrono::milliseconds>(nextCheck);
+        QTimer::singleShot(interval, workspace(), [] {
+            s_memoryBudgetCheckScheduled = false;
+            enforceMemoryBudget();
+        });
+    }
+}
+
 // to be used only from Workspace::finishCompositing()
 void Deleted::discard()
 {
@@ -117,8 +280,11 @@ void Deleted::copyToDeleted(Toplevel* c)
 
 void Deleted::unrefWindow()
 {
-    if (--delete_refcount > 0)
+    if (--delete_refcount > 0) {
+        // the window is still referenced, e.g. by a close animation
+        enforceMemoryBudget();
         return;
+    }
     // needs to be delayed
     // a) when calling from effects, otherwise it'd be rather complicated to handle the case of the
     // window going away during a painting pass
@@ -12,6 +12,8 @@
 
 #include "toplevel.h"
 
+#include <chrono>
+
 namespace KWin
 {
 
@@ -27,6 +29,31 @@ public:
     void refWindow();
     void unrefWindow();
     void discard();
+
+    /**
+     * Releases the window contents that were kept for the close animation. The window
+     * is not painted anymore afterwards.
+     */
+    void dropSnapshot();
+    /**
+     * Called by the scene whenever an effect enabled painting of the window.
+     */
+    void markAsPainted();
+    /**
+     * The size of the window contents kept for the close animation, in bytes.
+     */
+    quint64 retainedBytes() const {
+        return m_retainedBytes;
+    }
+    /**
+     * Returns the number of deleted windows whose contents are kept, and their size in bytes.
+     */
+    static quint64 retainedSnapshotCount();
+    static quint64 retainedSnapshotBytes();
+    /**
+     * Returns the number of snapshots dropped to stay within the memory budget.
+     */
+    static quint64 droppedSnapshotCount();
     QMargins frameMargins() const override;
     int desktop() const override;
     QStringList activities() const override;
@@ -103,6 +130,8 @@ private:
     Deleted();   // use create()
     void copyToDeleted(Toplevel* c);
     ~Deleted() override; // deleted only using unrefWindow()
+    void releaseSnapshot();
+    static void enforceMemoryBudget();
 
     QMargins m_frameMargins;
 
@@ -133,6 +162,9 @@ private:
     bool m_wasOutline;
     bool m_wasLockScreen;
     bool m_wasSwitcherWin;
+    quint64 m_retainedBytes = 0;
+    bool m_hasSnapshot = false;
+    std::chrono::steady_clock::time_point m_lastPainted;
 };
 
 inline void Deleted::refWindow()
@@ -20,8 +20,13 @@
 #include <KPackage/PackageLoader>
 // Qt
 #include <QtConcurrentRun>
+#include <QCoreApplication>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include <QFutureWatcher>
+#include <QJsonArray>
 #include <QStaticPlugin>
 #include <QStringList>
 
@@ -195,6 +200,7 @@ void ScriptedEffectLoader::clear()
 PluginEffectLoader::PluginEffectLoader(QObject *parent)
     : AbstractEffectLoader(parent)
     , m_pluginSubDirectory(QStringLiteral("deepin-kwin/effects/plugins"))
+    , m_queue(new EffectLoadQueue<PluginEffectLoader, KPluginMetaData>(this))
 {
 }
 
@@ -210,15 +216,54 @@ bool PluginEffectLoader::hasEffect(const QString &name) const
 
 KPluginMetaData PluginEffectLoader::findEffect(const QString &name) const
 {
-    const auto plugins = KPluginMetaData::findPlugins(m_pluginSubDirectory,
-        [name] (const KPluginMetaData &data) {
-            return data.pluginId().compare(name, Qt::CaseInsensitive) == 0;
-        }
-    );
-    if (plugins.isEmpty()) {
+    if (!m_indexValid) {
+        updateIndex();
+    }
+    auto it = m_effectIndex.constFind(name.toLower());
+    if (it == m_effectIndex.constEnd() && pluginDirectoriesState() != m_indexedDirectoriesState) {
+        // a plugin might have been installed since the index was built
+        updateIndex();
+        it = m_effectIndex.constFind(name.toLower());
+    }
+    if (it == m_effectIndex.constEnd()) {
         return KPluginMetaData();
     }
-    return plugins.first();
+    return m_effects.at(*it);
+}
+
+QStringList PluginEffectLoader::pluginDirectoriesState() const
+{
+    QStringList state;
+    const QStringList libraryPaths = QCoreApplication::libraryPaths();
+    for (const QString &libraryPath : libraryPaths) {
+        const QFileInfo info(libraryPath + QDir::separator() + m_pluginSubDirectory);
+        if (info.isDir()) {
+            state << info.filePath() + QLatin1Char('@') + QString::number(info.lastModified().toMSecsSinceEpoch());
+        }
+    }
+    return state;
+}
+
+void PluginEffectLoader::updateIndex() const
+{
+    m_indexedDirectoriesState = pluginDirectoriesState();
+    m_effects = KPluginMetaData::findPlugins(m_pluginSubDirectory);
+    m_effectIndex.clear();
+    m_effectIndex.reserve(m_effects.count());
+    for (int i = 0; i < m_effects.count(); ++i) {
+        // the first plugin with a given id wins, like it did when scanning for it
+        const QString id = m_effects.at(i).pluginId().toLower();
+        if (!m_effectIndex.contains(id)) {
+            m_effectIndex.insert(id, i);
+        }
+    }
+    m_indexValid = true;
+}
+
+static bool hasActivationTriggers(const KPluginMetaData &info)
+{
+    const QJsonObject effect = info.rawData().value(QStringLiteral("org.kde.kwin.effect")).toObject();
+    return !effect.value(QStringLiteral("activation")).toArray().isEmpty();
 }
 
 bool PluginEffectLoader::isEffectSupported(const QString &name) const
@@ -276,6 +321,21 @@ bool PluginEffectLoader::loadEffect(const QString &name)
 }
 
 bool PluginEffectLoader::loadEffect(const KPluginMetaData &info, LoadEffectFlags flags)
+{
+    if (!m_deferredEffects.remove(info.pluginId())) {
+        return createEffect(info, flags);
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const bool loaded = createEffect(info, flags);
+    m_deferredLoadTime += timer.elapsed();
+    if (m_deferredEffects.isEmpty()) {
+        qCDebug(KWIN_CORE) << "Deferred plugin effects took" << m_deferredLoadTime << "ms off the startup";
+    }
+    return loaded;
+}
+
+bool PluginEffectLoader::createEffect(const KPluginMetaData &info, LoadEffectFlags flags)
 {
     if (!info.isValid()) {
         qCDebug(KWIN_CORE) << "Plugin info is not valid";
@@ -329,27 +389,44 @@ bool PluginEffectLoader::loadEffect(const KPluginMetaData &info, LoadEffectFlags
 
 void PluginEffectLoader::queryAndLoadAll()
 {
+    const bool deferActivatable = qEnvironmentVariableIsSet("KWIN_EFFECTS_DEFERRED_LOADING");
+    QElapsedTimer timer;
+    timer.start();
+
     const auto effects = findAllEffects();
     for (const auto &effect : effects) {
         const LoadEffectFlags flags = readConfig(effect.pluginId(), effect.isEnabledByDefault());
-        if (flags.testFlag(LoadEffectFlag::Load)) {
+        if (!flags.testFlag(LoadEffectFlag::Load)) {
+            continue;
+        }
+        if (deferActivatable && hasActivationTriggers(effect)) {
+            m_deferredEffects.insert(effect.pluginId());
+            m_queue->enqueue(qMakePair(effect, flags));
+        } else {
             loadEffect(effect, flags);
         }
     }
+    qCDebug(KWIN_CORE) << "Loaded plugin effects in" << timer.elapsed() << "ms," << m_deferredEffects.count() << "deferred";
 }
 
 QVector<KPluginMetaData> PluginEffectLoader::findAllEffects() const
 {
-    return KPluginMetaData::findPlugins(m_pluginSubDirectory);
+    if (!m_indexValid || pluginDirectoriesState() != m_indexedDirectoriesState) {
+        updateIndex();
+    }
+    return m_effects;
 }
 
 void PluginEffectLoader::setPluginSubDirectory(const QString &directory)
 {
     m_pluginSubDirectory = directory;
+    m_indexValid = false;
 }
 
 void PluginEffectLoader::clear()
 {
+    m_queue->clear();
+    m_deferredEffects.clear();
 }
 
 EffectLoader::EffectLoader(QObject *parent)
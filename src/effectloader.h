@@ -15,10 +15,12 @@
 // Qt
 #include <QObject>
 #include <QFlags>
+#include <QHash>
 #include <QMap>
 #include <QPair>
 #include <QStaticPlugin>
 #include <QQueue>
+#include <QSet>
 
 namespace KWin
 {
@@ -294,6 +296,17 @@ private:
     QMetaObject::Connection m_queryConnection;
 };
 
+/**
+ * @brief Can load binary plugin Effects
+ *
+ * The metadata of all plugins is read once and kept in an index that is only refreshed if an
+ * effect can't be found and the plugin directories have changed since.
+ *
+ * If the environment variable KWIN_EFFECTS_DEFERRED_LOADING is set, effects that declare in
+ * their metadata that they are only activated by the user (e.g. through a shortcut) are not
+ * loaded during startup but queued until the compositor is running, unless they are loaded
+ * explicitly before.
+ */
 class PluginEffectLoader : public AbstractEffectLoader
 {
     Q_OBJECT
@@ -315,9 +328,20 @@ public:
 private:
     QVector<KPluginMetaData> findAllEffects() const;
     KPluginMetaData findEffect(const QString &name) const;
+    void updateIndex() const;
+    QStringList pluginDirectoriesState() const;
     EffectPluginFactory *factory(const KPluginMetaData &info) const;
+    bool createEffect(const KPluginMetaData &info, LoadEffectFlags flags);
     QStringList m_loadedEffects;
     QString m_pluginSubDirectory;
+    // metadata of all plugins, so that looking up an effect doesn't scan the plugin directories
+    mutable QVector<KPluginMetaData> m_effects;
+    mutable QHash<QString, int> m_effectIndex;
+    mutable QStringList m_indexedDirectoriesState;
+    mutable bool m_indexValid = false;
+    EffectLoadQueue<PluginEffectLoader, KPluginMetaData> *m_queue;
+    QSet<QString> m_deferredEffects;
+    qint64 m_deferredLoadTime = 0;
 };
 
 class KWIN_EXPORT EffectLoader : public AbstractEffectLoader
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "effectprofiler.h"
+
+#include <deepin_kwinglutils.h>
+
+namespace KWin
+{
+
+// results that are not available after this many frames are dropped
+static const int s_maxPendingGpuFrames = 4;
+
+EffectProfiler::EffectProfiler(bool gpuTiming)
+    : m_gpuTiming(gpuTiming)
+{
+}
+
+EffectProfiler::~EffectProfiler()
+{
+    if (!m_gpuTiming) {
+        return;
+    }
+    for (const GpuFrame &frame : qAsConst(m_pendingGpuFrames)) {
+        for (const GpuScope &scope : frame.scopes) {
+            m_freeQueries << scope.begin << scope.end;
+        }
+    }
+    for (const GpuScope &scope : qAsConst(m_gpuScopes)) {
+        m_freeQueries << scope.begin << scope.end;
+    }
+    if (!m_freeQueries.isEmpty()) {
+        glDeleteQueries(m_freeQueries.count(), m_freeQueries.constData());
+    }
+}
+
+void EffectProfiler::beginFrame()
+{
+    m_profiling = PerformanceMonitor::self() && PerformanceMonitor::self()->isEffectProfilingEnabled();
+    m_nestedTime = std::chrono::nanoseconds::zero();
+    if (!m_gpuTiming) {
+        return;
+    }
+    // the scopes of the previous pass have been closed by now
+    if (!m_gpuScopes.isEmpty()) {
+        m_pendingGpuFrames.append(GpuFrame{m_gpuScopes, m_lastQuery});
+        m_gpuScopes.clear();
+    }
+    m_currentGpuScope = -1;
+    collectGpuFrames();
+}
+
+GLuint EffectProfiler::allocateQuery()
+{
+    if (m_freeQueries.isEmpty()) {
+        m_freeQueries.resize(64);
+        glGenQueries(m_freeQueries.count(), m_freeQueries.data());
+    }
+    return m_freeQueries.takeLast();
+}
+
+int EffectProfiler::beginGpuScope(EffectStatistics *statistics, EffectStatistics::Hook hook)
+{
+    GpuScope scope{statistics, hook, allocateQuery(), 0, m_currentGpuScope, 0};
+    glQueryCounter(scope.begin, GL_TIMESTAMP);
+    m_gpuScopes.append(scope);
+    m_currentGpuScope = m_gpuScopes.count() - 1;
+    return m_currentGpuScope;
+}
+
+void EffectProfiler::endGpuScope(int index)
+{
+    GpuScope &scope = m_gpuScopes[index];
+    scope.end = allocateQuery();
+    glQueryCounter(scope.end, GL_TIMESTAMP);
+    m_lastQuery = scope.end;
+    m_currentGpuScope = scope.parent;
+}
+
+void EffectProfiler::collectGpuFrames()
+{
+    while (!m_pendingGpuFrames.isEmpty()) {
+        GpuFrame &pending = m_pendingGpuFrames.first();
+        QVector<GpuScope> &frame = pending.scopes;
+
+        // queries complete in order, so the one issued last tells whether the frame is done;
+        // that is the end query of the outermost scope to close, not of the last scope to begin
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(pending.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            // children are stored after their parent, walk backwards to subtract them
+            for (int i = frame.count() - 1; i >= 0; --i) {
+                GpuScope &scope = frame[i];
+                GLuint64 begin = 0;
+                GLuint64 end = 0;
+                glGetQueryObjectui64v(scope.begin, GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(scope.end, GL_QUERY_RESULT, &end);
+                const GLuint64 elapsed = end > begin ? end - begin : 0;
+                if (scope.parent != -1) {
+                    frame[scope.parent].childTime += elapsed;
+                }
+                scope.statistics->recordGpu(scope.hook, std::chrono::nanoseconds(elapsed > scope.childTime ? elapsed - scope.childTime : 0));
+            }
+        } else if (m_pendingGpuFrames.count() <= s_maxPendingGpuFrames) {
+            return;
+        }
+
+        for (const GpuScope &scope : qAsConst(frame)) {
+            m_freeQueries << scope.begin << scope.end;
+        }
+        m_pendingGpuFrames.removeFirst();
+    }
+}
+
+} // namespace KWin
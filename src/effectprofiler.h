@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include "performancemonitor.h"
+
+#include <QVector>
+
+#include <epoxy/gl.h>
+
+namespace KWin
+{
+
+/**
+ * The EffectProfiler class measures the cost of the effect hooks in the paint chain.
+ *
+ * The screen hooks are always measured. The window hooks are measured only while effect
+ * profiling is enabled in the PerformanceMonitor, until then a Scope is a null check. The
+ * cost of a hook excludes the time spent further down the chain, so that an effect that
+ * only forwards the call is not charged for the work of the scene.
+ *
+ * With OpenGL compositing, profiled hooks are also bracketed with timestamp queries. The
+ * results are collected a few frames later so that the CPU never waits for the GPU.
+ */
+class EffectProfiler
+{
+public:
+    explicit EffectProfiler(bool gpuTiming);
+    ~EffectProfiler();
+
+    /**
+     * Must be called at the start of a paint pass with the OpenGL context current.
+     */
+    void beginFrame();
+
+    bool isProfiling() const;
+
+    class Scope
+    {
+    public:
+        Scope(EffectProfiler *profiler, EffectStatistics *statistics, EffectStatistics::Hook hook);
+        ~Scope();
+
+    private:
+        EffectProfiler *m_profiler;
+        EffectStatistics *m_statistics;
+        EffectStatistics::Hook m_hook;
+        std::chrono::nanoseconds m_outerNestedTime;
+        std::chrono::steady_clock::time_point m_start;
+        int m_gpuScope = -1;
+    };
+
+private:
+    struct GpuScope
+    {
+        EffectStatistics *statistics;
+        EffectStatistics::Hook hook;
+        GLuint begin;
+        GLuint end;
+        int parent;
+        GLuint64 childTime;
+    };
+
+    struct GpuFrame
+    {
+        QVector<GpuScope> scopes;
+        // the query issued last, the frame is complete once its result is available
+        GLuint lastQuery;
+    };
+
+    int beginGpuScope(EffectStatistics *statistics, EffectStatistics::Hook hook);
+    void endGpuScope(int index);
+    GLuint allocateQuery();
+    void collectGpuFrames();
+
+    // time spent further down the chain by the innermost scope
+    std::chrono::nanoseconds m_nestedTime = std::chrono::nanoseconds::zero();
+    bool m_profiling = false;
+    bool m_gpuTiming;
+    int m_currentGpuScope = -1;
+    QVector<GpuScope> m_gpuScopes;
+    GLuint m_lastQuery = 0;
+    QVector<GpuFrame> m_pendingGpuFrames;
+    QVector<GLuint> m_freeQueries;
+};
+
+inline bool EffectProfiler::isProfiling() const
+{
+    return m_profiling;
+}
+
+inline EffectProfiler::Scope::Scope(EffectProfiler *profiler, EffectStatistics *statistics, EffectStatistics::Hook hook)
+    : m_profiler(profiler)
+    , m_statistics(statistics)
+    , m_hook(hook)
+{
+    if (!m_statistics) {
+        return;
+    }
+    m_outerNestedTime = m_profiler->m_nestedTime;
+    m_profiler->m_nestedTime = std::chrono::nanoseconds::zero();
+    if (m_profiler->m_profiling && m_profiler->m_gpuTiming) {
+        m_gpuScope = m_profiler->beginGpuScope(statistics, hook);
+    }
+    m_start = std::chrono::steady_clock::now();
+}
+
+inline EffectProfiler::Scope::~Scope()
+{
+    if (!m_statistics) {
+        return;
+    }
+    const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - m_start;
+    if (m_gpuScope != -1) {
+        m_profiler->endGpuScope(m_gpuScope);
+    }
+    m_statistics->record(m_hook, elapsed - m_profiler->m_nestedTime);
+    m_profiler->m_nestedTime = m_outerNestedTime + elapsed;
+}
+
+} // namespace KWin
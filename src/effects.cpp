@@ -21,6 +21,7 @@
 #include "cursor.h"
 #include "group.h"
 #include "internal_client.h"
+#include "effectprofiler.h"
 #include "osd.h"
 #include "pointer_input.h"
 #include "renderbackend.h"
@@ -35,6 +36,7 @@
 #include "virtualdesktops.h"
 #include "window_property_notify_x11_filter.h"
 #include "workspace.h"
+#include "deepin_kwinglplatform.h"
 #include "deepin_kwinglutils.h"
 #include "deepin_kwinoffscreenquickview.h"
 #include "splitmanage.h"
@@ -122,10 +124,19 @@ EffectsHandlerImpl::EffectsHandlerImpl(Compositor *compositor, Scene *scene)
     , m_trackingCursorChanges(0)
 {
     qRegisterMetaType<QVector<KWin::EffectWindow*>>();
+    const bool gpuTiming = isOpenGLCompositing() && !GLPlatform::instance()->isGLES()
+        && (hasGLVersion(3, 3) || hasGLExtension(QByteArrayLiteral("GL_ARB_timer_query")));
+    m_profiler = std::make_unique<EffectProfiler>(gpuTiming);
+    if (PerformanceMonitor *monitor = PerformanceMonitor::self()) {
+        m_sceneStatistics = monitor->effectStatistics(QStringLiteral("scene"));
+    }
     connect(m_effectLoader, &AbstractEffectLoader::effectLoaded, this,
         [this](Effect *effect, const QString &name) {
             effect_order.insert(effect->requestedEffectChainPosition(), EffectPair(name, effect));
             loaded_effects << EffectPair(name, effect);
+            if (PerformanceMonitor *monitor = PerformanceMonitor::self()) {
+                m_effectStatistics.insert(effect, monitor->effectStatistics(name));
+            }
             effectsChanged();
         }
     );
@@ -271,6 +282,9 @@ EffectsHandlerImpl::EffectsHandlerImpl(Compositor *compositor, Scene *scene)
 EffectsHandlerImpl::~EffectsHandlerImpl()
 {
     unloadAllEffects();
+
+    makeOpenGLContextCurrent();
+    m_profiler.reset();
 }
 
 void EffectsHandlerImpl::unloadAllEffects()
@@ -405,6 +419,7 @@ void EffectsHandlerImpl::reconfigure()
 void EffectsHandlerImpl::prePaintScreen(ScreenPrePaintData& data, std::chrono::milliseconds presentTime)
 {
     if (m_currentPaintScreenIterator != m_activeEffects.constEnd()) {
+        EffectProfiler::Scope scope(m_profiler.get(), effectStatistics(m_currentPaintScreenIterator), EffectStatistics::PrePaintScreen);
         (*m_currentPaintScreenIterator++)->prePaintScreen(data, presentTime);
         --m_currentPaintScreenIterator;
     }
@@ -414,10 +429,13 @@ void EffectsHandlerImpl::prePaintScreen(ScreenPrePaintData& data, std::chrono::m
 void EffectsHandlerImpl::paintScreen(int mask, const QRegion &region, ScreenPaintData& data)
 {
     if (m_currentPaintScreenIterator != m_activeEffects.constEnd()) {
+        EffectProfiler::Scope scope(m_profiler.get(), effectStatistics(m_currentPaintScreenIterator), EffectStatistics::PaintScreen);
         (*m_currentPaintScreenIterator++)->paintScreen(mask, region, data);
         --m_currentPaintScreenIterator;
-    } else
+    } else {
+        EffectProfiler::Scope scope(m_profiler.get(), m_sceneStatistics, EffectStatistics::PaintScreen);
         m_scene->finalPaintScreen(mask, region, data);
+    }
 }
 
 void EffectsHandlerImpl::paintDesktop(int desktop, int mask, QRegion region, ScreenPaintData &data)
@@ -439,6 +457,7 @@ void EffectsHandlerImpl::paintDesktop(int desktop, int mask, QRegion region, Scr
 void EffectsHandlerImpl::postPaintScreen()
 {
     if (m_currentPaintScreenIterator != m_activeEffects.constEnd()) {
+        EffectProfiler::Scope scope(m_profiler.get(), effectStatistics(m_currentPaintScreenIterator), EffectStatistics::PostPaintScreen);
         (*m_currentPaintScreenIterator++)->postPaintScreen();
         --m_currentPaintScreenIterator;
     }
@@ -448,6 +467,7 @@ void EffectsHandlerImpl::postPaintScreen()
 void EffectsHandlerImpl::prePaintWindow(EffectWindow* w, WindowPrePaintData& data, std::chrono::milliseconds presentTime)
 {
     if (m_currentPaintWindowIterator != m_activeEffects.constEnd()) {
+        EffectProfiler::Scope scope(m_profiler.get(), profiledEffectStatistics(m_currentPaintWindowIterator), EffectStatistics::PrePaintWindow);
         (*m_currentPaintWindowIterator++)->prePaintWindow(w, data, presentTime);
         --m_currentPaintWindowIterator;
     }
@@ -457,18 +477,23 @@ void EffectsHandlerImpl::prePaintWindow(EffectWindow* w, WindowPrePaintData& dat
 void EffectsHandlerImpl::paintWindow(EffectWindow* w, int mask, const QRegion &region, WindowPaintData& data)
 {
     if (m_currentPaintWindowIterator != m_activeEffects.constEnd()) {
+        EffectProfiler::Scope scope(m_profiler.get(), profiledEffectStatistics(m_currentPaintWindowIterator), EffectStatistics::PaintWindow);
         (*m_currentPaintWindowIterator++)->paintWindow(w, mask, region, data);
         --m_currentPaintWindowIterator;
-    } else
+    } else {
+        EffectProfiler::Scope scope(m_profiler.get(), profiledSceneStatistics(), EffectStatistics::PaintWindow);
         m_scene->finalPaintWindow(static_cast<EffectWindowImpl*>(w), mask, region, data);
+    }
 }
 
 void EffectsHandlerImpl::paintEffectFrame(EffectFrame* frame, const QRegion &region, double opacity, double frameOpacity)
 {
     if (m_currentPaintEffectFrameIterator != m_activeEffects.constEnd()) {
+        EffectProfiler::Scope scope(m_profiler.get(), profiledEffectStatistics(m_currentPaintEffectFrameIterator), EffectStatistics::PaintEffectFrame);
         (*m_currentPaintEffectFrameIterator++)->paintEffectFrame(frame, region, opacity, frameOpacity);
         --m_currentPaintEffectFrameIterator;
     } else {
+        EffectProfiler::Scope scope(m_profiler.get(), profiledSceneStatistics(), EffectStatistics::PaintEffectFrame);
         const EffectFrameImpl* frameImpl = static_cast<const EffectFrameImpl*>(frame);
         frameImpl->finalRender(region, opacity, frameOpacity);
     }
@@ -477,6 +502,7 @@ void EffectsHandlerImpl::paintEffectFrame(EffectFrame* frame, const QRegion &reg
 void EffectsHandlerImpl::postPaintWindow(EffectWindow* w)
 {
     if (m_currentPaintWindowIterator != m_activeEffects.constEnd()) {
+        EffectProfiler::Scope scope(m_profiler.get(), profiledEffectStatistics(m_currentPaintWindowIterator), EffectStatistics::PostPaintWindow);
         (*m_currentPaintWindowIterator++)->postPaintWindow(w);
         --m_currentPaintWindowIterator;
     }
@@ -494,10 +520,50 @@ Effect *EffectsHandlerImpl::provides(Effect::Feature ef)
 void EffectsHandlerImpl::drawWindow(EffectWindow* w, int mask, const QRegion &region, WindowPaintData& data)
 {
     if (m_currentDrawWindowIterator != m_activeEffects.constEnd()) {
+        EffectProfiler::Scope scope(m_profiler.get(), profiledEffectStatistics(m_currentDrawWindowIterator), EffectStatistics::DrawWindow);
         (*m_currentDrawWindowIterator++)->drawWindow(w, mask, region, data);
         --m_currentDrawWindowIterator;
-    } else
+    } else {
+        EffectProfiler::Scope scope(m_profiler.get(), profiledSceneStatistics(), EffectStatistics::DrawWindow);
         m_scene->finalDrawWindow(static_cast<EffectWindowImpl*>(w), mask, region, data);
+    }
+}
+
+EffectStatistics *EffectsHandlerImpl::effectStatistics(EffectsIterator it) const
+{
+    return m_activeEffectStatistics.at(it - m_activeEffects.constBegin());
+}
+
+EffectStatistics *EffectsHandlerImpl::profiledEffectStatistics(EffectsIterator it) const
+{
+    return m_profiler->isProfiling() ? effectStatistics(it) : nullptr;
+}
+
+EffectStatistics *EffectsHandlerImpl::profiledSceneStatistics() const
+{
+    return m_profiler->isProfiling() ? m_sceneStatistics : nullptr;
+}
+
+void EffectsHandlerImpl::beginEffectProfiling()
+{
+    if (PerformanceMonitor *monitor = PerformanceMonitor::self()) {
+        monitor->beginEffectProfiling();
+    }
+}
+
+void EffectsHandlerImpl::endEffectProfiling()
+{
+    if (PerformanceMonitor *monitor = PerformanceMonitor::self()) {
+        monitor->endEffectProfiling();
+    }
+}
+
+QVector<EffectCost> EffectsHandlerImpl::effectCosts() const
+{
+    if (PerformanceMonitor *monitor = PerformanceMonitor::self()) {
+        return monitor->effectCosts();
+    }
+    return QVector<EffectCost>();
 }
 
 bool EffectsHandlerImpl::hasDecorationShadows() const
@@ -520,15 +586,18 @@ void EffectsHandlerImpl::startPaint()
 {
     m_activeEffects.clear();
     m_activeEffects.reserve(loaded_effects.count());
+    m_activeEffectStatistics.clear();
     for(QVector< KWin::EffectPair >::const_iterator it = loaded_effects.constBegin(); it != loaded_effects.constEnd(); ++it) {
         if (it->second->isActive()) {
             m_activeEffects << it->second;
+            m_activeEffectStatistics << m_effectStatistics.value(it->second);
         }
     }
     m_currentDrawWindowIterator = m_activeEffects.constBegin();
     m_currentPaintWindowIterator = m_activeEffects.constBegin();
     m_currentPaintScreenIterator = m_activeEffects.constBegin();
     m_currentPaintEffectFrameIterator = m_activeEffects.constBegin();
+    m_profiler->beginFrame();
 }
 
 void EffectsHandlerImpl::slotClientMaximized(KWin::AbstractClient *c, MaximizeMode maxMode)
@@ -1620,6 +1689,7 @@ void EffectsHandlerImpl::destroyEffect(Effect *effect)
     }
 
     stopMouseInterception(effect);
+    m_effectStatistics.remove(effect);
 
     const QList<QByteArray> properties = m_propertiesForEffects.keys();
     for (const QByteArray &property : properties) {
@@ -1692,6 +1762,7 @@ void EffectsHandlerImpl::effectsChanged()
 {
     loaded_effects.clear();
     m_activeEffects.clear(); // it's possible to have a reconfigure and a quad rebuild between two paint cycles - bug #308201
+    m_activeEffectStatistics.clear();
 
     loaded_effects.reserve(effect_order.count());
     std::copy(effect_order.constBegin(), effect_order.constEnd(),
@@ -1723,6 +1794,17 @@ bool EffectsHandlerImpl::blocksDirectScanout() const
     return false;
 }
 
+bool EffectsHandlerImpl::hasActiveEffects() const
+{
+    for(QVector< KWin::EffectPair >::const_iterator it = loaded_effects.constBegin(),
+                                                    end = loaded_effects.constEnd(); it != end; ++it) {
+        if (it->second->isActive()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 KWaylandServer::Display *EffectsHandlerImpl::waylandDisplay() const
 {
     if (waylandServer()) {
@@ -42,6 +42,8 @@ class AbstractClient;
 class Compositor;
 class Deleted;
 class EffectLoader;
+class EffectProfiler;
+struct EffectStatistics;
 class Group;
 class Toplevel;
 class Unmanaged;
@@ -99,6 +101,10 @@ public:
     QRect getSplitArea(int mode, QRect rect, QRect availableArea, QString screen, int desktop, bool isUseTmp = false) override;
     QString getScreenWithSplit() override;
 
+    void beginEffectProfiling() override;
+    void endEffectProfiling() override;
+    QVector<EffectCost> effectCosts() const override;
+
     void setActiveMultitasking(bool isActive) override;
     bool isActiveMultitasking();
 
@@ -233,6 +239,11 @@ public:
      */
     bool blocksDirectScanout() const;
 
+    /**
+     * @returns whether any effect is currently active and takes part in painting the frames
+     */
+    bool hasActiveEffects() const;
+
     /**
      * @returns Whether we are currently in a desktop rendering process triggered by paintDesktop hook
      */
@@ -385,6 +396,14 @@ private:
     EffectsIterator m_currentPaintWindowIterator;
     EffectsIterator m_currentPaintEffectFrameIterator;
     EffectsIterator m_currentPaintScreenIterator;
+    EffectStatistics *effectStatistics(EffectsIterator it) const;
+    EffectStatistics *profiledEffectStatistics(EffectsIterator it) const;
+    EffectStatistics *profiledSceneStatistics() const;
+
+    QHash<Effect *, EffectStatistics *> m_effectStatistics;
+    QVector<EffectStatistics *> m_activeEffectStatistics;
+    EffectStatistics *m_sceneStatistics = nullptr;
+    std::unique_ptr<EffectProfiler> m_profiler;
     typedef QHash< QByteArray, QList< Effect*> > PropertyEffectMap;
     PropertyEffectMap m_propertiesForEffects;
     QHash<QByteArray, qulonglong> m_managedProperties;
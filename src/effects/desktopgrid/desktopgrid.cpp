@@ -1136,8 +1136,8 @@ void DesktopGridEffect::setup()
         if (it == m_desktopButtons.end()) {
             view = new OffscreenQuickScene(this);
 
-            connect(view, &OffscreenQuickView::repaintNeeded, this, []() {
-                effects->addRepaintFull();
+            connect(view, &OffscreenQuickView::repaintNeeded, this, [view]() {
+                effects->addRepaint(view->dirtyRegion());
             });
 
             view->rootContext()->setContextProperty("effects", effects);
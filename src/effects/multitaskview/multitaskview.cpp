@@ -472,6 +472,47 @@ void MultiViewWorkspace::setPosition(QPoint pos)
         m_workspaceBgFrame->setShader(m_shader);
 }
 
+bool MultiViewWorkspace::isThumbnailValid(const ThumbnailLayout &layout, const QSize &size) const
+{
+    return m_thumbnail && !m_thumbnailDirty && m_thumbnail->size() == size && m_thumbnailLayout == layout;
+}
+
+GLRenderTarget *MultiViewWorkspace::thumbnailTarget(const QSize &size)
+{
+    if (!m_thumbnail || m_thumbnail->size() != size) {
+        m_thumbnailTarget.reset();
+        m_thumbnail.reset(new GLTexture(GL_RGBA8, size));
+        m_thumbnail->setFilter(GL_LINEAR);
+        m_thumbnail->setWrapMode(GL_CLAMP_TO_EDGE);
+        m_thumbnailTarget.reset(new GLRenderTarget(*m_thumbnail));
+    }
+    if (!m_thumbnailTarget->valid()) {
+        return nullptr;
+    }
+    return m_thumbnailTarget.data();
+}
+
+void MultiViewWorkspace::setThumbnailLayout(const ThumbnailLayout &layout)
+{
+    m_thumbnailLayout = layout;
+    m_thumbnailDirty = false;
+}
+
+void MultiViewWorkspace::renderThumbnail(const QRect &rect, float opacity, const QMatrix4x4 &projection)
+{
+    ShaderBinder binder(ShaderTrait::MapTexture | ShaderTrait::Modulate);
+    binder.shader()->setUniform(GLShader::ModelViewProjectionMatrix, projection);
+    binder.shader()->setUniform(GLShader::ModulationConstant, QVector4D(opacity, opacity, opacity, opacity));
+
+    // the windows have been blended into the thumbnail already, it is premultiplied
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    m_thumbnail->bind();
+    m_thumbnail->render(infiniteRegion(), rect);
+    m_thumbnail->unbind();
+    glDisable(GL_BLEND);
+}
+
 void MultiViewWorkspace::setImage(const QPixmap &bgPix, const QPixmap &wpPix, const QRect &rect)
 {
     m_rect = rect;
@@ -591,6 +632,9 @@ MultitaskViewEffect::MultitaskViewEffect()
     connect(effects, &EffectsHandler::windowDeleted, this, &MultitaskViewEffect::onWindowDeleted);
     connect(effects, &EffectsHandler::windowClosed, this, &MultitaskViewEffect::onWindowClosed);
     connect(effects, &EffectsHandler::closeEffect, this, &MultitaskViewEffect::onCloseEffect);
+    connect(effects, &EffectsHandler::windowDamaged, this, &MultitaskViewEffect::invalidateWorkspaceThumbnails);
+    connect(effects, &EffectsHandler::windowOpacityChanged, this, &MultitaskViewEffect::invalidateWorkspaceThumbnails);
+    connect(effects, &EffectsHandler::windowClosed, this, &MultitaskViewEffect::invalidateWorkspaceThumbnails);
     //to do about touch screen
     //connect(effects, &EffectsHandler::numberScreensChanged, this, [this] {
     //    onCloseEffect(true);
@@ -642,6 +686,10 @@ MultitaskViewEffect::MultitaskViewEffect()
     if (rel != NULL) {
         m_isOpenGLrender = false;
     }
+    // lets the workspace thumbnails be compared against painting every window
+    if (qEnvironmentVariableIsSet("KWIN_MULTITASKVIEW_NO_THUMBNAILS")) {
+        m_useThumbnails = false;
+    }
     QDBusConnection::sessionBus().connect(DBUS_DEEPIN_WM_SERVICE, DBUS_DEEPIN_WM_OBJ, DBUS_DEEPIN_WM_INTF,
                                         "ShowWorkspaceChanged", this, SLOT(toggle()));
 }
@@ -749,6 +797,7 @@ void MultitaskViewEffect::paintScreen(int mask, const QRegion &region, ScreenPai
     effects->paintScreen(mask, region, data);
 
     QMutexLocker locker(&m_mutex);
+    m_thumbnailPainted.clear();
 
     for (auto iter = m_workspaceBackgrounds.begin(); iter != m_workspaceBackgrounds.end(); iter++) {
         if (m_bgSlidingStatus) {
@@ -1243,6 +1292,23 @@ void MultitaskViewEffect::paintWindow(EffectWindow *w, int mask, QRegion region,
         MultiViewWinManager *wkmobj = getWorkspaceWinManagerObject(paintingDesktop - 1);
         if (wkmobj && wkmobj->getMotion(paintingDesktop, w->screen(), wmm)) {
             if (wmm->isManaging(w)) {
+                MultiViewWorkspace *wkobj = getWorkspaceObject(w->screen(), paintingDesktop - 1);
+                if (wkobj) {
+                    // the first window of the workspace paints all of them from the thumbnail
+                    auto painted = m_thumbnailPainted.find(wkobj);
+                    if (painted == m_thumbnailPainted.end()) {
+                        // same place and clip as painting the windows one by one below, the
+                        // thumbnail already carries the opacity of each window
+                        const QRect rect = wkobj->getCurrentRect();
+                        const qreal opacity = w->opacity() > 0 ? data.opacity() / w->opacity() : data.opacity();
+                        painted = m_thumbnailPainted.insert(wkobj, paintWorkspaceThumbnail(wkobj, wmm, rect.topLeft(), rect, opacity,
+                                                                                           data.screenProjectionMatrix(), true));
+                    }
+                    if (painted.value()) {
+                        return;
+                    }
+                }
+
                 auto area = effects->clientArea(ScreenArea, w->screen(), 0);
                 WindowPaintData d = data;
                 auto geo = wmm->transformedGeometry(w);
@@ -1250,7 +1316,6 @@ void MultitaskViewEffect::paintWindow(EffectWindow *w, int mask, QRegion region,
                 d += QPoint(qRound(geo.x() - w->x()), qRound(geo.y() - w->y()));
                 d.setScale(QVector2D((float)geo.width() / w->width(), (float)geo.height() / w->height()));
                 mask |= PAINT_SCREEN_TRANSFORMED;
-                MultiViewWorkspace *wkobj = getWorkspaceObject(w->screen(), paintingDesktop - 1);
                 if (wkobj)
                     effects->paintWindow(w, mask, wkobj->getCurrentRect(), d);
                 else
@@ -1365,6 +1430,10 @@ void MultitaskViewEffect::renderWorkspaceMove(KWin::ScreenPaintData &data)
             list = wmm->orderManagedWindows();
         }
 
+        if (!list.isEmpty() && paintWorkspaceThumbnail(target, wmm, target->getRect().topLeft(), wkgeo, transparent, data.projectionMatrix())) {
+            return;
+        }
+
         for (EffectWindow *w : list) {
             if (w->screen() == m_screen && wmm->isManaging(w) && !w->isMinimized()) {
                 WindowPaintData d(w, data.projectionMatrix());
@@ -1395,6 +1464,11 @@ void MultitaskViewEffect::renderSlidingWorkspace(MultiViewWorkspace *wkobj, Effe
     WindowMotionManager *wmm;
     MultiViewWinManager *wkmobj = getWorkspaceWinManagerObject(desktop);
     if (wkmobj && wkmobj->getMotion(m_aciveMoveDesktop, screen, wmm)) {
+        // the windows keep their place within the sliding workspace
+        if (paintWorkspaceThumbnail(wkobj, wmm, QPoint(x1, rect.y()), rect, 1.0, data.projectionMatrix())) {
+            return;
+        }
+
         for (EffectWindow *w : wmm->orderManagedWindows()) {
             if (wmm->isManaging(w) && !w->isMinimized()) {
                 WindowPaintData d(w, data.projectionMatrix());
@@ -1410,6 +1484,80 @@ void MultitaskViewEffect::renderSlidingWorkspace(MultiViewWorkspace *wkobj, Effe
     }
 }
 
+bool MultitaskViewEffect::paintWorkspaceThumbnail(MultiViewWorkspace *wkobj, WindowMotionManager *wmm, const QPoint &origin,
+                                                  const QRect &rect, float opacity, const QMatrix4x4 &projection, bool paintChain)
+{
+    // a thumbnail of windows that are still moving would be outdated in the next frame
+    if (!m_isOpenGLrender || !m_useThumbnails || !wmm || wmm->areWindowsMoving() || rect.isEmpty()) {
+        return false;
+    }
+
+    MultiViewWorkspace::ThumbnailLayout layout;
+    for (EffectWindow *w : wmm->orderManagedWindows()) {
+        if (wmm->isManaging(w) && !w->isMinimized()) {
+            layout.append(qMakePair(w, wmm->transformedGeometry(w).translated(-origin)));
+        }
+    }
+
+    const qreal scale = wkobj->screen() ? wkobj->screen()->devicePixelRatio() : 1.0;
+    const QSize size = rect.size() * scale;
+    if (!wkobj->isThumbnailValid(layout, size)) {
+        GLRenderTarget *target = wkobj->thumbnailTarget(size);
+        if (!target) {
+            return false;
+        }
+
+        // the preview may be scissored on X11, the thumbnail must not be
+        const bool scissor = glIsEnabled(GL_SCISSOR_TEST);
+        glDisable(GL_SCISSOR_TEST);
+        GLRenderTarget::pushRenderTarget(target);
+        glClearColor(0.0, 0.0, 0.0, 0.0);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glClearColor(0.0, 0.0, 0.0, 1.0);
+
+        QMatrix4x4 thumbnailProjection;
+        thumbnailProjection.ortho(QRect(QPoint(0, 0), rect.size()));
+        for (const auto &entry : qAsConst(layout)) {
+            EffectWindow *w = entry.first;
+            const QRectF &geo = entry.second;
+            WindowPaintData d(w, thumbnailProjection);
+            d *= QVector2D((qreal)geo.width() / (qreal)w->width(), (qreal)geo.height() / (qreal)w->height());
+            d += QPoint(qRound(geo.left()) - w->x(), qRound(geo.top()) - w->y());
+            // from paintWindow the effects after this one have to see the windows as well
+            if (paintChain) {
+                effects->paintWindow(w, PAINT_WINDOW_TRANSFORMED, infiniteRegion(), d);
+            } else {
+                effects->drawWindow(w, PAINT_WINDOW_TRANSFORMED, infiniteRegion(), d);
+            }
+        }
+
+        GLRenderTarget::popRenderTarget();
+        if (scissor) {
+            glEnable(GL_SCISSOR_TEST);
+        }
+        wkobj->setThumbnailLayout(layout);
+    }
+
+    wkobj->renderThumbnail(rect, opacity, projection);
+    return true;
+}
+
+void MultitaskViewEffect::invalidateWorkspaceThumbnails(EffectWindow *w)
+{
+    if (!m_activated) {
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    for (auto iter = m_workspaceBackgrounds.constBegin(); iter != m_workspaceBackgrounds.constEnd(); ++iter) {
+        const QList<MultiViewWorkspace *> &list = iter.value();
+        for (int j = 0; j < list.size(); ++j) {
+            if (w->isOnDesktop(j + 1)) {
+                list[j]->invalidateThumbnail();
+            }
+        }
+    }
+}
+
 void MultitaskViewEffect::renderHover(const EffectWindow *w, const QRect &rect, int order)
 {
     if (!order) {
@@ -2528,6 +2676,20 @@ void MultitaskViewEffect::calculateWindowTransformationsClosest(EffectWindowList
     QRect clientRect = desktopRect;
     clientRect.setY(clientRect.y() + m_scale[screen].workspaceMgrHeight);
 
+    // Nothing changed on this screen since the last layout, the windows keep their slots
+    if (wmobj) {
+        MultiViewWinManager::LayoutInput input{desktopRect, clientRect, {}};
+        input.windows.reserve(windowlist.size());
+        for (EffectWindow *w : windowlist) {
+            input.windows.append(qMakePair(w, targets.value(w)));
+        }
+        if (wmobj->isLayoutCurrent(screen, input)) {
+            return;
+        }
+        wmobj->setLayout(screen, input);
+    }
+    m_layoutCount++;
+
     QList<int> centerList;
     int row = 1;
     int index = 1;
@@ -2609,17 +2771,19 @@ void MultitaskViewEffect::calculateWindowTransformationsClosest(EffectWindowList
             winYPos += scaleHeight;
         }
 
-        if (isReLayout) {
+        // windows that keep their slot keep their fill as well
+        const QRect fillRect(x, winYPos, width, scaleHeight);
+        const bool keepFill = isReLayout && isFill && motionManager.isWindowFill(w) && motionManager.getWindowFillRect(w) == fillRect;
+        if (isReLayout && !keepFill) {
             motionManager.resetWindowFill(w);
             removeBackgroundFill(w, desktop);
         }
 
         target->setRect(x, winYPos + (scaleHeight - height) / 2, width, height);
 
-        if (isFill) {
-            QRect rect(x, winYPos, width, scaleHeight);
-            motionManager.setWindowFill(w, true, rect);
-            createBackgroundFill(w, rect, desktop);
+        if (isFill && !keepFill) {
+            motionManager.setWindowFill(w, true, fillRect);
+            createBackgroundFill(w, fillRect, desktop);
         }
         x += width;
         x += m_scale[screen].spacingWidth;
@@ -156,6 +156,15 @@ public:
     int desktop() {return m_desktop;}
     void setPosition(QPoint pos);
 
+    // the managed windows of the workspace and where they are in the preview, relative to it
+    typedef QVector<QPair<EffectWindow *, QRectF>> ThumbnailLayout;
+
+    bool isThumbnailValid(const ThumbnailLayout &layout, const QSize &size) const;
+    GLRenderTarget *thumbnailTarget(const QSize &size);
+    void setThumbnailLayout(const ThumbnailLayout &layout);
+    void invalidateThumbnail() {m_thumbnailDirty = true;}
+    void renderThumbnail(const QRect &rect, float opacity, const QMatrix4x4 &projection);
+
 private:
     GLShader *m_shader;
     GLShader *m_hoverShader;
@@ -176,6 +185,11 @@ private:
 
     bool m_bShader;
 
+    QScopedPointer<GLTexture> m_thumbnail;
+    QScopedPointer<GLRenderTarget> m_thumbnailTarget;
+    ThumbnailLayout m_thumbnailLayout;
+    bool m_thumbnailDirty = true;
+
 public:
     workspaceMoveDirection m_posStatus = mvNone; // 0 restore; 1 left; 2 right;
 };
@@ -200,6 +214,17 @@ class MultiViewWinManager : public QObject
 {
     Q_OBJECT
 public:
+    // Input of the layout of a screen, the windows are only laid out again if it changes
+    struct LayoutInput {
+        QRect area;
+        QRect clientArea;
+        QVector<QPair<EffectWindow *, QRect>> windows;
+
+        bool operator==(const LayoutInput &other) const {
+            return area == other.area && clientArea == other.clientArea && windows == other.windows;
+        }
+    };
+
     explicit MultiViewWinManager() {};
     ~MultiViewWinManager() {
         for (auto it = m_winManager.begin(); it != m_winManager.end(); it++) {
@@ -242,6 +267,7 @@ public:
             ++it;
         }
         m_splitList.clear();
+        m_layouts.clear();
     }
     void resetWindow() {
         QHash<EffectScreen *, WindowMotionManager>::iterator it;
@@ -359,6 +385,15 @@ public:
         m_windowFill.remove(w);
     }
 
+    bool isLayoutCurrent(EffectScreen *screen, const LayoutInput &input) const {
+        auto it = m_layouts.constFind(screen);
+        return it != m_layouts.constEnd() && *it == input;
+    }
+
+    void setLayout(EffectScreen *screen, const LayoutInput &input) {
+        m_layouts[screen] = input;
+    }
+
 /******************split window******************************/
 
     void setSplitList(EffectScreen *screen, QSet<KWin::EffectWindow *> &list) {
@@ -399,6 +434,7 @@ private:
     QHash<EffectScreen *, QSet<EffectWindow *>> m_splitList;
     QHash<EffectScreen *, QRect>                m_splitRect;
     QHash<EffectScreen *, EffectWindow *>       m_hoverSplit;
+    QHash<EffectScreen *, LayoutInput>          m_layouts;
     int m_desktop;
     QRect m_currentShowRect;
     QRect m_rect;
@@ -407,6 +443,7 @@ private:
 class MultitaskViewEffect : public Effect
 {
     Q_OBJECT
+    Q_PROPERTY(int layoutCount READ layoutCount)
 public:
     MultitaskViewEffect();
     virtual ~MultitaskViewEffect() override;
@@ -436,6 +473,11 @@ public:
         return 90;
     }
 
+    // the number of times the windows of a screen were laid out again
+    int layoutCount() const {
+        return m_layoutCount;
+    }
+
 Q_SIGNALS:
     void sigAddNewDesktop(EffectWindow *w, EffectScreen *s);
 
@@ -452,6 +494,7 @@ private Q_SLOTS:
     void onWindowDeleted(EffectWindow *w);
     void onWindowClosed(EffectWindow *w);
     void onCloseEffect(bool);
+    void invalidateWorkspaceThumbnails(EffectWindow *w);
 
     void onAddNewDesktop(EffectWindow *w, EffectScreen *s);
 
@@ -492,6 +535,8 @@ private:
     void renderWorkspaceMove(KWin::ScreenPaintData &data);
     void renderWindowMove(KWin::ScreenPaintData &data);
     void renderSlidingWorkspace(MultiViewWorkspace *wkobj, EffectScreen *screen, int desktop, KWin::ScreenPaintData &data);
+    bool paintWorkspaceThumbnail(MultiViewWorkspace *wkobj, WindowMotionManager *wmm, const QPoint &origin,
+                                 const QRect &rect, float opacity, const QMatrix4x4 &projection, bool paintChain = false);
     void renderHover(const EffectWindow *w, const QRect &rect, int order = 0);
     void renderWorkspaceHover(EffectScreen *screen);
     void renderDragWorkspacePrompt(EffectScreen *screen);
@@ -554,6 +599,8 @@ private:
     bool m_longPressTouch = false;
 
     bool m_isOpenGLrender = true;
+    bool m_useThumbnails = true;
+    int m_layoutCount = 0;
 
     QPoint m_workspaceMoveStartPos;
     QPoint m_windowMoveStartPos;
@@ -567,6 +614,8 @@ private:
     QHash<QString, ScreenInfo_st>                   m_screenInfoList;
     QHash<EffectScreen *, QList<MultiViewWorkspace *>> m_workspaceBackgrounds;
     QHash<EffectScreen *, MultiViewWorkspace *>     m_workspaceBackgroundsTmp;
+    // whether the thumbnail of a workspace has stood in for its windows in the current paint
+    QHash<MultiViewWorkspace *, bool>               m_thumbnailPainted;
     QVector<MultiViewWinManager *>                  m_motionManagers;
     QVector<MultiViewWinManager *>                  m_workspaceWinMgr;
     QRect m_backgroundRect;
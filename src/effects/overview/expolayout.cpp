@@ -10,6 +10,8 @@
 
 #include "expolayout.h"
 
+#include <deepin_kwinnaturallayout.h>
+
 #include <cmath>
 
 ExpoCell::ExpoCell(QObject *parent)
@@ -420,35 +422,6 @@ void ExpoLayout::calculateWindowTransformationsClosest()
     }
 }
 
-static inline int heightForWidth(ExpoCell *cell, int width)
-{
-    return int((width / qreal(cell->naturalWidth())) * cell->naturalHeight());
-}
-
-static bool isOverlappingAny(ExpoCell *w, const QHash<ExpoCell *, QRect> &targets, const QRegion &border, int spacing)
-{
-    QHash<ExpoCell *, QRect>::const_iterator winTarget = targets.find(w);
-    if (winTarget == targets.constEnd()) {
-        return false;
-    }
-    if (border.intersects(*winTarget)) {
-        return true;
-    }
-    const QMargins halfSpacing(spacing / 2, spacing / 2, spacing / 2, spacing / 2);
-
-    // Is there a better way to do this?
-    QHash<ExpoCell *, QRect>::const_iterator target;
-    for (target = targets.constBegin(); target != targets.constEnd(); ++target) {
-        if (target == winTarget) {
-            continue;
-        }
-        if (winTarget->marginsAdded(halfSpacing).intersects(target->marginsAdded(halfSpacing))) {
-            return true;
-        }
-    }
-    return false;
-}
-
 void ExpoLayout::calculateWindowTransformationsNatural()
 {
     const QRect area = QRect(0, 0, width(), height());
@@ -459,104 +432,18 @@ void ExpoLayout::calculateWindowTransformationsNatural()
         return a->persistentKey() < b->persistentKey();
     });
 
-    QRect bounds;
-    int direction = 0;
-    QHash<ExpoCell *, QRect> targets;
-    QHash<ExpoCell *, int> directions;
-
-    for (ExpoCell *cell : qAsConst(m_cells)) {
-        const QRect cellRect(cell->naturalX(), cell->naturalY(), cell->naturalWidth(), cell->naturalHeight());
-        targets[cell] = cellRect;
-        // Reuse the unused "slot" as a preferred direction attribute. This is used when the window
-        // is on the edge of the screen to try to use as much screen real estate as possible.
-        directions[cell] = direction;
-        bounds = bounds.united(cellRect);
-        direction++;
-        if (direction == 4) {
-            direction = 0;
-        }
+    QVector<QRect> geometries;
+    geometries.reserve(m_cells.count());
+    for (const ExpoCell *cell : qAsConst(m_cells)) {
+        geometries.append(QRect(cell->naturalX(), cell->naturalY(), cell->naturalWidth(), cell->naturalHeight()));
     }
 
-    // Iterate over all windows, if two overlap push them apart _slightly_ as we try to
-    // brute-force the most optimal positions over many iterations.
-    const int halfSpacing = m_spacing / 2;
-    bool overlap;
-    do {
-        overlap = false;
-        for (ExpoCell *cell : qAsConst(m_cells)) {
-            QRect *target_w = &targets[cell];
-            for (ExpoCell *e : qAsConst(m_cells)) {
-                if (cell == e) {
-                    continue;
-                }
+    KWin::NaturalLayout layout(geometries);
+    layout.setSpacing(m_spacing);
+    layout.setAccuracy(m_accuracy);
 
-                QRect *target_e = &targets[e];
-                if (target_w->adjusted(-halfSpacing, -halfSpacing, halfSpacing, halfSpacing)
-                        .intersects(target_e->adjusted(-halfSpacing, -halfSpacing, halfSpacing, halfSpacing))) {
-                    overlap = true;
-
-                    // Determine pushing direction
-                    QPoint diff(target_e->center() - target_w->center());
-                    // Prevent dividing by zero and non-movement
-                    if (diff.x() == 0 && diff.y() == 0) {
-                        diff.setX(1);
-                    }
-                    // Try to keep screen aspect ratio
-                    //if (bounds.height() / bounds.width() > area.height() / area.width())
-                    //    diff.setY(diff.y() / 2);
-                    //else
-                    //    diff.setX(diff.x() / 2);
-                    // Approximate a vector of between 10px and 20px in magnitude in the same direction
-                    diff *= m_accuracy / qreal(diff.manhattanLength());
-                    // Move both windows apart
-                    target_w->translate(-diff);
-                    target_e->translate(diff);
-
-                    // Try to keep the bounding rect the same aspect as the screen so that more
-                    // screen real estate is utilised. We do this by splitting the screen into nine
-                    // equal sections, if the window center is in any of the corner sections pull the
-                    // window towards the outer corner. If it is in any of the other edge sections
-                    // alternate between each corner on that edge. We don't want to determine it
-                    // randomly as it will not produce consistant locations when using the filter.
-                    // Only move one window so we don't cause large amounts of unnecessary zooming
-                    // in some situations. We need to do this even when expanding later just in case
-                    // all windows are the same size.
-                    // (We are using an old bounding rect for this, hopefully it doesn't matter)
-                    int xSection = (target_w->x() - bounds.x()) / (bounds.width() / 3);
-                    int ySection = (target_w->y() - bounds.y()) / (bounds.height() / 3);
-                    diff = QPoint(0, 0);
-                    if (xSection != 1 || ySection != 1) { // Remove this if you want the center to pull as well
-                        if (xSection == 1) {
-                            xSection = (directions[cell] / 2 ? 2 : 0);
-                        }
-                        if (ySection == 1) {
-                            ySection = (directions[cell] % 2 ? 2 : 0);
-                        }
-                    }
-                    if (xSection == 0 && ySection == 0) {
-                        diff = QPoint(bounds.topLeft() - target_w->center());
-                    }
-                    if (xSection == 2 && ySection == 0) {
-                        diff = QPoint(bounds.topRight() - target_w->center());
-                    }
-                    if (xSection == 2 && ySection == 2) {
-                        diff = QPoint(bounds.bottomRight() - target_w->center());
-                    }
-                    if (xSection == 0 && ySection == 2) {
-                        diff = QPoint(bounds.bottomLeft() - target_w->center());
-                    }
-                    if (diff.x() != 0 || diff.y() != 0) {
-                        diff *= m_accuracy / qreal(diff.manhattanLength());
-                        target_w->translate(diff);
-                    }
-
-                    // Update bounding rect
-                    bounds = bounds.united(*target_w);
-                    bounds = bounds.united(*target_e);
-                }
-            }
-        }
-    } while (overlap);
+    QRect bounds;
+    layout.separate(bounds);
 
     // Compute the scale factor so the bounding rect fits the target area.
     qreal scale;
@@ -574,110 +461,20 @@ void ExpoLayout::calculateWindowTransformationsNatural()
                    area.height() / scale);
 
     // Move all windows back onto the screen and set their scale
-    QHash<ExpoCell *, QRect>::iterator target = targets.begin();
-    while (target != targets.end()) {
-        target->setRect((target->x() - bounds.x()) * scale + area.x(),
-                        (target->y() - bounds.y()) * scale + area.y(),
-                        target->width() * scale,
-                        target->height() * scale);
-        ++target;
-    }
+    layout.map(bounds, scale, area.topLeft());
 
     // Try to fill the gaps by enlarging windows if they have the space
     if (m_fillGaps) {
         // Don't expand onto or over the border
         QRegion borderRegion(area.adjusted(-200, -200, 200, 200));
         borderRegion ^= area;
-
-        bool moved;
-        do {
-            moved = false;
-            for (ExpoCell *cell : qAsConst(m_cells)) {
-                QRect oldRect;
-                QRect *target = &targets[cell];
-                // This may cause some slight distortion if the windows are enlarged a large amount
-                int widthDiff = m_accuracy;
-                int heightDiff = heightForWidth(cell, target->width() + widthDiff) - target->height();
-                int xDiff = widthDiff / 2;  // Also move a bit in the direction of the enlarge, allows the
-                int yDiff = heightDiff / 2; // center windows to be enlarged if there is gaps on the side.
-
-                // heightDiff (and yDiff) will be re-computed after each successful enlargement attempt
-                // so that the error introduced in the window's aspect ratio is minimized
-
-                // Attempt enlarging to the top-right
-                oldRect = *target;
-                target->setRect(target->x() + xDiff,
-                                target->y() - yDiff - heightDiff,
-                                target->width() + widthDiff,
-                                target->height() + heightDiff);
-                if (isOverlappingAny(cell, targets, borderRegion, m_spacing))
-                    *target = oldRect;
-                else {
-                    moved = true;
-                    heightDiff = heightForWidth(cell, target->width() + widthDiff) - target->height();
-                    yDiff = heightDiff / 2;
-                }
-
-                // Attempt enlarging to the bottom-right
-                oldRect = *target;
-                target->setRect(target->x() + xDiff,
-                                target->y() + yDiff,
-                                target->width() + widthDiff,
-                                target->height() + heightDiff);
-                if (isOverlappingAny(cell, targets, borderRegion, m_spacing))
-                    *target = oldRect;
-                else {
-                    moved = true;
-                    heightDiff = heightForWidth(cell, target->width() + widthDiff) - target->height();
-                    yDiff = heightDiff / 2;
-                }
-
-                // Attempt enlarging to the bottom-left
-                oldRect = *target;
-                target->setRect(target->x() - xDiff - widthDiff,
-                                target->y() + yDiff,
-                                target->width() + widthDiff,
-                                target->height() + heightDiff);
-                if (isOverlappingAny(cell, targets, borderRegion, m_spacing))
-                    *target = oldRect;
-                else {
-                    moved = true;
-                    heightDiff = heightForWidth(cell, target->width() + widthDiff) - target->height();
-                    yDiff = heightDiff / 2;
-                }
-
-                // Attempt enlarging to the top-left
-                oldRect = *target;
-                target->setRect(target->x() - xDiff - widthDiff,
-                                target->y() - yDiff - heightDiff,
-                                target->width() + widthDiff,
-                                target->height() + heightDiff);
-                if (isOverlappingAny(cell, targets, borderRegion, m_spacing)) {
-                    *target = oldRect;
-                } else {
-                    moved = true;
-                }
-            }
-        } while (moved);
-
-        // The expanding code above can actually enlarge windows over 1.0/2.0 scale, we don't like this
-        // We can't add this to the loop above as it would cause a never-ending loop so we have to make
-        // do with the less-than-optimal space usage with using this method.
-        for (ExpoCell *cell : qAsConst(m_cells)) {
-            QRect *target = &targets[cell];
-            qreal scale = target->width() / qreal(cell->naturalWidth());
-            if (scale > 2.0 || (scale > 1.0 && (cell->naturalWidth() > 300 || cell->naturalHeight() > 300))) {
-                scale = (cell->naturalWidth() > 300 || cell->naturalHeight() > 300) ? 1.0 : 2.0;
-                target->setRect(target->center().x() - int(cell->naturalWidth() * scale) / 2,
-                                target->center().y() - int(cell->naturalHeight() * scale) / 2,
-                                cell->naturalWidth() * scale,
-                                cell->naturalHeight() * scale);
-            }
-        }
+        layout.fillGaps(borderRegion);
     }
 
-    for (ExpoCell *cell : qAsConst(m_cells)) {
-        const QRect rect = centered(cell, targets.value(cell).marginsRemoved(cell->margins()));
+    const QVector<QRect> &targets = layout.targets();
+    for (int i = 0; i < m_cells.count(); ++i) {
+        ExpoCell *cell = m_cells[i];
+        const QRect rect = centered(cell, targets[i].marginsRemoved(cell->margins()));
 
         cell->setX(rect.x());
         cell->setY(rect.y());
@@ -16,6 +16,7 @@
 #include <KLocalizedString>
 
 #include <deepin_kwinglutils.h>
+#include <deepin_kwinnaturallayout.h>
 
 #include <QMouseEvent>
 #include <netwm_def.h>
@@ -1053,8 +1054,27 @@ void PresentWindowsEffect::rearrangeWindows()
             continue;
 
         // No point continuing if there is no windows to process
-        if (!windows.count())
+        if (!windows.count()) {
+            m_screenLayouts.remove(screen);
             continue;
+        }
+
+        // Windows were added, closed or moved on another screen, the targets of this one are still valid
+        ScreenLayout layout;
+        layout.mode = m_layoutMode;
+        layout.desktop = effects->currentDesktop();
+        layout.screenArea = effects->clientArea(ScreenArea, screen, layout.desktop);
+        layout.maximizeArea = effects->clientArea(MaximizeArea, screen, layout.desktop);
+        layout.windows.reserve(windows.count());
+        for (EffectWindow *w : qAsConst(windows))
+            layout.windows.append(qMakePair(w, w->frameGeometry()));
+        std::sort(layout.windows.begin(), layout.windows.end(), [](const QPair<EffectWindow*, QRect> &a, const QPair<EffectWindow*, QRect> &b) {
+            return a.first < b.first;
+        });
+        auto cached = m_screenLayouts.find(screen);
+        if (cached != m_screenLayouts.end() && *cached == layout)
+            continue;
+        m_screenLayouts[screen] = layout;
 
         calculateWindowTransformations(windows, screen, m_motionManager);
     }
@@ -1362,91 +1382,18 @@ void PresentWindowsEffect::calculateWindowTransformationsNatural(EffectWindowLis
     QRect area = effects->clientArea(ScreenArea, screen, effects->currentDesktop());
     if (m_showPanel)   // reserve space for the panel
         area = effects->clientArea(MaximizeArea, screen, effects->currentDesktop());
-    QRect bounds = area;
-    int direction = 0;
-    QHash<EffectWindow*, QRect> targets;
-    QHash<EffectWindow*, int> directions;
-    for (EffectWindow *w : qAsConst(windowlist)) {
-        bounds = bounds.united(w->frameGeometry());
-        targets[w] = w->frameGeometry();
-        // Reuse the unused "slot" as a preferred direction attribute. This is used when the window
-        // is on the edge of the screen to try to use as much screen real estate as possible.
-        directions[w] = direction;
-        direction++;
-        if (direction == 4)
-            direction = 0;
-    }
-
-    // Iterate over all windows, if two overlap push them apart _slightly_ as we try to
-    // brute-force the most optimal positions over many iterations.
-    bool overlap;
-    do {
-        overlap = false;
-        for (EffectWindow *w : qAsConst(windowlist)) {
-            QRect *target_w = &targets[w];
-            for (EffectWindow *e : qAsConst(windowlist)) {
-                if (w == e)
-                    continue;
-
-                QRect *target_e = &targets[e];
-                if (target_w->adjusted(-5, -5, 5, 5).intersects(target_e->adjusted(-5, -5, 5, 5))) {
-                    overlap = true;
-
-                    // Determine pushing direction
-                    QPoint diff(target_e->center() - target_w->center());
-                    // Prevent dividing by zero and non-movement
-                    if (diff.x() == 0 && diff.y() == 0)
-                        diff.setX(1);
-                    // Try to keep screen aspect ratio
-                    //if (bounds.height() / bounds.width() > area.height() / area.width())
-                    //    diff.setY(diff.y() / 2);
-                    //else
-                    //    diff.setX(diff.x() / 2);
-                    // Approximate a vector of between 10px and 20px in magnitude in the same direction
-                    diff *= m_accuracy / double(diff.manhattanLength());
-                    // Move both windows apart
-                    target_w->translate(-diff);
-                    target_e->translate(diff);
-
-                    // Try to keep the bounding rect the same aspect as the screen so that more
-                    // screen real estate is utilised. We do this by splitting the screen into nine
-                    // equal sections, if the window center is in any of the corner sections pull the
-                    // window towards the outer corner. If it is in any of the other edge sections
-                    // alternate between each corner on that edge. We don't want to determine it
-                    // randomly as it will not produce consistant locations when using the filter.
-                    // Only move one window so we don't cause large amounts of unnecessary zooming
-                    // in some situations. We need to do this even when expanding later just in case
-                    // all windows are the same size.
-                    // (We are using an old bounding rect for this, hopefully it doesn't matter)
-                    int xSection = (target_w->x() - bounds.x()) / (bounds.width() / 3);
-                    int ySection = (target_w->y() - bounds.y()) / (bounds.height() / 3);
-                    diff = QPoint(0, 0);
-                    if (xSection != 1 || ySection != 1) { // Remove this if you want the center to pull as well
-                        if (xSection == 1)
-                            xSection = (directions[w] / 2 ? 2 : 0);
-                        if (ySection == 1)
-                            ySection = (directions[w] % 2 ? 2 : 0);
-                    }
-                    if (xSection == 0 && ySection == 0)
-                        diff = QPoint(bounds.topLeft() - target_w->center());
-                    if (xSection == 2 && ySection == 0)
-                        diff = QPoint(bounds.topRight() - target_w->center());
-                    if (xSection == 2 && ySection == 2)
-                        diff = QPoint(bounds.bottomRight() - target_w->center());
-                    if (xSection == 0 && ySection == 2)
-                        diff = QPoint(bounds.bottomLeft() - target_w->center());
-                    if (diff.x() != 0 || diff.y() != 0) {
-                        diff *= m_accuracy / double(diff.manhattanLength());
-                        target_w->translate(diff);
-                    }
 
-                    // Update bounding rect
-                    bounds = bounds.united(*target_w);
-                    bounds = bounds.united(*target_e);
-                }
-            }
-        }
-    } while (overlap);
+    QVector<QRect> geometries;
+    geometries.reserve(windowlist.count());
+    for (EffectWindow *w : qAsConst(windowlist))
+        geometries.append(w->frameGeometry());
+
+    NaturalLayout layout(geometries);
+    layout.setSpacing(10);
+    layout.setAccuracy(m_accuracy);
+
+    QRect bounds = area;
+    layout.separate(bounds);
 
     // Work out scaling by getting the most top-left and most bottom-right window coords.
     // The 20's and 10's are so that the windows don't touch the edge of the screen.
@@ -1466,139 +1413,21 @@ void PresentWindowsEffect::calculateWindowTransformationsNatural(EffectWindowLis
              );
 
     // Move all windows back onto the screen and set their scale
-    QHash<EffectWindow*, QRect>::iterator target = targets.begin();
-    while (target != targets.end()) {
-        target->setRect((target->x() - bounds.x()) * scale + area.x(),
-                        (target->y() - bounds.y()) * scale + area.y(),
-                        target->width() * scale,
-                        target->height() * scale
-                        );
-        ++target;
-    }
+    layout.map(bounds, scale, area.topLeft());
 
     // Try to fill the gaps by enlarging windows if they have the space
     if (m_fillGaps) {
         // Don't expand onto or over the border
         QRegion borderRegion(area.adjusted(-200, -200, 200, 200));
         borderRegion ^= area.adjusted(10 / scale, 10 / scale, -10 / scale, -10 / scale);
-
-        bool moved;
-        do {
-            moved = false;
-            for (EffectWindow *w : qAsConst(windowlist)) {
-                QRect oldRect;
-                QRect *target = &targets[w];
-                // This may cause some slight distortion if the windows are enlarged a large amount
-                int widthDiff = m_accuracy;
-                int heightDiff = heightForWidth(w, target->width() + widthDiff) - target->height();
-                int xDiff = widthDiff / 2;  // Also move a bit in the direction of the enlarge, allows the
-                int yDiff = heightDiff / 2; // center windows to be enlarged if there is gaps on the side.
-
-                // heightDiff (and yDiff) will be re-computed after each successful enlargement attempt
-                // so that the error introduced in the window's aspect ratio is minimized
-
-                // Attempt enlarging to the top-right
-                oldRect = *target;
-                target->setRect(target->x() + xDiff,
-                                target->y() - yDiff - heightDiff,
-                                target->width() + widthDiff,
-                                target->height() + heightDiff
-                                );
-                if (isOverlappingAny(w, targets, borderRegion))
-                    *target = oldRect;
-                else {
-                    moved = true;
-                    heightDiff = heightForWidth(w, target->width() + widthDiff) - target->height();
-                    yDiff = heightDiff / 2;
-                }
-
-                // Attempt enlarging to the bottom-right
-                oldRect = *target;
-                target->setRect(
-                                 target->x() + xDiff,
-                                 target->y() + yDiff,
-                                 target->width() + widthDiff,
-                                 target->height() + heightDiff
-                             );
-                if (isOverlappingAny(w, targets, borderRegion))
-                    *target = oldRect;
-                else {
-                    moved = true;
-                    heightDiff = heightForWidth(w, target->width() + widthDiff) - target->height();
-                    yDiff = heightDiff / 2;
-                }
-
-                // Attempt enlarging to the bottom-left
-                oldRect = *target;
-                target->setRect(
-                                 target->x() - xDiff - widthDiff,
-                                 target->y() + yDiff,
-                                 target->width() + widthDiff,
-                                 target->height() + heightDiff
-                             );
-                if (isOverlappingAny(w, targets, borderRegion))
-                    *target = oldRect;
-                else {
-                    moved = true;
-                    heightDiff = heightForWidth(w, target->width() + widthDiff) - target->height();
-                    yDiff = heightDiff / 2;
-                }
-
-                // Attempt enlarging to the top-left
-                oldRect = *target;
-                target->setRect(
-                                 target->x() - xDiff - widthDiff,
-                                 target->y() - yDiff - heightDiff,
-                                 target->width() + widthDiff,
-                                 target->height() + heightDiff
-                             );
-                if (isOverlappingAny(w, targets, borderRegion))
-                    *target = oldRect;
-                else
-                    moved = true;
-            }
-        } while (moved);
-
-        // The expanding code above can actually enlarge windows over 1.0/2.0 scale, we don't like this
-        // We can't add this to the loop above as it would cause a never-ending loop so we have to make
-        // do with the less-than-optimal space usage with using this method.
-        for (EffectWindow * w : qAsConst(windowlist)) {
-            QRect *target = &targets[w];
-            double scale = target->width() / double(w->width());
-            if (scale > 2.0 || (scale > 1.0 && (w->width() > 300 || w->height() > 300))) {
-                scale = (w->width() > 300 || w->height() > 300) ? 1.0 : 2.0;
-                target->setRect(
-                                 target->center().x() - int(w->width() * scale) / 2,
-                                 target->center().y() - int(w->height() * scale) / 2,
-                                 w->width() * scale,
-                                 w->height() * scale);
-            }
-        }
+        layout.fillGaps(borderRegion);
     }
 
     // Notify the motion manager of the targets
-    for (EffectWindow *w : qAsConst(windowlist)) {
-        motionManager.moveWindow(w, targets.value(w));
-    }
-}
-
-bool PresentWindowsEffect::isOverlappingAny(EffectWindow *w, const QHash<EffectWindow*, QRect> &targets, const QRegion &border)
-{
-    QHash<EffectWindow*, QRect>::const_iterator winTarget = targets.find(w);
-    if (winTarget == targets.constEnd())
-        return false;
-    if (border.intersects(*winTarget))
-        return true;
-
-    // Is there a better way to do this?
-    QHash<EffectWindow*, QRect>::const_iterator target;
-    for (target = targets.constBegin(); target != targets.constEnd(); ++target) {
-        if (target == winTarget)
-            continue;
-        if (winTarget->adjusted(-5, -5, 5, 5).intersects(target->adjusted(-5, -5, 5, 5)))
-            return true;
+    const QVector<QRect> &targets = layout.targets();
+    for (int i = 0; i < windowlist.count(); ++i) {
+        motionManager.moveWindow(windowlist[i], targets[i]);
     }
-    return false;
 }
 
 //-----------------------------------------------------------------------------
@@ -1626,8 +1455,8 @@ void PresentWindowsEffect::setActive(bool active)
 
         if (!(m_doNotCloseWindows || m_closeView)) {
             m_closeView = new CloseWindowView();
-            connect(m_closeView, &OffscreenQuickView::repaintNeeded, this, []() {
-                effects->addRepaintFull();
+            connect(m_closeView, &OffscreenQuickView::repaintNeeded, this, [this]() {
+                effects->addRepaint(m_closeView->dirtyRegion());
             });
             connect(m_closeView, &CloseWindowView::requestClose, this, &PresentWindowsEffect::closeWindow);
         }
@@ -2124,6 +1953,7 @@ void PresentWindowsEffect::maybeRecreateGrids()
 void PresentWindowsEffect::reCreateGrids()
 {
     m_gridSizes.clear();
+    m_screenLayouts.clear();
     const QList<EffectScreen *> screens = effects->screens();
     for (EffectScreen *screen : screens) {
         m_gridSizes.insert(screen, GridSize());
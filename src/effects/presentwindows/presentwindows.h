@@ -79,6 +79,19 @@ private:
         int columns;
         int rows;
     };
+    // Input of the layout of a screen, the windows are only laid out again if it changes
+    struct ScreenLayout {
+        int mode = -1;
+        int desktop = 0;
+        QRect screenArea;
+        QRect maximizeArea;
+        QVector<QPair<EffectWindow*, QRect>> windows;
+
+        bool operator==(const ScreenLayout &other) const {
+            return mode == other.mode && desktop == other.desktop && screenArea == other.screenArea
+                && maximizeArea == other.maximizeArea && windows == other.windows;
+        }
+    };
 
 public:
     PresentWindowsEffect();
@@ -235,7 +248,6 @@ protected:
     inline int heightForWidth(EffectWindow *w, int width) {
         return int((width / double(w->width())) * w->height());
     }
-    bool isOverlappingAny(EffectWindow *w, const QHash<EffectWindow*, QRect> &targets, const QRegion &border);
 
     // Filter box
     void updateFilterFrame();
@@ -296,6 +308,7 @@ private:
 
     // Grid layout info
     QMap<EffectScreen *, GridSize> m_gridSizes;
+    QHash<EffectScreen *, ScreenLayout> m_screenLayouts;
 
     // Filter box
     EffectFrame* m_filterFrame;
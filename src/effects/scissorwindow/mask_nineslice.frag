@@ -0,0 +1,25 @@
+#version 300 es
+precision highp float;
+
+uniform sampler2D sampler, msk1;
+// window size and the rounded rectangle within it, in logical pixels
+uniform vec2 size;
+uniform vec4 rect;
+// the corner tile of msk1 and its transparent border
+uniform float tile;
+uniform float padding;
+
+in vec2 texcoord0;
+out vec4 fragColor;
+
+void main() {
+    vec4 c = texture(sampler, texcoord0);
+    vec2 p = texcoord0 * size - rect.xy;
+    // mirror every corner onto the top left one, the sides clamp to the edge of the tile
+    vec2 d = min(p, rect.zw - p) + vec2(padding);
+    vec4 m = texture(msk1, d / tile);
+    c *= m.a;
+    fragColor = c;
+}
+
+// vim: set ft=glsl:
@@ -11,12 +11,18 @@
 #include <kwindowsystem.h>
 
 #include <QFile>
+#include <QFutureWatcher>
 #include <QImage>
 #include <QPainter>
 #include <QPainterPath>
+#include <QPointer>
 #include <QTextStream>
+#include <QVector2D>
+#include <QVector4D>
+#include <QtConcurrent>
 
 #include <algorithm>
+#include <cmath>
 
 Q_DECLARE_METATYPE(QPainterPath)
 
@@ -26,12 +32,69 @@ static void ensureResources()
     Q_INIT_RESOURCE(scissor);
 }
 
+// rasterized clip paths kept around for windows switching back and forth between paths,
+// bounded by count and by memory since every resize step of a large window adds a full mask
+static const int s_maxClipMasks = 16;
+static const qint64 s_maxClipMaskBytes = 64 * 1024 * 1024;
+// transparent border of the corner tiles, clamping to it hides everything outside the path
+static const int s_cornerPadding = 2;
+
+static QImage rasterizeClipMask(const QPainterPath &path, const QSize &size)
+{
+    QImage maskImage(size * 2, QImage::Format_RGBA8888);
+    maskImage.fill(QColor(0, 0, 0, 0));
+    QPainter pa(&maskImage);
+    pa.setRenderHint(QPainter::Antialiasing);
+    pa.scale(2, 2);
+    pa.fillPath(path, QColor(255, 255, 255, 255));
+    pa.strokePath(path, QPen(QColor(80, 80, 80, 60), 2));
+    pa.end();
+    return maskImage;
+}
+
+static qint64 maskImageBytes(const QSize &size)
+{
+    // masks are rasterized at twice the window size with four bytes per pixel
+    return qint64(size.width()) * size.height() * 4 * 4;
+}
+
+static QImage rasterizeCornerMask(qreal radius)
+{
+    // the top left corner of a rounded rectangle, its edges run out of the tile so that
+    // clamping the texture continues them along the sides of the window
+    const int tile = std::ceil(radius) + s_cornerPadding;
+    QPainterPath path;
+    path.addRoundedRect(QRectF(s_cornerPadding, s_cornerPadding, tile * 2, tile * 2), radius, radius);
+    return rasterizeClipMask(path, QSize(tile, tile));
+}
+
+// Returns the radius if @p path has been built by QPainterPath::addRoundedRect(), 0 otherwise
+static qreal roundedRectRadius(const QPainterPath &path)
+{
+    if (path.elementCount() == 0) {
+        return 0;
+    }
+    // the rounded rectangle starts on a vertical edge, one radius below the top
+    const QRectF bounds = path.boundingRect();
+    const QPainterPath::Element first = path.elementAt(0);
+    const qreal radius = first.y - bounds.y();
+    if (!first.isMoveTo() || (first.x != bounds.left() && first.x != bounds.right())
+        || radius < 1 || radius * 2 > std::min(bounds.width(), bounds.height())) {
+        return 0;
+    }
+    QPainterPath roundedRect;
+    roundedRect.setFillRule(path.fillRule());
+    roundedRect.addRoundedRect(bounds, radius, radius);
+    return roundedRect == path ? radius : 0;
+}
+
 namespace KWin {
 
 ScissorWindow::ScissorWindow() : Effect() {
     ensureResources();
 
     m_maskShader = nullptr;
+    m_nineSliceMaskShader = nullptr;
 
     reconfigure(ReconfigureAll);
 
@@ -40,6 +103,11 @@ ScissorWindow::ScissorWindow() : Effect() {
                                                                      ":/effects/scissor/mask.frag"
                                                                   );
 
+    m_nineSliceMaskShader = ShaderManager::instance()->generateShaderFromFile(ShaderTrait::MapTexture,
+                                                                              QByteArray(),
+                                                                              ":/effects/scissor/mask_nineslice.frag"
+                                                                           );
+
     m_filletOptimizeShader = ShaderManager::instance()->generateShaderFromFile(ShaderTrait::MapTexture,
                                                                                QByteArray(),
                                                                                ":/effects/scissor/fillet.frag"
@@ -57,38 +125,47 @@ ScissorWindow::ScissorWindow() : Effect() {
 
 ScissorWindow::~ScissorWindow() {
     if (m_maskShader) delete m_maskShader;
+    if (m_nineSliceMaskShader) delete m_nineSliceMaskShader;
     if (m_filletOptimizeShader) delete m_filletOptimizeShader;
-    for (auto itr = m_texMaskMap.begin(); itr != m_texMaskMap.end(); itr++) {
-        delete itr->second;
-    }
-    m_texMaskMap.clear();
 }
 
 void ScissorWindow::reconfigure(ReconfigureFlags flags) {
     Q_UNUSED(flags)
 }
 
-void ScissorWindow::buildTextureMask(const QString& key, const QPointF& radius) {
-    QImage img(QSize(radius.x() * 2, radius.y() * 2), QImage::Format_RGBA8888);
-    img.fill(QColor(0, 0, 0, 0));
-    QPainter painter(&img);
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(QColor(255, 255, 255, 255));
-    painter.setRenderHint(QPainter::Antialiasing);
-    painter.drawEllipse(0, 0, radius.x() * 2, radius.y() * 2);
-
-    // Draw crosshairs to prevent subpixels
-    const auto center = img.rect().center();
-    painter.setPen(QColor(255, 255, 255, 255));
-    painter.setRenderHint(QPainter::Antialiasing, false);
-    painter.drawLine(center.x(), 0, center.x(), img.rect().bottom());
-    painter.drawLine(0, center.y(), img.rect().right(), center.y());
-
-    painter.end();
-
-    m_texMaskMap[key] = new GLTexture(img.copy(0, 0, radius.x(), radius.y()));
-    m_texMaskMap[key]->setFilter(GL_LINEAR);
-    m_texMaskMap[key]->setWrapMode(GL_CLAMP_TO_EDGE);
+void ScissorWindow::prePaintScreen(ScreenPrePaintData &data, std::chrono::milliseconds presentTime)
+{
+    // resolved once per frame rather than for every window
+    Effect *splitScreen = static_cast<EffectsHandlerImpl *>(effects)->findEffect(QStringLiteral("splitscreen"));
+    m_splitScreenActive = splitScreen && splitScreen->isActive();
+
+    effects->prePaintScreen(data, presentTime);
+}
+
+QPointF ScissorWindow::cornerRadius(EffectWindow *w) const
+{
+    const QVariant valueRadius = w->data(WindowRadiusRole);
+    if (valueRadius.isValid()) {
+        const QPointF cornerRadius = valueRadius.toPointF();
+        const qreal xMin{ std::min(cornerRadius.x(), w->width() / 2.0) };
+        const qreal yMin{ std::min(cornerRadius.y(), w->height() / 2.0) };
+        const qreal minRadius{ std::min(xMin, yMin) };
+        return QPointF(minRadius, minRadius);
+    }
+    if (m_splitScreenActive && !(w->isDesktop() || w->isDock())) {
+        return QPointF(8, 8);
+    }
+    return QPointF();
+}
+
+static QRegion cornerRegion(const QRect &rect, const QSize &corner)
+{
+    QRegion corners;
+    corners += QRect(rect.topLeft(), corner);
+    corners += QRect(QPoint(rect.x() + rect.width() - corner.width(), rect.y()), corner);
+    corners += QRect(QPoint(rect.x(), rect.y() + rect.height() - corner.height()), corner);
+    corners += QRect(QPoint(rect.x() + rect.width() - corner.width(), rect.y() + rect.height() - corner.height()), corner);
+    return corners;
 }
 
 void ScissorWindow::prePaintWindow(EffectWindow *w, WindowPrePaintData &data,
@@ -98,10 +175,19 @@ void ScissorWindow::prePaintWindow(EffectWindow *w, WindowPrePaintData &data,
         return effects->prePaintWindow(w, data, time);
     }
 
-    {
+    if (w->data(WindowClipPathRole).isValid()) {
+        // the clip path can have any shape, the window doesn't hide anything beneath it
         QRect geo(w->frameGeometry());
         data.paint += geo;
         data.clip -= geo;
+    } else {
+        // only the rounded corners let the windows beneath show through
+        const QPointF radius = cornerRadius(w);
+        if (radius.x() >= 2 || radius.y() >= 2) {
+            const QSize corner(std::ceil(radius.x()), std::ceil(radius.y()));
+            data.clip -= cornerRegion(w->frameGeometry(), corner);
+            data.clip -= cornerRegion(w->bufferGeometry(), corner);
+        }
     }
 
     effects->prePaintWindow(w, data, time);
@@ -114,44 +200,33 @@ void ScissorWindow::drawWindow(EffectWindow *w, int mask, const QRegion& region,
 
     if (const auto &data_clip_path = w->data(WindowClipPathRole); data_clip_path.isValid()) {
         const QPainterPath path = qvariant_cast<QPainterPath>(data_clip_path);
-        static const int extraWindowFrame = 100;
-
-        if (!m_clipMaskMap.count(w) || m_clipMaskMap[w].maskPath != path) {
-            QImage maskImage(w->size() * 2, QImage::Format_RGBA8888);
-            maskImage.fill(QColor(0, 0, 0, 0));
-            QPainter pa(&maskImage);
-            pa.setRenderHint(QPainter::Antialiasing);
-            pa.scale(2, 2);
-            pa.fillPath(path, QColor(255, 255, 255, 255));
-            pa.strokePath(path, QPen(QColor(80, 80, 80, 60), 2));
-            pa.end();
-
-            m_clipMaskMap[w] = WindowMaskCache {
-                .maskPath = path,
-                .maskTexture = std::make_shared<GLTexture>(maskImage),
-            };
-
-            m_clipMaskMap[w].maskTexture->setFilter(GL_LINEAR);
-            m_clipMaskMap[w].maskTexture->setWrapMode(GL_CLAMP_TO_EDGE);
-        }
 
-        const WindowMaskCache& cache = m_clipMaskMap[w];
+        GLShader *shader = m_maskShader;
+        std::shared_ptr<GLTexture> maskTexture;
+        if (const qreal radius = roundedRectRadius(path); radius > 0) {
+            // the corner tile is stretched along the sides, so a resize needs no new mask
+            const QRectF bounds = path.boundingRect();
+            maskTexture = cornerMask(radius);
+            shader = m_nineSliceMaskShader;
+            ShaderManager::instance()->pushShader(shader);
+            shader->setUniform("size", QVector2D(w->width(), w->height()));
+            shader->setUniform("rect", QVector4D(bounds.x(), bounds.y(), bounds.width(), bounds.height()));
+            shader->setUniform("tile", float(std::ceil(radius) + s_cornerPadding));
+            shader->setUniform("padding", float(s_cornerPadding));
+        } else {
+            maskTexture = clipMask(w, path);
+            ShaderManager::instance()->pushShader(shader);
+        }
 
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-        QRect rect = w->rect();
-        rect.adjust(-extraWindowFrame, -extraWindowFrame, extraWindowFrame, extraWindowFrame);
-
         {
-            auto shader = m_maskShader;
-            ShaderManager::instance()->pushShader(shader);
             shader->setUniform("sampler", 0);
             shader->setUniform("msk1", 2);
             auto old_shader = data.shader;
             data.shader = shader;
 
-            std::shared_ptr<GLTexture> maskTexture = cache.maskTexture;
             glActiveTexture(GL_TEXTURE2); maskTexture->bind();
 
             glActiveTexture(GL_TEXTURE0);
@@ -168,25 +243,12 @@ void ScissorWindow::drawWindow(EffectWindow *w, int mask, const QRegion& region,
 
         return;
     } else {
-        QPointF cornerRadius;
-        const QVariant valueRadius = w->data(WindowRadiusRole);
-        if (valueRadius.isValid()) {
-            cornerRadius = w->data(WindowRadiusRole).toPointF();
-            const qreal xMin{ std::min(cornerRadius.x(), w->width() / 2.0) };
-            const qreal yMin{ std::min(cornerRadius.y(), w->height() / 2.0) };
-            const qreal minRadius{ std::min(xMin, yMin) };
-            cornerRadius = QPointF(minRadius, minRadius);
-        } else {
-            if (!(w->isDesktop() || w->isDock())) {
-                EffectsHandlerImpl *effs = static_cast<EffectsHandlerImpl *>(effects);
-                auto e = effs->findEffect("splitscreen");
-                if (e && e->isActive()) {
-                    auto geom = effects->findScreen(w->screen()->name())->geometry();
-                    if ((w->x() + data.xTranslation() == geom.x()) || (w->x() + data.xTranslation() + w->width() * data.xScale() == geom.x() + geom.width())) {
-                    }
-                    else
-                        cornerRadius = {8, 8};
-                }
+        QPointF cornerRadius = this->cornerRadius(w);
+        if (!w->data(WindowRadiusRole).isValid() && m_splitScreenActive) {
+            // no rounded corners along the edges of the screen
+            const QRect geom = w->screen()->geometry();
+            if ((w->x() + data.xTranslation() == geom.x()) || (w->x() + data.xTranslation() + w->width() * data.xScale() == geom.x() + geom.width())) {
+                cornerRadius = QPointF();
             }
         }
 
@@ -194,17 +256,11 @@ void ScissorWindow::drawWindow(EffectWindow *w, int mask, const QRegion& region,
             return effects->drawWindow(w, mask, region, data);
         }
 
-        const QString& key = QString("%1+%2").arg(cornerRadius.toPoint().x()).arg(cornerRadius.toPoint().y()
-        );
-        if (!m_texMaskMap.count(key)) {
-            buildTextureMask(key, cornerRadius);
-        }
-
         ShaderManager::instance()->pushShader(m_filletOptimizeShader);
         m_filletOptimizeShader->setUniform("typ1", 1);
         m_filletOptimizeShader->setUniform("sampler", 0);
-        m_filletOptimizeShader->setUniform("msk1", 1);
         m_filletOptimizeShader->setUniform("k", QVector2D(w->width() / cornerRadius.x(), w->height() / cornerRadius.y()));
+        m_filletOptimizeShader->setUniform("radius", float(cornerRadius.x()));
         if (w->hasDecoration()) {
             m_filletOptimizeShader->setUniform("typ2", 0);
         } else {
@@ -213,19 +269,110 @@ void ScissorWindow::drawWindow(EffectWindow *w, int mask, const QRegion& region,
         auto old_shader = data.shader;
         data.shader = m_filletOptimizeShader;
 
-        glActiveTexture(GL_TEXTURE1);
-        m_texMaskMap[key]->bind();
-        glActiveTexture(GL_TEXTURE0);
         effects->drawWindow(w, mask, region, data);
         ShaderManager::instance()->popShader();
         data.shader = old_shader;
-        glActiveTexture(GL_TEXTURE1);
-        m_texMaskMap[key]->unbind();
-        glActiveTexture(GL_TEXTURE0);
         return;
     }
 }
 
+std::shared_ptr<GLTexture> ScissorWindow::clipMask(EffectWindow *w, const QPainterPath &path)
+{
+    WindowMaskCache &cache = m_clipMaskMap[w];
+    const QSize size = w->size();
+    if (cache.maskTexture && cache.maskSize == size && cache.maskPath == path) {
+        return cache.maskTexture;
+    }
+
+    auto it = std::find_if(m_clipMasks.begin(), m_clipMasks.end(), [&path, &size](const ClipMask &mask) {
+        return mask.size == size && mask.path == path;
+    });
+    if (it == m_clipMasks.end()) {
+        if (cache.maskTexture) {
+            // keep showing the previous mask until the new one is ready
+            if (!cache.pending) {
+                requestClipMask(w, path, size);
+            }
+            return cache.maskTexture;
+        }
+        // there is nothing to show in the meantime
+        m_clipMasks.append(ClipMask{path, size, rasterizeClipMask(path, size), nullptr});
+        it = m_clipMasks.end() - 1;
+    }
+
+    if (!it->texture) {
+        it->texture = std::make_shared<GLTexture>(it->image);
+        it->texture->setFilter(GL_LINEAR);
+        it->texture->setWrapMode(GL_CLAMP_TO_EDGE);
+        it->image = QImage();
+    }
+    cache.maskPath = path;
+    cache.maskSize = size;
+    cache.maskTexture = it->texture;
+
+    std::rotate(it, it + 1, m_clipMasks.end());
+    trimClipMasks();
+    return cache.maskTexture;
+}
+
+void ScissorWindow::requestClipMask(EffectWindow *w, const QPainterPath &path, const QSize &size)
+{
+    // one job per window at a time, a window that keeps changing its path while the job runs
+    // gets the latest one rasterized next
+    m_clipMaskMap[w].pending = true;
+
+    auto watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, window = QPointer<EffectWindow>(w), path, size]() {
+        watcher->deleteLater();
+        m_clipMasks.append(ClipMask{path, size, watcher->result(), nullptr});
+        trimClipMasks();
+        if (!window) {
+            return;
+        }
+        auto it = m_clipMaskMap.find(window.data());
+        if (it != m_clipMaskMap.end()) {
+            it->second.pending = false;
+        }
+        window->addRepaintFull();
+    });
+    watcher->setFuture(QtConcurrent::run(rasterizeClipMask, path, size));
+}
+
+int ScissorWindow::clipMaskCount() const
+{
+    return m_clipMasks.count();
+}
+
+qint64 ScissorWindow::clipMaskBytes() const
+{
+    qint64 bytes = 0;
+    for (const ClipMask &mask : m_clipMasks) {
+        bytes += maskImageBytes(mask.size);
+    }
+    return bytes;
+}
+
+void ScissorWindow::trimClipMasks()
+{
+    qint64 bytes = clipMaskBytes();
+    // drop the least recently used masks, the newest one stays even if it alone is over budget
+    while (m_clipMasks.count() > 1 && (m_clipMasks.count() > s_maxClipMasks || bytes > s_maxClipMaskBytes)) {
+        bytes -= maskImageBytes(m_clipMasks.first().size);
+        m_clipMasks.removeFirst();
+    }
+}
+
+std::shared_ptr<GLTexture> ScissorWindow::cornerMask(qreal radius)
+{
+    std::shared_ptr<GLTexture> &texture = m_cornerMasks[radius];
+    if (!texture) {
+        texture = std::make_shared<GLTexture>(rasterizeCornerMask(radius));
+        texture->setFilter(GL_LINEAR);
+        texture->setWrapMode(GL_CLAMP_TO_EDGE);
+    }
+    return texture;
+}
+
 bool ScissorWindow::enabledByDefault() { return supported(); }
 
 bool ScissorWindow::supported() {
@@ -242,14 +389,14 @@ void ScissorWindow::windowDeleted(EffectWindow *w) {
 }
 
 bool ScissorWindow::isMaximized(EffectWindow *w) {
-    auto geom = effects->findScreen(w->screen()->name())->geometry();
+    const QRect geom = w->screen()->geometry();
     return (w->x() == geom.x() && w->width() == geom.width()) &&
            (w->y() == geom.y() && w->height() == geom.height());
 }
 
 bool ScissorWindow::isMaximized(EffectWindow *w, const PaintData& data)
 {
-    auto geom = effects->findScreen(w->screen()->name())->geometry();
+    const QRect geom = w->screen()->geometry();
     return (w->x() + data.xTranslation() == geom.x() && w->width() * data.xScale() == geom.width()) ||
             (w->y() + data.yTranslation() == geom.y() && w->height() * data.yScale() == geom.height());
 }
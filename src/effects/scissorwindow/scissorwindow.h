@@ -6,7 +6,9 @@
 
 #include <deepin_kwineffects.h>
 
+#include <QImage>
 #include <QPainterPath>
+#include <QVector>
 
 #include <map>
 #include <memory>
@@ -18,10 +20,22 @@ namespace KWin {
 class ScissorWindow : public Effect
 {
     Q_OBJECT
+    Q_PROPERTY(int clipMaskCount READ clipMaskCount)
+    Q_PROPERTY(qint64 clipMaskBytes READ clipMaskBytes)
 
     struct WindowMaskCache {
         QPainterPath maskPath;
+        QSize maskSize;
         std::shared_ptr<GLTexture> maskTexture;
+        // a newer mask is being rasterized, the one above is used until it is done
+        bool pending = false;
+    };
+
+    struct ClipMask {
+        QPainterPath path;
+        QSize size;
+        QImage image;
+        std::shared_ptr<GLTexture> texture;
     };
 
 public:
@@ -46,12 +60,15 @@ public:
 
     void reconfigure(ReconfigureFlags flags) override;
 
-    void buildTextureMask(const QString& key, const QPointF& radius);
-
+    void prePaintScreen(ScreenPrePaintData &data, std::chrono::milliseconds presentTime) override;
     void prePaintWindow(EffectWindow* w, WindowPrePaintData& data, std::chrono::milliseconds time) override;
 
     void drawWindow(EffectWindow* w, int mask, const QRegion& region, WindowPaintData& data) override;
 
+    // the rasterized clip paths shared by all windows
+    int clipMaskCount() const;
+    qint64 clipMaskBytes() const;
+
 protected Q_SLOTS:
     void windowAdded(EffectWindow *window);
     void windowDeleted(EffectWindow *window);
@@ -59,10 +76,21 @@ protected Q_SLOTS:
 private:
     enum { TopLeft = 0, TopRight, BottomRight, BottomLeft, NCorners };
 
+    QPointF cornerRadius(EffectWindow *w) const;
+    std::shared_ptr<GLTexture> clipMask(EffectWindow *w, const QPainterPath &path);
+    std::shared_ptr<GLTexture> cornerMask(qreal radius);
+    void requestClipMask(EffectWindow *w, const QPainterPath &path, const QSize &size);
+    void trimClipMasks();
+
     GLShader *m_maskShader;
+    GLShader *m_nineSliceMaskShader;
     GLShader *m_filletOptimizeShader;
-    std::map<QString, GLTexture*> m_texMaskMap;
     std::map<EffectWindow*, WindowMaskCache> m_clipMaskMap;
+    // rasterized clip paths shared by all windows, the most recently used one last
+    QVector<ClipMask> m_clipMasks;
+    // corner tiles of rounded rectangle clip paths by radius
+    std::map<qreal, std::shared_ptr<GLTexture>> m_cornerMasks;
+    bool m_splitScreenActive = false;
 };
 
 }
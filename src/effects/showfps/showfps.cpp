@@ -18,10 +18,12 @@
 
 #include <KLocalizedString>
 
+#include <QFontMetrics>
 #include <QPainter>
 #include <QVector2D>
 #include <QPalette>
 
+#include <algorithm>
 #include <cmath>
 
 namespace KWin
@@ -29,6 +31,7 @@ namespace KWin
 
 const int FPS_WIDTH = 10;
 const int MAX_TIME = 100;
+const int MAX_COST_LINES = 5;
 
 ShowFpsEffect::ShowFpsEffect()
     : paints_pos(0)
@@ -49,10 +52,12 @@ ShowFpsEffect::ShowFpsEffect()
     m_noBenchmark->setAlignment(Qt::AlignTop | Qt::AlignRight);
     m_noBenchmark->setText(i18n("This effect is not a benchmark"));
     reconfigure(ReconfigureAll);
+    effectsEx->beginEffectProfiling();
 }
 
 ShowFpsEffect::~ShowFpsEffect()
 {
+    effectsEx->endEffectProfiling();
 }
 
 void ShowFpsEffect::reconfigure(ReconfigureFlags)
@@ -73,6 +78,15 @@ void ShowFpsEffect::reconfigure(ReconfigureFlags)
     fps_rect = QRect(x, y, FPS_WIDTH + 2 * NUM_PAINTS, MAX_TIME);
     m_noBenchmark->setPosition(fps_rect.bottomRight() + QPoint(-6, 6));
 
+    // the effect costs go above the graph, or below it if there is no room
+    const int costHeight = MAX_COST_LINES * QFontMetrics(QFont()).height();
+    if (fps_rect.y() >= costHeight) {
+        m_costRect = QRect(fps_rect.x(), fps_rect.y() - costHeight, fps_rect.width(), costHeight);
+    } else {
+        m_costRect = QRect(fps_rect.x(), fps_rect.bottom() + 1, fps_rect.width(), costHeight);
+    }
+    m_costText.reset();
+
     int textPosition = ShowFpsConfig::textPosition();
     textFont = ShowFpsConfig::textFont();
     textColor = ShowFpsConfig::textColor();
@@ -115,8 +129,12 @@ void ShowFpsEffect::prePaintScreen(ScreenPrePaintData& data, std::chrono::millis
     frames[ frames_pos ] = QDateTime::currentMSecsSinceEpoch();
     if (++frames_pos == MAX_FPS)
         frames_pos = 0;
+    if (!m_costTimer.isValid() || m_costTimer.elapsed() >= 1000) {
+        updateEffectCosts();
+    }
     effects->prePaintScreen(data, presentTime);
     data.paint += fps_rect;
+    data.paint += m_costRect;
 
     paint_size[ paints_pos ] = 0;
     t.restart();
@@ -234,6 +252,20 @@ void ShowFpsEffect::paintGL(int fps, const QMatrix4x4 &projectionMatrix)
         effects->addRepaint(fpsTextRect);
     }
 
+    // Paint the most expensive effects, the texture only changes once per second
+    if (!m_costLines.isEmpty()) {
+        if (!m_costText) {
+            m_costText.reset(new GLTexture(effectCostsImage()));
+        }
+        m_costText->bind();
+        ShaderBinder binder(ShaderTrait::MapTexture);
+        QMatrix4x4 mvp = projectionMatrix;
+        mvp.translate(m_costRect.x(), m_costRect.y());
+        binder.shader()->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
+        m_costText->render(QRegion(m_costRect), m_costRect);
+        m_costText->unbind();
+    }
+
     // Paint paint sizes
     glDisable(GL_BLEND);
 }
@@ -268,6 +300,13 @@ void ShowFpsEffect::paintQPainter(int fps)
     painter->setPen(Qt::black);
     painter->drawText(fpsTextRect, textAlign, QString::number(fps));
 
+    // Paint the most expensive effects
+    if (!m_costLines.isEmpty()) {
+        painter->setFont(QFont());
+        painter->setPen(textColor);
+        painter->drawText(m_costRect, Qt::AlignTop | Qt::AlignLeft, m_costLines.join(QLatin1Char('\n')));
+    }
+
     painter->restore();
 }
 
@@ -398,6 +437,52 @@ void ShowFpsEffect::postPaintScreen()
     if (++paints_pos == NUM_PAINTS)
         paints_pos = 0;
     effects->addRepaint(fps_rect);
+    effects->addRepaint(m_costRect);
+}
+
+void ShowFpsEffect::updateEffectCosts()
+{
+    const qreal seconds = m_costTimer.isValid() ? m_costTimer.restart() / 1000.0 : 0;
+    if (!m_costTimer.isValid()) {
+        m_costTimer.start();
+    }
+
+    struct Load
+    {
+        QString name;
+        qreal milliseconds;
+    };
+    QVector<Load> loads;
+    const QVector<EffectCost> costs = effectsEx->effectCosts();
+    for (const EffectCost &cost : costs) {
+        const EffectCost previous = m_previousCosts.value(cost.name);
+        m_previousCosts.insert(cost.name, cost);
+        const auto time = (cost.cpuTime - previous.cpuTime) + (cost.gpuTime - previous.gpuTime);
+        if (seconds > 0 && time.count() > 0) {
+            loads.append(Load{cost.name, time.count() / 1e6 / seconds});
+        }
+    }
+    std::sort(loads.begin(), loads.end(), [](const Load &a, const Load &b) {
+        return a.milliseconds > b.milliseconds;
+    });
+
+    m_costLines.clear();
+    for (int i = 0; i < std::min<int>(loads.count(), MAX_COST_LINES); ++i) {
+        m_costLines.append(i18nc("Effect name and time spent per second", "%1: %2 ms/s",
+                                 loads[i].name, QString::number(loads[i].milliseconds, 'f', 1)));
+    }
+    m_costText.reset();
+}
+
+QImage ShowFpsEffect::effectCostsImage() const
+{
+    QImage im(m_costRect.size(), QImage::Format_ARGB32_Premultiplied);
+    im.fill(Qt::transparent);
+    QPainter painter(&im);
+    painter.setPen(textColor);
+    painter.drawText(im.rect(), Qt::AlignTop | Qt::AlignLeft, m_costLines.join(QLatin1Char('\n')));
+    painter.end();
+    return im;
 }
 
 QImage ShowFpsEffect::fpsTextImage(int fps)
@@ -12,8 +12,10 @@
 
 #include <QElapsedTimer>
 #include <QFont>
+#include <QHash>
 
 #include <deepin_kwineffects.h>
+#include <deepin_kwineffectsex.h>
 
 
 namespace KWin
@@ -78,6 +80,8 @@ private:
     void paintDrawSizeGraph(int x, int y);
     void paintGraph(int x, int y, QList<int> values, QList<int> lines, bool colorize);
     QImage fpsTextImage(int fps);
+    void updateEffectCosts();
+    QImage effectCostsImage() const;
     QElapsedTimer t;
     enum {
         NUM_PAINTS = 100,
@@ -101,6 +105,12 @@ private:
     QRect fpsTextRect;
     int textAlign;
     QScopedPointer<EffectFrame> m_noBenchmark;
+    // the most expensive effects over the last second, refreshed once per second
+    QElapsedTimer m_costTimer;
+    QHash<QString, EffectCost> m_previousCosts;
+    QStringList m_costLines;
+    QRect m_costRect;
+    QScopedPointer<GLTexture> m_costText;
 };
 
 } // namespace
@@ -165,16 +165,7 @@ bool Workspace::workspaceEvent(xcb_generic_event_t *e)
 
     const xcb_window_t eventWindow = findEventWindow(e);
     if (eventWindow != XCB_WINDOW_NONE) {
-        if (X11Client *c = findClient(Predicate::WindowMatch, eventWindow)) {
-            if (c->windowEvent(e))
-                return true;
-        } else if (X11Client *c = findClient(Predicate::WrapperIdMatch, eventWindow)) {
-            if (c->windowEvent(e))
-                return true;
-        } else if (X11Client *c = findClient(Predicate::FrameIdMatch, eventWindow)) {
-            if (c->windowEvent(e))
-                return true;
-        } else if (X11Client *c = findClient(Predicate::InputIdMatch, eventWindow)) {
+        if (X11Client *c = findClientOwningWindow(eventWindow)) {
             if (c->windowEvent(e))
                 return true;
         } else if (Unmanaged* c = findUnmanaged(eventWindow)) {
@@ -1079,7 +1070,7 @@ bool X11Client::motionNotifyEvent(xcb_window_t w, int state, int x, int y, int x
     }
     handleInteractiveMoveResize(QPoint(x, y), QPoint(x_root, y_root));
     if (isInteractiveMove()) {
-        ScreenEdges::self()->check(QPoint(x_root, y_root), QDateTime::fromMSecsSinceEpoch(xTime(), Qt::UTC));
+        ScreenEdges::self()->check(QPoint(x_root, y_root), std::chrono::milliseconds(xTime()));
     }
 
     return true;
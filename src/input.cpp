@@ -18,6 +18,7 @@
 #include "input_event.h"
 #include "input_event_spy.h"
 #include "inputbackend.h"
+#include "inputlatencytracker.h"
 #include "inputmethod.h"
 #include "keyboard_input.h"
 #include "main.h"
@@ -61,6 +62,7 @@
 #include <QDBusConnection>
 #include <QDBusMessage>
 #include <QDBusPendingCall>
+#include <QDateTime>
 #include <QKeyEvent>
 #include <QThread>
 #include <qpa/qwindowsysteminterface.h>
@@ -1583,6 +1585,7 @@ public:
         default:
             break;
         }
+        InputLatencyTracker::self()->notifyDelivered(seat->focusedPointerSurface());
         return true;
     }
     bool wheelEvent(QWheelEvent *event) override {
@@ -1595,6 +1598,7 @@ public:
         ddeSeat->pointerAxis(_event->orientation(),
                 _event->orientation() == Qt::Horizontal ? event->angleDelta().x() : event->angleDelta().y());
         seat->notifyPointerFrame();
+        InputLatencyTracker::self()->notifyDelivered(seat->focusedPointerSurface());
         return true;
     }
 
@@ -1677,6 +1681,7 @@ public:
 
         seat->setTimestamp(event->timestamp());
         passToWaylandServer(event);
+        InputLatencyTracker::self()->notifyDelivered(seat->focusedKeyboardSurface());
 
         if (steal_focus && old) {
             auto seat = waylandServer()->seat();
@@ -1689,12 +1694,14 @@ public:
         auto seat = waylandServer()->seat();
         seat->setTimestamp(time);
         seat->notifyTouchDown(id, pos);
+        InputLatencyTracker::self()->notifyDelivered(seat->focusedTouchSurface());
         return true;
     }
     bool touchMotion(qint32 id, const QPointF &pos, quint32 time) override {
         auto seat = waylandServer()->seat();
         seat->setTimestamp(time);
         seat->notifyTouchMotion(id, pos);
+        InputLatencyTracker::self()->notifyDelivered(seat->focusedTouchSurface());
         return true;
     }
     bool touchUp(qint32 id, quint32 time) override {
@@ -2408,6 +2415,7 @@ InputRedirection::InputRedirection(QObject *parent)
     qRegisterMetaType<KWin::InputRedirection::KeyboardKeyState>();
     qRegisterMetaType<KWin::InputRedirection::PointerButtonState>();
     qRegisterMetaType<KWin::InputRedirection::PointerAxis>();
+    InputLatencyTracker::create(this);
     setupInputBackends();
     connect(kwinApp(), &Application::workspaceCreated, this, &InputRedirection::setupWorkspace);
 
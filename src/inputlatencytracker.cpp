@@ -0,0 +1,147 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "inputlatencytracker.h"
+#include "inputdevice.h"
+#include "performancemonitor.h"
+
+#include <DWayland/Server/surface_interface.h>
+
+#include <algorithm>
+
+namespace KWin
+{
+
+// events that are not on screen after this long are not waiting for a frame of their own
+static const std::chrono::nanoseconds s_maxLatency = std::chrono::seconds(1);
+// bounds the backlog if the client or the outputs stop presenting altogether
+static const int s_maxPendingEvents = 256;
+
+KWIN_SINGLETON_FACTORY(InputLatencyTracker)
+
+InputLatencyTracker::InputLatencyTracker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+InputLatencyTracker::~InputLatencyTracker()
+{
+    s_self = nullptr;
+}
+
+bool InputLatencyTracker::beginEvent(InputDevice *device, std::chrono::nanoseconds timestamp)
+{
+    // nested dispatch, e.g. from a nested event loop, is accounted to the outer event
+    if (!device || m_dispatching) {
+        return false;
+    }
+    m_dispatching = true;
+    m_currentDevice = device->name();
+    m_currentTimestamp = timestamp;
+    return true;
+}
+
+void InputLatencyTracker::endEvent()
+{
+    const PendingEvent event{m_currentDevice, m_currentTimestamp, std::chrono::nanoseconds::zero()};
+
+    for (KWaylandServer::SurfaceInterface *surface : qAsConst(m_currentSurfaces)) {
+        auto it = m_awaitingCommit.find(surface);
+        if (it == m_awaitingCommit.end()) {
+            it = m_awaitingCommit.insert(surface, {});
+            connect(surface, &KWaylandServer::SurfaceInterface::committed, this, [this, surface]() {
+                handleSurfaceCommitted(surface);
+            });
+            connect(surface, &QObject::destroyed, this, [this, surface]() {
+                forgetSurface(surface);
+            });
+        }
+        if (it->count() == s_maxPendingEvents) {
+            it->removeFirst();
+        }
+        it->append(event);
+    }
+
+    // the compositor reacted to the event itself
+    if (m_currentSurfaces.isEmpty() && m_currentRepaintScheduled) {
+        if (m_awaitingFrame.count() == s_maxPendingEvents) {
+            m_awaitingFrame.removeFirst();
+        }
+        m_awaitingFrame.append(PendingEvent{event.device, event.timestamp, currentTimestamp()});
+    }
+
+    m_dispatching = false;
+    m_currentSurfaces.clear();
+    m_currentRepaintScheduled = false;
+}
+
+void InputLatencyTracker::notifyDelivered(KWaylandServer::SurfaceInterface *surface)
+{
+    if (m_dispatching && surface && !m_currentSurfaces.contains(surface)) {
+        m_currentSurfaces.append(surface);
+    }
+}
+
+void InputLatencyTracker::notifyRepaintScheduled()
+{
+    if (m_dispatching) {
+        m_currentRepaintScheduled = true;
+    }
+}
+
+void InputLatencyTracker::handleSurfaceCommitted(KWaylandServer::SurfaceInterface *surface)
+{
+    const QVector<PendingEvent> events = m_awaitingCommit.value(surface);
+    forgetSurface(surface);
+
+    const std::chrono::nanoseconds now = currentTimestamp();
+    for (const PendingEvent &event : events) {
+        if (m_awaitingFrame.count() == s_maxPendingEvents) {
+            m_awaitingFrame.removeFirst();
+        }
+        m_awaitingFrame.append(PendingEvent{event.device, event.timestamp, now});
+    }
+}
+
+void InputLatencyTracker::forgetSurface(KWaylandServer::SurfaceInterface *surface)
+{
+    if (m_awaitingCommit.remove(surface)) {
+        disconnect(surface, nullptr, this, nullptr);
+    }
+}
+
+void InputLatencyTracker::notifyFramePresented(std::chrono::nanoseconds frameStartTimestamp, std::chrono::nanoseconds presentationTimestamp)
+{
+    PerformanceMonitor *monitor = PerformanceMonitor::self();
+    auto it = m_awaitingFrame.begin();
+    while (it != m_awaitingFrame.end()) {
+        if (it->readyTimestamp > frameStartTimestamp) {
+            // not part of this frame yet
+            ++it;
+            continue;
+        }
+        const std::chrono::nanoseconds latency = presentationTimestamp - it->timestamp;
+        if (monitor && latency >= std::chrono::nanoseconds::zero() && latency < s_maxLatency) {
+            monitor->inputLatency(it->device)->record(latency);
+        }
+        it = m_awaitingFrame.erase(it);
+    }
+
+    // clients are not required to react to every event, e.g. key releases
+    const std::chrono::nanoseconds expired = presentationTimestamp - s_maxLatency;
+    for (auto surface = m_awaitingCommit.begin(); surface != m_awaitingCommit.end();) {
+        QVector<PendingEvent> &events = surface.value();
+        events.erase(std::remove_if(events.begin(), events.end(), [expired](const PendingEvent &event) {
+                         return event.timestamp < expired;
+                     }),
+                     events.end());
+        if (events.isEmpty()) {
+            disconnect(surface.key(), nullptr, this, nullptr);
+            surface = m_awaitingCommit.erase(surface);
+        } else {
+            ++surface;
+        }
+    }
+}
+
+} // namespace KWin
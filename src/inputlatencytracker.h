@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <deepin_kwinglobals.h>
+
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+#include <chrono>
+
+namespace KWaylandServer
+{
+class SurfaceInterface;
+}
+
+namespace KWin
+{
+
+class InputDevice;
+
+/**
+ * The InputLatencyTracker class measures the time from the moment an input event is read
+ * from its device until the first frame that reflects it has been presented.
+ *
+ * Input backends open a Scope around the dispatch of every event, stamped with the time the
+ * event was read. While the scope is open the event runs through the input filters. If it
+ * is delivered to a client, the tracker waits for the client's surface to commit. If it is
+ * consumed by the compositor and schedules a repaint, it is ready right away. Otherwise the
+ * event has no visible effect and is not measured.
+ *
+ * A ready event is accounted to the first frame that started after it became ready and has
+ * been presented on any output. The latencies are recorded per device in the
+ * PerformanceMonitor.
+ */
+class KWIN_EXPORT InputLatencyTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~InputLatencyTracker() override;
+
+    class Scope
+    {
+    public:
+        Scope(InputDevice *device, std::chrono::nanoseconds timestamp);
+        ~Scope();
+
+    private:
+        bool m_active = false;
+    };
+
+    /**
+     * Notifies the tracker that the current event has been sent to @a surface.
+     */
+    void notifyDelivered(KWaylandServer::SurfaceInterface *surface);
+    void notifyRepaintScheduled();
+    void notifyFramePresented(std::chrono::nanoseconds frameStartTimestamp, std::chrono::nanoseconds presentationTimestamp);
+
+    static std::chrono::nanoseconds currentTimestamp();
+
+private:
+    struct PendingEvent
+    {
+        QString device;
+        std::chrono::nanoseconds timestamp;
+        std::chrono::nanoseconds readyTimestamp;
+    };
+
+    bool beginEvent(InputDevice *device, std::chrono::nanoseconds timestamp);
+    void endEvent();
+    void handleSurfaceCommitted(KWaylandServer::SurfaceInterface *surface);
+    void forgetSurface(KWaylandServer::SurfaceInterface *surface);
+
+    // the event that is currently dispatched
+    QString m_currentDevice;
+    std::chrono::nanoseconds m_currentTimestamp = std::chrono::nanoseconds::zero();
+    bool m_dispatching = false;
+    QVector<KWaylandServer::SurfaceInterface *> m_currentSurfaces;
+    bool m_currentRepaintScheduled = false;
+
+    QHash<KWaylandServer::SurfaceInterface *, QVector<PendingEvent>> m_awaitingCommit;
+    QVector<PendingEvent> m_awaitingFrame;
+
+    KWIN_SINGLETON(InputLatencyTracker)
+};
+
+inline InputLatencyTracker::Scope::Scope(InputDevice *device, std::chrono::nanoseconds timestamp)
+{
+    if (InputLatencyTracker *tracker = InputLatencyTracker::self()) {
+        m_active = tracker->beginEvent(device, timestamp);
+    }
+}
+
+inline InputLatencyTracker::Scope::~Scope()
+{
+    if (m_active) {
+        InputLatencyTracker::self()->endEvent();
+    }
+}
+
+inline std::chrono::nanoseconds InputLatencyTracker::currentTimestamp()
+{
+    return std::chrono::steady_clock::now().time_since_epoch();
+}
+
+} // namespace KWin
@@ -47,6 +47,7 @@ void Item::setZ(int z)
     if (m_parentItem) {
         m_parentItem->markSortedChildItemsDirty();
     }
+    markSubtreeDirty();
     scheduleRepaint(boundingRect());
 }
 
@@ -76,6 +77,7 @@ void Item::addChild(Item *item)
 
     m_childItems.append(item);
     markSortedChildItemsDirty();
+    markSubtreeDirty();
 
     updateBoundingRect();
     scheduleRepaint(item->boundingRect().translated(item->position()));
@@ -88,6 +90,7 @@ void Item::removeChild(Item *item)
 
     m_childItems.removeOne(item);
     markSortedChildItemsDirty();
+    markSubtreeDirty();
 
     updateBoundingRect();
 }
@@ -107,6 +110,7 @@ void Item::setPosition(const QPoint &point)
     if (m_position != point) {
         scheduleRepaint(boundingRect());
         m_position = point;
+        markSubtreeDirty();
         if (m_parentItem) {
             m_parentItem->updateBoundingRect();
         }
@@ -177,7 +181,10 @@ QMatrix4x4 Item::transform() const
 
 void Item::setTransform(const QMatrix4x4 &transform)
 {
-    m_transform = transform;
+    if (m_transform != transform) {
+        m_transform = transform;
+        markSubtreeDirty();
+    }
 }
 
 QRegion Item::mapToGlobal(const QRegion &region) const
@@ -213,6 +220,7 @@ void Item::stackBefore(Item *sibling)
 
     m_parentItem->m_childItems.move(selfIndex, selfIndex > siblingIndex ? siblingIndex : siblingIndex - 1);
     markSortedChildItemsDirty();
+    markSubtreeDirty();
 
     scheduleRepaint(boundingRect());
     sibling->scheduleRepaint(sibling->boundingRect());
@@ -241,6 +249,7 @@ void Item::stackAfter(Item *sibling)
 
     m_parentItem->m_childItems.move(selfIndex, selfIndex > siblingIndex ? siblingIndex + 1 : siblingIndex);
     markSortedChildItemsDirty();
+    markSubtreeDirty();
 
     scheduleRepaint(boundingRect());
     sibling->scheduleRepaint(sibling->boundingRect());
@@ -301,6 +310,7 @@ WindowQuadList Item::buildQuads() const
 void Item::discardQuads()
 {
     m_quads.reset();
+    markSubtreeDirty();
 }
 
 WindowQuadList Item::quads() const
@@ -352,6 +362,7 @@ void Item::updateEffectiveVisibility()
     }
 
     m_effectiveVisible = effectiveVisible;
+    markSubtreeDirty();
     scheduleRepaintInternal(boundingRect());
 
     for (Item *childItem : qAsConst(m_childItems)) {
@@ -379,4 +390,25 @@ void Item::markSortedChildItemsDirty()
     m_sortedChildItems.reset();
 }
 
+void Item::markSubtreeDirty()
+{
+    // If an item is dirty, all of its ancestors are dirty as well, so stop at the first one.
+    for (Item *item = this; item && !item->m_subtreeDirty; item = item->m_parentItem) {
+        item->m_subtreeDirty = true;
+    }
+}
+
+bool Item::isSubtreeDirty() const
+{
+    return m_subtreeDirty;
+}
+
+void Item::resetSubtreeDirty()
+{
+    m_subtreeDirty = false;
+    for (Item *childItem : qAsConst(m_childItems)) {
+        childItem->resetSubtreeDirty();
+    }
+}
+
 } // namespace KWin
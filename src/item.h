@@ -93,6 +93,18 @@ public:
     WindowQuadList quads() const;
     virtual void preprocess();
 
+    /**
+     * Returns @c true if the geometry, transform, quads, visibility or stacking order of
+     * this item or any of its descendants has changed since resetSubtreeDirty() was called.
+     *
+     * Surface damage does not mark the item dirty.
+     */
+    bool isSubtreeDirty() const;
+    /**
+     * Marks this item and all of its descendants as clean.
+     */
+    void resetSubtreeDirty();
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the position of this item has changed.
@@ -119,6 +131,7 @@ private:
     void updateBoundingRect();
     void scheduleRepaintInternal(const QRegion &region);
     void markSortedChildItemsDirty();
+    void markSubtreeDirty();
 
     bool computeEffectiveVisibility() const;
     void updateEffectiveVisibility();
@@ -133,6 +146,7 @@ private:
     int m_z = 0;
     bool m_visible = true;
     bool m_effectiveVisible = true;
+    bool m_subtreeDirty = true;
     QMap<AbstractOutput *, QRegion> m_repaints;
     mutable std::optional<WindowQuadList> m_quads;
     mutable std::optional<QList<Item *>> m_sortedChildItems;
@@ -65,6 +65,7 @@ AniData::AniData()
  , waitAtSource(false)
  , keepAlive(true)
  , lastPresentTime(std::chrono::milliseconds::zero())
+ , value(0.0)
 {
 }
 
@@ -82,6 +83,7 @@ AniData::AniData(AnimationEffect::Attribute a, int meta_, const FPx2 &to_,
  , keepAlive(keepAlive)
  , previousWindowPixmapLock(std::move(previousWindowPixmapLock_))
  , lastPresentTime(std::chrono::milliseconds::zero())
+ , value(0.0)
 {
 }
 
@@ -70,6 +70,15 @@ public:
 
     bool isActive() const;
 
+    /**
+     * Re-evaluates the easing curve and stores the result in @c value.
+     * Called once per frame for every animation, and whenever the timeline
+     * gets modified outside of the regular frame update.
+     */
+    inline void updateValue() {
+        value = timeLine.value();
+    }
+
     inline bool isOneDimensional() const {
         return from[0] == from[1] && to[0] == to[1];
     }
@@ -89,6 +98,7 @@ public:
     PreviousWindowPixmapLockPtr previousWindowPixmapLock;
     AnimationEffect::TerminationFlags terminationFlags;
     std::chrono::milliseconds lastPresentTime;
+    float value;
 };
 
 } // namespace
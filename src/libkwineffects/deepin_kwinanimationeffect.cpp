@@ -12,7 +12,9 @@
 #include "anidata_p.h"
 
 #include <QDateTime>
+#include <QHash>
 #include <QTimer>
+#include <QVarLengthArray>
 #include <QtDebug>
 #include <QVector3D>
 
@@ -27,6 +29,17 @@ QDebug operator<<(QDebug dbg, const KWin::FPx2 &fpx2)
 
 QElapsedTimer AnimationEffect::s_clock;
 
+/**
+ * All animations of one window together with the cached layer repaint rect.
+ */
+struct AniWindow
+{
+    EffectWindow *window = nullptr;
+    QVector<AniData> animations;
+    QRect layerRect;
+    bool pendingStart = false; // has delayed animations that were not accounted in layerRect yet
+};
+
 class AnimationEffectPrivate {
 public:
     AnimationEffectPrivate()
@@ -34,7 +47,18 @@ public:
         m_animationsTouched = m_isInitialized = false;
         m_justEndedAnimation = 0;
     }
-    AnimationEffect::AniMap m_animations;
+
+    int indexOf(const EffectWindow *w) const
+    {
+        return m_slots.value(w, -1);
+    }
+    AniWindow &windowFor(EffectWindow *w);
+    void removeAt(int index);
+    bool findAnimation(quint64 animationId, int *windowIndex, int *animationIndex) const;
+
+    // windows are kept in a dense array, m_slots maps a window to its position in it
+    QVector<AniWindow> m_windows;
+    QHash<const EffectWindow *, int> m_slots;
     static quint64 m_animCounter;
     quint64 m_justEndedAnimation; // protect against cancel
     QWeakPointer<FullScreenEffectLock> m_fullScreenEffectLock;
@@ -43,6 +67,44 @@ public:
 
 quint64 AnimationEffectPrivate::m_animCounter = 0;
 
+AniWindow &AnimationEffectPrivate::windowFor(EffectWindow *w)
+{
+    int index = indexOf(w);
+    if (index == -1) {
+        index = m_windows.count();
+        m_windows.append(AniWindow());
+        m_windows.last().window = w;
+        m_slots.insert(w, index);
+    }
+    return m_windows[index];
+}
+
+void AnimationEffectPrivate::removeAt(int index)
+{
+    m_slots.remove(m_windows.at(index).window);
+    const int last = m_windows.count() - 1;
+    if (index != last) {
+        m_windows[index] = std::move(m_windows[last]);
+        m_slots[m_windows.at(index).window] = index;
+    }
+    m_windows.removeLast();
+}
+
+bool AnimationEffectPrivate::findAnimation(quint64 animationId, int *windowIndex, int *animationIndex) const
+{
+    for (int i = 0; i < m_windows.count(); ++i) {
+        const QVector<AniData> &animations = m_windows.at(i).animations;
+        for (int j = 0; j < animations.count(); ++j) {
+            if (animations.at(j).id == animationId) {
+                *windowIndex = i;
+                *animationIndex = j;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 AnimationEffect::AnimationEffect() : d_ptr(new AnimationEffectPrivate())
 {
     Q_D(AnimationEffect);
@@ -75,7 +137,7 @@ void AnimationEffect::init()
 bool AnimationEffect::isActive() const
 {
     Q_D(const AnimationEffect);
-    return !d->m_animations.isEmpty() && !effects->isScreenLocked();
+    return !d->m_windows.isEmpty() && !effects->isScreenLocked();
 }
 
 
@@ -211,13 +273,10 @@ quint64 AnimationEffect::p_animate( EffectWindow *w, Attribute a, uint meta, int
     Q_D(AnimationEffect);
     if (!d->m_isInitialized)
         init(); // needs to ensure the window gets removed if deleted in the same event cycle
-    if (d->m_animations.isEmpty()) {
+    if (d->m_windows.isEmpty()) {
         connect(effects, &EffectsHandler::windowExpandedGeometryChanged,
                 this, &AnimationEffect::_windowExpandedGeometryChanged);
     }
-    AniMap::iterator it = d->m_animations.find(w);
-    if (it == d->m_animations.end())
-        it = d->m_animations.insert(w, QPair<QList<AniData>, QRect>(QList<AniData>(), QRect()));
 
     FullScreenEffectLockPtr fullscreen;
     if (fullScreenEffect) {
@@ -234,7 +293,8 @@ quint64 AnimationEffect::p_animate( EffectWindow *w, Attribute a, uint meta, int
         previousPixmap = PreviousWindowPixmapLockPtr::create(w);
     }
 
-    it->first.append(AniData(
+    AniWindow &entry = d->windowFor(w);
+    entry.animations.append(AniData(
         a,              // Attribute
         meta,           // Metadata
         to,             // Target
@@ -247,7 +307,7 @@ quint64 AnimationEffect::p_animate( EffectWindow *w, Attribute a, uint meta, int
     ));
 
     const quint64 ret_id = ++d->m_animCounter;
-    AniData &animation = it->first.last();
+    AniData &animation = entry.animations.last();
     animation.id = ret_id;
 
     animation.timeLine.setDirection(TimeLine::Forward);
@@ -256,12 +316,17 @@ quint64 AnimationEffect::p_animate( EffectWindow *w, Attribute a, uint meta, int
     animation.timeLine.setSourceRedirectMode(TimeLine::RedirectMode::Strict);
     animation.timeLine.setTargetRedirectMode(TimeLine::RedirectMode::Relaxed);
 
+    animation.updateValue();
+
     animation.terminationFlags = TerminateAtSource;
     if (!keepAtTarget) {
         animation.terminationFlags |= TerminateAtTarget;
     }
 
-    it->second = QRect();
+    entry.layerRect = QRect();
+    if (delay > 0) {
+        entry.pendingStart = true;
+    }
 
     d->m_animationsTouched = true;
 
@@ -282,24 +347,23 @@ bool AnimationEffect::retarget(quint64 animationId, FPx2 newTarget, int newRemai
     Q_D(AnimationEffect);
     if (animationId == d->m_justEndedAnimation)
         return false; // this is just ending, do not try to retarget it
-    for (AniMap::iterator entry = d->m_animations.begin(),
-                         mapEnd = d->m_animations.end(); entry != mapEnd; ++entry) {
-        for (QList<AniData>::iterator anim = entry->first.begin(),
-                                   animEnd = entry->first.end(); anim != animEnd; ++anim) {
-            if (anim->id == animationId) {
-                anim->from.set(interpolated(*anim, 0), interpolated(*anim, 1));
-                validate(anim->attribute, anim->meta, nullptr, &newTarget, entry.key());
-                anim->to.set(newTarget[0], newTarget[1]);
-
-                anim->timeLine.setDirection(TimeLine::Forward);
-                anim->timeLine.setDuration(std::chrono::milliseconds(newRemainingTime));
-                anim->timeLine.reset();
-
-                return true;
-            }
-        }
-    }
-    return false; // no animation found
+    int windowIndex, animationIndex;
+    if (!d->findAnimation(animationId, &windowIndex, &animationIndex))
+        return false; // no animation found
+
+    AniWindow &entry = d->m_windows[windowIndex];
+    AniData &anim = entry.animations[animationIndex];
+    anim.from.set(interpolated(anim, 0), interpolated(anim, 1));
+    validate(anim.attribute, anim.meta, nullptr, &newTarget, entry.window);
+    anim.to.set(newTarget[0], newTarget[1]);
+
+    anim.timeLine.setDirection(TimeLine::Forward);
+    anim.timeLine.setDuration(std::chrono::milliseconds(newRemainingTime));
+    anim.timeLine.reset();
+    anim.updateValue();
+
+    entry.layerRect = QRect();
+    return true;
 }
 
 bool AnimationEffect::redirect(quint64 animationId, Direction direction, TerminationFlags terminationFlags)
@@ -310,32 +374,26 @@ bool AnimationEffect::redirect(quint64 animationId, Direction direction, Termina
         return false;
     }
 
-    for (auto entryIt = d->m_animations.begin(); entryIt != d->m_animations.end(); ++entryIt) {
-        auto animIt = std::find_if(entryIt->first.begin(), entryIt->first.end(),
-            [animationId] (AniData &anim) {
-                return anim.id == animationId;
-            }
-        );
-        if (animIt == entryIt->first.end()) {
-            continue;
-        }
-
-        switch (direction) {
-        case Backward:
-            animIt->timeLine.setDirection(TimeLine::Backward);
-            break;
-
-        case Forward:
-            animIt->timeLine.setDirection(TimeLine::Forward);
-            break;
-        }
+    int windowIndex, animationIndex;
+    if (!d->findAnimation(animationId, &windowIndex, &animationIndex)) {
+        return false;
+    }
 
-        animIt->terminationFlags = terminationFlags & ~TerminateAtTarget;
+    AniData &anim = d->m_windows[windowIndex].animations[animationIndex];
+    switch (direction) {
+    case Backward:
+        anim.timeLine.setDirection(TimeLine::Backward);
+        break;
 
-        return true;
+    case Forward:
+        anim.timeLine.setDirection(TimeLine::Forward);
+        break;
     }
+    anim.updateValue();
 
-    return false;
+    anim.terminationFlags = terminationFlags & ~TerminateAtTarget;
+
+    return true;
 }
 
 bool AnimationEffect::complete(quint64 animationId)
@@ -346,22 +404,16 @@ bool AnimationEffect::complete(quint64 animationId)
         return false;
     }
 
-    for (auto entryIt = d->m_animations.begin(); entryIt != d->m_animations.end(); ++entryIt) {
-        auto animIt = std::find_if(entryIt->first.begin(), entryIt->first.end(),
-            [animationId] (AniData &anim) {
-                return anim.id == animationId;
-            }
-        );
-        if (animIt == entryIt->first.end()) {
-            continue;
-        }
-
-        animIt->timeLine.setElapsed(animIt->timeLine.duration());
-
-        return true;
+    int windowIndex, animationIndex;
+    if (!d->findAnimation(animationId, &windowIndex, &animationIndex)) {
+        return false;
     }
 
-    return false;
+    AniData &anim = d->m_windows[windowIndex].animations[animationIndex];
+    anim.timeLine.setElapsed(anim.timeLine.duration());
+    anim.updateValue();
+
+    return true;
 }
 
 bool AnimationEffect::cancel(quint64 animationId)
@@ -369,39 +421,42 @@ bool AnimationEffect::cancel(quint64 animationId)
     Q_D(AnimationEffect);
     if (animationId == d->m_justEndedAnimation)
         return true; // this is just ending, do not try to cancel it but fake success
-    for (AniMap::iterator entry = d->m_animations.begin(), mapEnd = d->m_animations.end(); entry != mapEnd; ++entry) {
-        for (QList<AniData>::iterator anim = entry->first.begin(), animEnd = entry->first.end(); anim != animEnd; ++anim) {
-            if (anim->id == animationId) {
-                entry->first.erase(anim); // remove the animation
-                if (entry->first.isEmpty()) { // no other animations on the window, release it.
-                    d->m_animations.erase(entry);
-                }
-                if (d->m_animations.isEmpty())
-                    disconnectGeometryChanges();
-                d->m_animationsTouched = true; // could be called from animationEnded
-                return true;
-            }
-        }
+    int windowIndex, animationIndex;
+    if (!d->findAnimation(animationId, &windowIndex, &animationIndex))
+        return false;
+
+    AniWindow &entry = d->m_windows[windowIndex];
+    entry.animations.remove(animationIndex); // remove the animation
+    entry.layerRect = QRect();
+    if (entry.animations.isEmpty()) { // no other animations on the window, release it.
+        d->removeAt(windowIndex);
     }
-    return false;
+    if (d->m_windows.isEmpty())
+        disconnectGeometryChanges();
+    d->m_animationsTouched = true; // could be called from animationEnded
+    return true;
 }
 
 void AnimationEffect::prePaintScreen( ScreenPrePaintData& data, std::chrono::milliseconds presentTime )
 {
     Q_D(AnimationEffect);
-    if (d->m_animations.isEmpty()) {
+    if (d->m_windows.isEmpty()) {
         effects->prePaintScreen(data, presentTime);
         return;
     }
 
-    for (auto entry = d->m_animations.begin(); entry != d->m_animations.end(); ++entry) {
-        for (auto anim = entry->first.begin(); anim != entry->first.end(); ++anim) {
-            if (anim->startTime <= clock()) {
-                if (anim->lastPresentTime.count()) {
-                    anim->timeLine.update(presentTime - anim->lastPresentTime);
+    // Advance all timelines and evaluate their easing curves in a single pass,
+    // the painting code below only reads the cached values.
+    const qint64 now = clock();
+    for (AniWindow &entry : d->m_windows) {
+        for (AniData &anim : entry.animations) {
+            if (anim.startTime <= now) {
+                if (anim.lastPresentTime.count()) {
+                    anim.timeLine.update(presentTime - anim.lastPresentTime);
                 }
-                anim->lastPresentTime = presentTime;
+                anim.lastPresentTime = presentTime;
             }
+            anim.updateValue();
         }
     }
 
@@ -457,11 +512,12 @@ void AnimationEffect::disconnectGeometryChanges()
 void AnimationEffect::prePaintWindow( EffectWindow* w, WindowPrePaintData& data, std::chrono::milliseconds presentTime )
 {
     Q_D(AnimationEffect);
-    AniMap::const_iterator entry = d->m_animations.constFind( w );
-    if ( entry != d->m_animations.constEnd() ) {
+    const int index = d->indexOf(w);
+    if (index != -1) {
+        const QVector<AniData> &animations = d->m_windows.at(index).animations;
         bool isUsed = false;
         bool paintDeleted = false;
-        for (QList<AniData>::const_iterator anim = entry->first.constBegin(); anim != entry->first.constEnd(); ++anim) {
+        for (auto anim = animations.constBegin(); anim != animations.constEnd(); ++anim) {
             if (anim->startTime > clock() && !anim->waitAtSource)
                 continue;
 
@@ -500,9 +556,10 @@ static inline float geometryCompensation(int flags, float v)
 void AnimationEffect::paintWindow( EffectWindow* w, int mask, QRegion region, WindowPaintData& data )
 {
     Q_D(AnimationEffect);
-    AniMap::const_iterator entry = d->m_animations.constFind( w );
-    if ( entry != d->m_animations.constEnd() ) {
-        for ( QList<AniData>::const_iterator anim = entry->first.constBegin(); anim != entry->first.constEnd(); ++anim ) {
+    const int index = d->indexOf(w);
+    if (index != -1) {
+        const QVector<AniData> &animations = d->m_windows.at(index).animations;
+        for (auto anim = animations.constBegin(); anim != animations.constEnd(); ++anim) {
 
             if (anim->startTime > clock() && !anim->waitAtSource)
                 continue;
@@ -611,46 +668,44 @@ void AnimationEffect::postPaintScreen()
     d->m_animationsTouched = false;
     bool damageDirty = false;
 
-    for (auto entry = d->m_animations.begin(); entry != d->m_animations.end();) {
+    for (int i = 0; i < d->m_windows.count();) {
         bool invalidateLayerRect = false;
-        int animCounter = 0;
-        for (auto anim = entry->first.begin(); anim != entry->first.end();) {
-            if (anim->isActive() || anim->startTime > clock() && !anim->waitAtSource) {
-                ++anim;
-                ++animCounter;
+        for (int j = 0; j < d->m_windows.at(i).animations.count();) {
+            const AniData &anim = d->m_windows.at(i).animations.at(j);
+            if (anim.isActive() || anim.startTime > clock() && !anim.waitAtSource) {
+                ++j;
                 continue;
             }
-            EffectWindow *window = entry.key();
-            d->m_justEndedAnimation = anim->id;
-            animationEnded(window, anim->attribute, anim->meta);
+            EffectWindow *window = d->m_windows.at(i).window;
+            const quint64 animationId = anim.id;
+            d->m_justEndedAnimation = animationId;
+            animationEnded(window, anim.attribute, anim.meta);
             d->m_justEndedAnimation = 0;
             // NOTICE animationEnded is an external call and might have called "::animate"
-            // as a result our iterators could now point random junk on the heap
-            // so we've to restore the former states, ie. find our window list and animation
+            // as a result our references could now point random junk on the heap
+            // so we've to restore the former states, ie. find our window slot and animation
             if (d->m_animationsTouched) {
                 d->m_animationsTouched = false;
-                entry = d->m_animations.begin();
-                while (entry.key() != window && entry != d->m_animations.end()) {
-                    ++entry;
-                }
-                Q_ASSERT(entry != d->m_animations.end()); // usercode should not delete animations from animationEnded (not even possible atm.)
-                anim = entry->first.begin();
-                Q_ASSERT(animCounter < entry->first.count());
-                for (int i = 0; i < animCounter; ++i) {
-                    ++anim;
-                }
+                i = d->indexOf(window);
+                Q_ASSERT(i != -1); // usercode should not delete animations from animationEnded (not even possible atm.)
+                const QVector<AniData> &animations = d->m_windows.at(i).animations;
+                j = std::find_if(animations.constBegin(), animations.constEnd(), [animationId](const AniData &a) {
+                        return a.id == animationId;
+                    }) - animations.constBegin();
+                Q_ASSERT(j < animations.count());
             }
-            anim = entry->first.erase(anim);
+            d->m_windows[i].animations.remove(j);
             invalidateLayerRect = damageDirty = true;
         }
-        if (entry->first.isEmpty()) {
-            effects->addRepaint(entry->second);
-            entry = d->m_animations.erase(entry);
+        AniWindow &entry = d->m_windows[i];
+        if (entry.animations.isEmpty()) {
+            effects->addRepaint(entry.layerRect);
+            d->removeAt(i);
         } else {
             if (invalidateLayerRect) {
-                *const_cast<QRect*>(&(entry->second)) = QRect(); // invalidate
+                entry.layerRect = QRect(); // invalidate
             }
-            ++entry;
+            ++i;
         }
     }
 
@@ -660,12 +715,13 @@ void AnimationEffect::postPaintScreen()
     if (d->m_needSceneRepaint) {
         effects->addRepaintFull();
     } else {
-        for (auto entry = d->m_animations.constBegin(); entry != d->m_animations.constEnd(); ++entry) {
-            for (auto anim = entry->first.constBegin(); anim != entry->first.constEnd(); ++anim) {
-                if (anim->startTime > clock())
+        const qint64 now = clock();
+        for (const AniWindow &entry : qAsConst(d->m_windows)) {
+            for (const AniData &anim : entry.animations) {
+                if (anim.startTime > now)
                     continue;
-                if (!anim->timeLine.done()) {
-                    entry.key()->addLayerRepaint(entry->second);
+                if (!anim.timeLine.done()) {
+                    entry.window->addLayerRepaint(entry.layerRect);
                     break;
                 }
             }
@@ -673,7 +729,7 @@ void AnimationEffect::postPaintScreen()
     }
 
     // janitorial...
-    if (d->m_animations.isEmpty()) {
+    if (d->m_windows.isEmpty()) {
         disconnectGeometryChanges();
     }
 
@@ -682,12 +738,12 @@ void AnimationEffect::postPaintScreen()
 
 float AnimationEffect::interpolated( const AniData &a, int i ) const
 {
-    return a.from[i] + a.timeLine.value() * (a.to[i] - a.from[i]);
+    return a.from[i] + a.value * (a.to[i] - a.from[i]);
 }
 
 float AnimationEffect::progress( const AniData &a ) const
 {
-    return a.startTime < clock() ? a.timeLine.value() : 0.0;
+    return a.startTime < clock() ? a.value : 0.0;
 }
 
 
@@ -754,15 +810,19 @@ void AnimationEffect::setMetaData( MetaType type, uint value, uint &meta )
 void AnimationEffect::triggerRepaint()
 {
     Q_D(AnimationEffect);
-    for (AniMap::const_iterator entry = d->m_animations.constBegin(), mapEnd = d->m_animations.constEnd(); entry != mapEnd; ++entry)
-        *const_cast<QRect*>(&(entry->second)) = QRect();
+    // layer rects stay valid until an animation of the window starts or stops, only
+    // windows with delayed animations need to be re-evaluated when the delay expires
+    for (AniWindow &entry : d->m_windows) {
+        if (entry.pendingStart) {
+            entry.layerRect = QRect();
+        }
+    }
     updateLayerRepaints();
     if (d->m_needSceneRepaint) {
         effects->addRepaintFull();
     } else {
-        AniMap::const_iterator it = d->m_animations.constBegin(), end = d->m_animations.constEnd();
-        for (; it != end; ++it) {
-            it.key()->addLayerRepaint(it->second);
+        for (const AniWindow &entry : qAsConst(d->m_windows)) {
+            entry.window->addLayerRepaint(entry.layerRect);
         }
     }
 }
@@ -789,17 +849,21 @@ void AnimationEffect::updateLayerRepaints()
 {
     Q_D(AnimationEffect);
     d->m_needSceneRepaint = false;
-    for (AniMap::const_iterator entry = d->m_animations.constBegin(), mapEnd = d->m_animations.constEnd(); entry != mapEnd; ++entry) {
-        if (!entry->second.isNull())
+    const qint64 now = clock();
+    for (AniWindow &entry : d->m_windows) {
+        if (!entry.layerRect.isNull())
             continue;
         float f[2] = {1.0, 1.0};
         float t[2] = {0.0, 0.0};
         bool createRegion = false;
-        QList<QRect> rects;
-        QRect *layerRect = const_cast<QRect*>(&(entry->second));
-        for (QList<AniData>::const_iterator anim = entry->first.constBegin(), animEnd = entry->first.constEnd(); anim != animEnd; ++anim) {
-            if (anim->startTime > clock())
+        QVarLengthArray<QRect, 4> rects;
+        QRect *layerRect = &entry.layerRect;
+        entry.pendingStart = false;
+        for (auto anim = entry.animations.constBegin(), animEnd = entry.animations.constEnd(); anim != animEnd; ++anim) {
+            if (anim->startTime > now) {
+                entry.pendingStart = true;
                 continue;
+            }
             switch (anim->attribute) {
                 case Opacity:
                 case Brightness:
@@ -817,7 +881,7 @@ void AnimationEffect::updateLayerRepaints()
                 case Translation:
                 case Position: {
                     createRegion = true;
-                    QRect r(entry.key()->frameGeometry());
+                    QRect r(entry.window->frameGeometry());
                     int x[2] = {0,0};
                     int y[2] = {0,0};
                     if (anim->attribute == Translation) {
@@ -835,8 +899,9 @@ void AnimationEffect::updateLayerRepaints()
                             y[1] = anim->to[1] - yCoord(r, metaData(TargetAnchor, anim->meta));
                         }
                     }
-                    r = entry.key()->expandedGeometry();
-                    rects << r.translated(x[0], y[0]) << r.translated(x[1], y[1]);
+                    r = entry.window->expandedGeometry();
+                    rects.append(r.translated(x[0], y[0]));
+                    rects.append(r.translated(x[1], y[1]));
                     break;
                 }
                 case Clip:
@@ -845,7 +910,7 @@ void AnimationEffect::updateLayerRepaints()
                 case Size:
                 case Scale: {
                     createRegion = true;
-                    const QSize sz = entry.key()->frameGeometry().size();
+                    const QSize sz = entry.window->frameGeometry().size();
                     float fx = qMax(fixOvershoot(anim->from[0], *anim, 1), fixOvershoot(anim->to[0], *anim, 2));
 //                     float fx = qMax(interpolated(*anim,0), anim->to[0]);
                     if (fx >= 0.0) {
@@ -873,18 +938,17 @@ void AnimationEffect::updateLayerRepaints()
         }
 region_creation:
         if (createRegion) {
-            const QRect geo = entry.key()->expandedGeometry();
+            const QRect geo = entry.window->expandedGeometry();
             if (rects.isEmpty())
-                rects << geo;
-            QList<QRect>::const_iterator r, rEnd = rects.constEnd();
-            for ( r = rects.constBegin(); r != rEnd; ++r) { // transform
-                const_cast<QRect*>(&(*r))->setSize(QSize(qRound(r->width()*f[0]), qRound(r->height()*f[1])));
-                const_cast<QRect*>(&(*r))->translate(t[0], t[1]); // "const_cast" - don't do that at home, kids ;-)
+                rects.append(geo);
+            for (QRect &r : rects) { // transform
+                r.setSize(QSize(qRound(r.width()*f[0]), qRound(r.height()*f[1])));
+                r.translate(t[0], t[1]);
             }
             QRect rect = rects.at(0);
             if (rects.count() > 1) {
-                for ( r = rects.constBegin() + 1; r != rEnd; ++r) // unite
-                    rect |= *r;
+                for (int i = 1; i < rects.count(); ++i) // unite
+                    rect |= rects.at(i);
                 const int dx = 110*(rect.width() - geo.width())/100 + 1 - rect.width() + geo.width();
                 const int dy = 110*(rect.height() - geo.height())/100 + 1 - rect.height() + geo.height();
                 rect.adjust(-dx,-dy,dx,dy); // fix pot. overshoot
@@ -897,12 +961,13 @@ region_creation:
 void AnimationEffect::_windowExpandedGeometryChanged(KWin::EffectWindow *w)
 {
     Q_D(AnimationEffect);
-    AniMap::const_iterator entry = d->m_animations.constFind(w);
-    if (entry != d->m_animations.constEnd()) {
-        *const_cast<QRect*>(&(entry->second)) = QRect();
+    const int index = d->indexOf(w);
+    if (index != -1) {
+        d->m_windows[index].layerRect = QRect();
         updateLayerRepaints();
-        if (!entry->second.isNull()) // actually got updated, ie. is in use - ensure it get's a repaint
-            w->addLayerRepaint(entry->second);
+        const QRect &layerRect = d->m_windows.at(index).layerRect;
+        if (!layerRect.isNull()) // actually got updated, ie. is in use - ensure it get's a repaint
+            w->addLayerRepaint(layerRect);
     }
 }
 
@@ -910,14 +975,14 @@ void AnimationEffect::_windowClosed( EffectWindow* w )
 {
     Q_D(AnimationEffect);
 
-    auto it = d->m_animations.find(w);
-    if (it == d->m_animations.end()) {
+    const int index = d->indexOf(w);
+    if (index == -1) {
         return;
     }
 
     KeepAliveLockPtr keepAliveLock;
 
-    QList<AniData> &animations = (*it).first;
+    QVector<AniData> &animations = d->m_windows[index].animations;
     for (auto animationIt = animations.begin();
             animationIt != animations.end();
             ++animationIt) {
@@ -936,7 +1001,10 @@ void AnimationEffect::_windowClosed( EffectWindow* w )
 void AnimationEffect::_windowDeleted( EffectWindow* w )
 {
     Q_D(AnimationEffect);
-    d->m_animations.remove( w );
+    const int index = d->indexOf(w);
+    if (index != -1) {
+        d->removeAt(index);
+    }
 }
 
 
@@ -944,18 +1012,16 @@ QString AnimationEffect::debug(const QString &/*parameter*/) const
 {
     Q_D(const AnimationEffect);
     QString dbg;
-    if (d->m_animations.isEmpty())
+    if (d->m_windows.isEmpty())
         dbg = QStringLiteral("No window is animated");
     else {
-        AniMap::const_iterator entry = d->m_animations.constBegin(), mapEnd = d->m_animations.constEnd();
-        for (; entry != mapEnd; ++entry) {
-            QString caption = entry.key()->isDeleted() ? QStringLiteral("[Deleted]") : entry.key()->caption();
+        for (const AniWindow &entry : d->m_windows) {
+            QString caption = entry.window->isDeleted() ? QStringLiteral("[Deleted]") : entry.window->caption();
             if (caption.isEmpty())
                 caption = QStringLiteral("[Untitled]");
             dbg += QLatin1String("Animating window: ") + caption + QLatin1Char('\n');
-            QList<AniData>::const_iterator anim = entry->first.constBegin(), animEnd = entry->first.constEnd();
-            for (; anim != animEnd; ++anim)
-                dbg += anim->debugInfo();
+            for (const AniData &anim : entry.animations)
+                dbg += anim.debugInfo();
         }
     }
     return dbg;
@@ -964,7 +1030,11 @@ QString AnimationEffect::debug(const QString &/*parameter*/) const
 AnimationEffect::AniMap AnimationEffect::state() const
 {
     Q_D(const AnimationEffect);
-    return d->m_animations;
+    AniMap state;
+    for (const AniWindow &entry : d->m_windows) {
+        state.insert(entry.window, qMakePair(entry.animations.toList(), entry.layerRect));
+    }
+    return state;
 }
 
 } // namespace KWin
@@ -1284,8 +1284,11 @@ void WindowMotionManager::manage(EffectWindow *w)
     motion.scale.setStrength(strength * 1.33);
     motion.scale.setSmoothness(smoothness / 2.0);
 
+    // the window starts at rest, otherwise it would drift towards the default target
     motion.translation.setValue(w->pos());
+    motion.translation.setTarget(w->pos());
     motion.scale.setValue(QPointF(1.0, 1.0));
+    motion.scale.setTarget(QPointF(1.0, 1.0));
 
     motion.fill.setValue(0);
     m_orderWindowList.push_back(w);
@@ -1307,7 +1310,7 @@ void WindowMotionManager::unmanageAll()
 
 void WindowMotionManager::calculate(int time)
 {
-    if (!effects->animationTimeFactor()) {
+    if (effects && !effects->animationTimeFactor()) {
         // Just skip it completely if the user wants no animation
         m_movingWindowsSet.clear();
         QHash<EffectWindow*, WindowMotion>::iterator it = m_managedWindows.begin();
@@ -1318,8 +1321,14 @@ void WindowMotionManager::calculate(int time)
         }
     }
 
-    QHash<EffectWindow*, WindowMotion>::iterator it = m_managedWindows.begin();
-    for (; it != m_managedWindows.end(); ++it) {
+    // Windows at rest keep their position, only step the ones in motion
+    QSet<EffectWindow*>::iterator moving = m_movingWindowsSet.begin();
+    while (moving != m_movingWindowsSet.end()) {
+        QHash<EffectWindow*, WindowMotion>::iterator it = m_managedWindows.find(*moving);
+        if (it == m_managedWindows.end()) {
+            moving = m_movingWindowsSet.erase(moving);
+            continue;
+        }
         WindowMotion *motion = &it.value();
         int stopped = 0;
 
@@ -1360,12 +1369,15 @@ void WindowMotionManager::calculate(int time)
 
         // We just finished this window's motion
         if (stopped == 2)
-            m_movingWindowsSet.remove(it.key());
+            moving = m_movingWindowsSet.erase(moving);
+        else
+            ++moving;
     }
 }
 
 void WindowMotionManager::reset()
 {
+    m_movingWindowsSet.clear();
     QHash<EffectWindow*, WindowMotion>::iterator it = m_managedWindows.begin();
     for (; it != m_managedWindows.end(); ++it) {
         WindowMotion *motion = &it.value();
@@ -1388,6 +1400,7 @@ void WindowMotionManager::reset(EffectWindow *w)
     motion->translation.finish();
     motion->scale.setTarget(QPointF(1.0, 1.0));
     motion->scale.finish();
+    m_movingWindowsSet.remove(w);
 }
 
 void WindowMotionManager::apply(EffectWindow *w, WindowPaintData &data)
@@ -1415,6 +1428,8 @@ void WindowMotionManager::moveWindow(EffectWindow *w, QPoint target, double scal
 
     if (motion->translation.value() == target && motion->scale.value() == scalePoint)
         return; // Window already at that position
+    if (motion->translation.target() == target && motion->scale.target() == scalePoint && m_movingWindowsSet.contains(w))
+        return; // Window already moving to that position, don't restart its motion
 
     motion->translation.setTarget(target);
     motion->scale.setTarget(scalePoint);
@@ -1447,6 +1462,9 @@ void WindowMotionManager::setTransformedGeometry(EffectWindow *w, const QRectF &
     WindowMotion *motion = &it.value();
     motion->translation.setValue(geometry.topLeft());
     motion->scale.setValue(QPointF(geometry.width() / qreal(w->width()), geometry.height() / qreal(w->height())));
+    // A displaced window moves back towards its target
+    if (motion->translation.value() != motion->translation.target() || motion->scale.value() != motion->scale.target())
+        m_movingWindowsSet << w;
 }
 
 QRectF WindowMotionManager::targetGeometry(EffectWindow *w) const
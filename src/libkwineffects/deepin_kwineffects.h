@@ -3280,7 +3280,8 @@ public:
     void unmanageAll();
     /**
      * Determine the new positions for windows that have not
-     * reached their target. Called once per frame, usually in
+     * reached their target, windows at rest are not touched.
+     * Called once per frame, usually in
      * prePaintScreen(). Remember to set the
      * Effect::PAINT_SCREEN_WITH_TRANSFORMED_WINDOWS flag.
      */
@@ -3310,6 +3311,8 @@ public:
      * with the specified scale. If `yScale` is not provided or
      * set to 0.0, `scale` will be used as the scale in the
      * vertical direction as well as in the horizontal direction.
+     * The motion of a window that is already moving to the target
+     * is not restarted.
      */
     void moveWindow(EffectWindow *w, QPoint target, double scale = 1.0, double yScale = 0.0);
     /**
@@ -3331,6 +3334,8 @@ public:
     QRectF transformedGeometry(EffectWindow *w) const;
     /**
      * Sets the current transformed geometry of a registered window to the given geometry.
+     * If it differs from the target geometry the window moves back towards the target
+     * with the next calls of calculate().
      * @see transformedGeometry
      * @since 4.5
      */
@@ -22,9 +22,19 @@ namespace KWin
 
 class EffectWindow;
 
+/**
+ * Cumulative cost of an effect in the paint chain.
+ */
+struct EffectCost
+{
+    QString name;
+    std::chrono::nanoseconds cpuTime;
+    std::chrono::nanoseconds gpuTime;
+};
+
 #define KWIN_EFFECT_API_MAKE_VERSION( major, minor ) (( major ) << 8 | ( minor ))
 #define KWIN_EFFECT_API_VERSION_MAJOR 0
-#define KWIN_EFFECT_API_VERSION_MINOR 227
+#define KWIN_EFFECT_API_VERSION_MINOR 228
 #define KWIN_EFFECT_API_VERSION KWIN_EFFECT_API_MAKE_VERSION( \
         KWIN_EFFECT_API_VERSION_MAJOR, KWIN_EFFECT_API_VERSION_MINOR )
 
@@ -67,6 +77,19 @@ public:
     virtual QRect getSplitArea(int mode, QRect rect, QRect availableArea, QString screen, int desktop, bool isUseTmp = false) = 0;
     virtual QString getScreenWithSplit() = 0;
 
+    /**
+     * Starts measuring the window hooks of all effects, including their GPU time if the
+     * driver supports timer queries. Must be balanced with endEffectProfiling().
+     */
+    virtual void beginEffectProfiling() = 0;
+    virtual void endEffectProfiling() = 0;
+
+    /**
+     * Returns the cumulative cost of the paint hooks of every effect that has been loaded.
+     * The work done by the scene itself is reported as an entry named "scene".
+     */
+    virtual QVector<EffectCost> effectCosts() const = 0;
+
 Q_SIGNALS:
     void windowQuickTileModeChanged(KWin::EffectWindow *w);
     void showSplitScreenPreview(KWin::EffectWindow *w);
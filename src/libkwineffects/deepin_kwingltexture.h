@@ -143,6 +143,18 @@ public:
      */
     static bool supportsFormatRG();
 
+    /**
+     * Returns the number of textures whose storage has been allocated by GLTexture and
+     * that are still alive. Textures wrapping foreign or client storage are not counted.
+     */
+    static int allocatedTextureCount();
+
+    /**
+     * Returns an estimate of the video memory used by the textures reported by
+     * allocatedTextureCount(), in bytes.
+     */
+    static qint64 allocatedTextureBytes();
+
 protected:
     QExplicitlySharedDataPointer<GLTexturePrivate> d_ptr;
     GLTexture(GLTexturePrivate& dd);
@@ -0,0 +1,405 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "deepin_kwinnaturallayout.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+namespace KWin
+{
+
+// upper bound for the passes of separate() and fillGaps()
+static const int s_maxPasses = 512;
+// the step is doubled whenever separate() did not converge after this many passes
+static const int s_passesPerStep = 16;
+static const int s_minCellSize = 16;
+
+namespace
+{
+
+/**
+ * Uniform grid of the window geometries, every cell lists the windows that touch it.
+ */
+class SpatialGrid
+{
+public:
+    SpatialGrid(const QVector<QRect> &rects, const QMargins &margins);
+
+    void move(int index, const QRect &from, const QRect &to);
+    void query(const QRect &rect, QVector<int> &result) const;
+
+private:
+    struct CellRange
+    {
+        int left;
+        int top;
+        int right;
+        int bottom;
+
+        bool operator==(const CellRange &other) const
+        {
+            return left == other.left && top == other.top && right == other.right && bottom == other.bottom;
+        }
+    };
+
+    static int cell(int value, int size);
+    static quint64 key(int x, int y);
+    CellRange range(const QRect &rect) const;
+    void insert(int index, const CellRange &range);
+    void remove(int index, const CellRange &range);
+
+    QMargins m_margins;
+    int m_cellWidth = s_minCellSize;
+    int m_cellHeight = s_minCellSize;
+    QHash<quint64, QVector<int>> m_cells;
+};
+
+SpatialGrid::SpatialGrid(const QVector<QRect> &rects, const QMargins &margins)
+    : m_margins(margins)
+{
+    if (!rects.isEmpty()) {
+        qint64 width = 0;
+        qint64 height = 0;
+        for (const QRect &rect : rects) {
+            width += rect.width() + margins.left() + margins.right();
+            height += rect.height() + margins.top() + margins.bottom();
+        }
+        m_cellWidth = std::max<qint64>(s_minCellSize, width / rects.count());
+        m_cellHeight = std::max<qint64>(s_minCellSize, height / rects.count());
+    }
+    m_cells.reserve(rects.count() * 4);
+    for (int i = 0; i < rects.count(); ++i) {
+        insert(i, range(rects[i]));
+    }
+}
+
+int SpatialGrid::cell(int value, int size)
+{
+    return value >= 0 ? value / size : -((-value - 1) / size) - 1;
+}
+
+quint64 SpatialGrid::key(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+SpatialGrid::CellRange SpatialGrid::range(const QRect &rect) const
+{
+    const QRect adjusted = rect.marginsAdded(m_margins);
+    if (adjusted.isEmpty()) {
+        return CellRange{0, 0, -1, -1};
+    }
+    return CellRange{cell(adjusted.left(), m_cellWidth), cell(adjusted.top(), m_cellHeight),
+                     cell(adjusted.right(), m_cellWidth), cell(adjusted.bottom(), m_cellHeight)};
+}
+
+void SpatialGrid::insert(int index, const CellRange &range)
+{
+    for (int x = range.left; x <= range.right; ++x) {
+        for (int y = range.top; y <= range.bottom; ++y) {
+            m_cells[key(x, y)].append(index);
+        }
+    }
+}
+
+void SpatialGrid::remove(int index, const CellRange &range)
+{
+    for (int x = range.left; x <= range.right; ++x) {
+        for (int y = range.top; y <= range.bottom; ++y) {
+            auto it = m_cells.find(key(x, y));
+            if (it == m_cells.end()) {
+                continue;
+            }
+            it->removeOne(index);
+            if (it->isEmpty()) {
+                m_cells.erase(it);
+            }
+        }
+    }
+}
+
+void SpatialGrid::move(int index, const QRect &from, const QRect &to)
+{
+    const CellRange oldRange = range(from);
+    const CellRange newRange = range(to);
+    if (oldRange == newRange) {
+        return;
+    }
+    remove(index, oldRange);
+    insert(index, newRange);
+}
+
+void SpatialGrid::query(const QRect &rect, QVector<int> &result) const
+{
+    result.clear();
+    const CellRange cells = range(rect);
+    for (int x = cells.left; x <= cells.right; ++x) {
+        for (int y = cells.top; y <= cells.bottom; ++y) {
+            const auto it = m_cells.constFind(key(x, y));
+            if (it != m_cells.constEnd()) {
+                result += *it;
+            }
+        }
+    }
+    // visit the windows in a deterministic order
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+} // namespace
+
+NaturalLayout::NaturalLayout(const QVector<QRect> &geometries)
+    : m_geometries(geometries)
+    , m_targets(geometries)
+{
+}
+
+int NaturalLayout::spacing() const
+{
+    return m_spacing;
+}
+
+void NaturalLayout::setSpacing(int spacing)
+{
+    m_spacing = spacing;
+}
+
+int NaturalLayout::accuracy() const
+{
+    return m_accuracy;
+}
+
+void NaturalLayout::setAccuracy(int accuracy)
+{
+    m_accuracy = std::max(1, accuracy);
+}
+
+int NaturalLayout::passes() const
+{
+    return m_passes;
+}
+
+const QVector<QRect> &NaturalLayout::targets() const
+{
+    return m_targets;
+}
+
+int NaturalLayout::heightForWidth(int index, int width) const
+{
+    const QRect &geometry = m_geometries[index];
+    return int((width / qreal(geometry.width())) * geometry.height());
+}
+
+bool NaturalLayout::separate(QRect &bounds)
+{
+    const int halfSpacing = m_spacing / 2;
+    const QMargins margins(halfSpacing, halfSpacing, halfSpacing, halfSpacing);
+    SpatialGrid grid(m_targets, margins);
+    QVector<int> candidates;
+    int step = m_accuracy;
+
+    for (const QRect &target : qAsConst(m_targets)) {
+        bounds = bounds.united(target);
+    }
+
+    // If two windows overlap push them apart _slightly_, the windows settle over many passes.
+    // The step grows if that takes too long, e.g. with a lot of windows stacked on top of
+    // each other, so the number of passes stays bounded.
+    for (m_passes = 1; m_passes <= s_maxPasses; ++m_passes) {
+        bool overlap = false;
+        for (int i = 0; i < m_targets.count(); ++i) {
+            grid.query(m_targets[i], candidates);
+            for (int j : qAsConst(candidates)) {
+                if (i == j) {
+                    continue;
+                }
+                QRect &target_w = m_targets[i];
+                QRect &target_e = m_targets[j];
+                if (!target_w.marginsAdded(margins).intersects(target_e.marginsAdded(margins))) {
+                    continue;
+                }
+                overlap = true;
+                const QRect oldTarget_w = target_w;
+                const QRect oldTarget_e = target_e;
+
+                // Determine pushing direction
+                QPoint diff(target_e.center() - target_w.center());
+                // Prevent dividing by zero and non-movement
+                if (diff.x() == 0 && diff.y() == 0) {
+                    diff.setX(1);
+                }
+                // Approximate a vector of the step's magnitude in the same direction
+                diff *= step / qreal(diff.manhattanLength());
+                // Move both windows apart
+                target_w.translate(-diff);
+                target_e.translate(diff);
+
+                // Try to keep the bounding rect the same aspect as the screen so that more
+                // screen real estate is utilised. We do this by splitting the screen into nine
+                // equal sections, if the window center is in any of the corner sections pull the
+                // window towards the outer corner. If it is in any of the other edge sections
+                // alternate between each corner on that edge, the preferred direction of a window
+                // is derived from its index so the locations stay consistent. Only move one window
+                // so we don't cause large amounts of unnecessary zooming in some situations.
+                // (We are using an old bounding rect for this, hopefully it doesn't matter)
+                const int direction = i % 4;
+                int xSection = (target_w.x() - bounds.x()) / std::max(1, bounds.width() / 3);
+                int ySection = (target_w.y() - bounds.y()) / std::max(1, bounds.height() / 3);
+                diff = QPoint(0, 0);
+                if (xSection != 1 || ySection != 1) { // Remove this if you want the center to pull as well
+                    if (xSection == 1) {
+                        xSection = (direction / 2 ? 2 : 0);
+                    }
+                    if (ySection == 1) {
+                        ySection = (direction % 2 ? 2 : 0);
+                    }
+                }
+                if (xSection == 0 && ySection == 0) {
+                    diff = QPoint(bounds.topLeft() - target_w.center());
+                }
+                if (xSection == 2 && ySection == 0) {
+                    diff = QPoint(bounds.topRight() - target_w.center());
+                }
+                if (xSection == 2 && ySection == 2) {
+                    diff = QPoint(bounds.bottomRight() - target_w.center());
+                }
+                if (xSection == 0 && ySection == 2) {
+                    diff = QPoint(bounds.bottomLeft() - target_w.center());
+                }
+                if (diff.x() != 0 || diff.y() != 0) {
+                    diff *= step / qreal(diff.manhattanLength());
+                    target_w.translate(diff);
+                }
+
+                // Update bounding rect
+                bounds = bounds.united(target_w);
+                bounds = bounds.united(target_e);
+
+                grid.move(i, oldTarget_w, target_w);
+                grid.move(j, oldTarget_e, target_e);
+            }
+        }
+        if (!overlap) {
+            return true;
+        }
+        if (m_passes % s_passesPerStep == 0) {
+            step *= 2;
+        }
+    }
+    m_passes = s_maxPasses;
+    return false;
+}
+
+void NaturalLayout::map(const QRect &bounds, qreal scale, const QPoint &origin)
+{
+    for (QRect &target : m_targets) {
+        target.setRect((target.x() - bounds.x()) * scale + origin.x(),
+                       (target.y() - bounds.y()) * scale + origin.y(),
+                       target.width() * scale,
+                       target.height() * scale);
+    }
+}
+
+void NaturalLayout::fillGaps(const QRegion &border)
+{
+    const int halfSpacing = m_spacing / 2;
+    const QMargins margins(halfSpacing, halfSpacing, halfSpacing, halfSpacing);
+    SpatialGrid grid(m_targets, margins);
+    QVector<int> candidates;
+
+    auto isOverlappingAny = [&](int index) {
+        const QRect &target = m_targets[index];
+        if (border.intersects(target)) {
+            return true;
+        }
+        grid.query(target, candidates);
+        for (int other : qAsConst(candidates)) {
+            if (other != index && target.marginsAdded(margins).intersects(m_targets[other].marginsAdded(margins))) {
+                return true;
+            }
+        }
+        return false;
+    };
+    auto tryEnlarge = [&](int index, const QRect &rect) {
+        const QRect oldRect = m_targets[index];
+        m_targets[index] = rect;
+        grid.move(index, oldRect, rect);
+        if (isOverlappingAny(index)) {
+            grid.move(index, rect, oldRect);
+            m_targets[index] = oldRect;
+            return false;
+        }
+        return true;
+    };
+
+    bool moved;
+    m_passes = 0;
+    do {
+        moved = false;
+        ++m_passes;
+        for (int i = 0; i < m_targets.count(); ++i) {
+            // This may cause some slight distortion if the windows are enlarged a large amount
+            const int widthDiff = m_accuracy;
+            int heightDiff = heightForWidth(i, m_targets[i].width() + widthDiff) - m_targets[i].height();
+            const int xDiff = widthDiff / 2; // Also move a bit in the direction of the enlarge, allows the
+            int yDiff = heightDiff / 2; // center windows to be enlarged if there is gaps on the side.
+
+            // heightDiff (and yDiff) will be re-computed after each successful enlargement attempt
+            // so that the error introduced in the window's aspect ratio is minimized
+
+            // Attempt enlarging to the top-right
+            QRect target = m_targets[i];
+            if (tryEnlarge(i, QRect(target.x() + xDiff, target.y() - yDiff - heightDiff,
+                                    target.width() + widthDiff, target.height() + heightDiff))) {
+                moved = true;
+                heightDiff = heightForWidth(i, m_targets[i].width() + widthDiff) - m_targets[i].height();
+                yDiff = heightDiff / 2;
+            }
+
+            // Attempt enlarging to the bottom-right
+            target = m_targets[i];
+            if (tryEnlarge(i, QRect(target.x() + xDiff, target.y() + yDiff,
+                                    target.width() + widthDiff, target.height() + heightDiff))) {
+                moved = true;
+                heightDiff = heightForWidth(i, m_targets[i].width() + widthDiff) - m_targets[i].height();
+                yDiff = heightDiff / 2;
+            }
+
+            // Attempt enlarging to the bottom-left
+            target = m_targets[i];
+            if (tryEnlarge(i, QRect(target.x() - xDiff - widthDiff, target.y() + yDiff,
+                                    target.width() + widthDiff, target.height() + heightDiff))) {
+                moved = true;
+                heightDiff = heightForWidth(i, m_targets[i].width() + widthDiff) - m_targets[i].height();
+                yDiff = heightDiff / 2;
+            }
+
+            // Attempt enlarging to the top-left
+            target = m_targets[i];
+            if (tryEnlarge(i, QRect(target.x() - xDiff - widthDiff, target.y() - yDiff - heightDiff,
+                                    target.width() + widthDiff, target.height() + heightDiff))) {
+                moved = true;
+            }
+        }
+    } while (moved && m_passes < s_maxPasses);
+
+    // The expanding code above can actually enlarge windows over 1.0/2.0 scale, we don't like this
+    // We can't add this to the loop above as it would cause a never-ending loop so we have to make
+    // do with the less-than-optimal space usage with using this method.
+    for (int i = 0; i < m_targets.count(); ++i) {
+        QRect &target = m_targets[i];
+        const QRect &geometry = m_geometries[i];
+        qreal scale = target.width() / qreal(geometry.width());
+        if (scale > 2.0 || (scale > 1.0 && (geometry.width() > 300 || geometry.height() > 300))) {
+            scale = (geometry.width() > 300 || geometry.height() > 300) ? 1.0 : 2.0;
+            target.setRect(target.center().x() - int(geometry.width() * scale) / 2,
+                           target.center().y() - int(geometry.height() * scale) / 2,
+                           geometry.width() * scale,
+                           geometry.height() * scale);
+        }
+    }
+}
+
+} // namespace KWin
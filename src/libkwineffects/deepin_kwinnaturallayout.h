@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef KWINNATURALLAYOUT_H
+#define KWINNATURALLAYOUT_H
+
+#include <deepin_kwineffects_export.h>
+
+#include <QRect>
+#include <QRegion>
+#include <QVector>
+
+namespace KWin
+{
+
+/**
+ * The NaturalLayout class arranges windows close to their natural positions so that
+ * none of them overlap, as used by the "natural" mode of the window overview effects.
+ *
+ * The layout is computed in two steps. separate() pushes overlapping windows apart
+ * until there is no overlap left. The caller then scales the resulting bounding rect
+ * into the available area with map(), and may enlarge the windows into the remaining
+ * gaps with fillGaps().
+ *
+ * Overlap queries are answered by a uniform grid over the window geometries, so a
+ * single pass costs roughly linear time in the number of windows instead of quadratic
+ * time. The number of passes is bounded, and the result only depends on the order of
+ * the geometries passed in, so callers must sort them in a persistent order.
+ */
+class KWINEFFECTS_EXPORT NaturalLayout
+{
+public:
+    explicit NaturalLayout(const QVector<QRect> &geometries);
+
+    /**
+     * Minimum distance between two windows, default is @c 10.
+     */
+    int spacing() const;
+    void setSpacing(int spacing);
+
+    /**
+     * Distance in pixels windows are moved by in a single step, default is @c 20.
+     */
+    int accuracy() const;
+    void setAccuracy(int accuracy);
+
+    /**
+     * Pushes the windows apart until none of them overlap. @a bounds is grown to contain
+     * all of the windows. Returns @c false if the windows still overlap after the maximum
+     * number of passes.
+     */
+    bool separate(QRect &bounds);
+
+    /**
+     * Maps the windows from @a bounds into the area at @a origin, scaled by @a scale.
+     */
+    void map(const QRect &bounds, qreal scale, const QPoint &origin);
+
+    /**
+     * Enlarges the windows as long as they neither overlap each other nor @a border.
+     * Windows are not enlarged past twice their natural size, or their natural size if
+     * they are larger than 300 pixels.
+     */
+    void fillGaps(const QRegion &border);
+
+    /**
+     * Returns the number of passes the last call to separate() or fillGaps() took.
+     */
+    int passes() const;
+
+    const QVector<QRect> &targets() const;
+
+private:
+    int heightForWidth(int index, int width) const;
+
+    QVector<QRect> m_geometries;
+    QVector<QRect> m_targets;
+    int m_spacing = 10;
+    int m_accuracy = 20;
+    int m_passes = 0;
+};
+
+} // namespace KWin
+
+#endif
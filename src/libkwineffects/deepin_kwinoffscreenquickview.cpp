@@ -26,6 +26,8 @@
 #include <QOpenGLFramebufferObject>
 #include <QTimer>
 
+#include <cstring>
+
 #include <KDeclarative/QmlObjectSharedEngine>
 
 namespace KWin
@@ -66,6 +68,11 @@ public:
     QTimer *m_repaintTimer;
     QImage m_image;
     QScopedPointer<GLTexture> m_textureExport;
+    // parts of m_image that have not been uploaded to m_textureExport yet, in device pixels
+    QRegion m_textureDirty;
+    // what changed with the last update, in global logical coordinates
+    QRegion m_dirtyRegion;
+    QRect m_paintedGeometry;
     // if we should capture a QImage after rendering into our BO.
     // Used for either software QtQuick rendering and nonGL kwin rendering
     bool m_useBlit = false;
@@ -80,6 +87,7 @@ public:
     Qt::MouseButton lastMousePressButton = Qt::NoButton;
 
     void releaseResources();
+    void updateImage(const QImage &image);
 
     void updateTouchState(Qt::TouchPointState state, qint32 id, const QPointF& pos);
 };
@@ -259,14 +267,25 @@ void OffscreenQuickView::update()
     }
 
     if (d->m_useBlit) {
-        d->m_image = d->m_renderControl->grab();
+        d->updateImage(d->m_renderControl->grab());
+    } else {
+        // the contents never leave the GPU, comparing them would cost more than it saves
+        d->m_dirtyRegion = QRegion(d->m_paintedGeometry) + d->m_view->geometry();
+        d->m_paintedGeometry = d->m_view->geometry();
     }
 
     if (usingGl) {
         QOpenGLFramebufferObject::bindDefault();
         d->m_glcontext->doneCurrent();
     }
-    Q_EMIT repaintNeeded();
+    if (!d->m_dirtyRegion.isEmpty()) {
+        Q_EMIT repaintNeeded();
+    }
+}
+
+QRegion OffscreenQuickView::dirtyRegion() const
+{
+    return d->m_dirtyRegion;
 }
 
 void OffscreenQuickView::forwardMouseEvent(QEvent *e)
@@ -418,7 +437,14 @@ GLTexture *OffscreenQuickView::bufferAsTexture()
         if (d->m_image.isNull()) {
             return nullptr;
         }
-        d->m_textureExport.reset(new GLTexture(d->m_image));
+        if (!d->m_textureExport || d->m_textureExport->size() != d->m_image.size()) {
+            d->m_textureExport.reset(new GLTexture(d->m_image));
+        } else {
+            for (const QRect &rect : qAsConst(d->m_textureDirty)) {
+                d->m_textureExport->update(d->m_image, rect.topLeft(), rect);
+            }
+        }
+        d->m_textureDirty = QRegion();
     } else {
         if (!d->m_fbo) {
             return nullptr;
@@ -447,6 +473,74 @@ void OffscreenQuickView::setGeometry(const QRect &rect)
     Q_EMIT geometryChanged(oldGeometry, rect);
 }
 
+static QRegion changedTiles(const QImage &previous, const QImage &next)
+{
+    // compare in tiles, so a hover highlight doesn't turn into a full row of the view
+    const int tileSize = 64;
+    const int bytesPerPixel = next.depth() / 8;
+    const int tileColumns = (next.width() + tileSize - 1) / tileSize;
+
+    QRegion region;
+    QVector<bool> dirty(tileColumns);
+    for (int tileY = 0; tileY < next.height(); tileY += tileSize) {
+        const int rows = std::min(tileSize, next.height() - tileY);
+        std::fill(dirty.begin(), dirty.end(), false);
+        for (int y = tileY; y < tileY + rows; ++y) {
+            const uchar *previousLine = previous.constScanLine(y);
+            const uchar *nextLine = next.constScanLine(y);
+            for (int column = 0; column < tileColumns; ++column) {
+                if (dirty[column]) {
+                    continue;
+                }
+                const int x = column * tileSize;
+                const int width = std::min(tileSize, next.width() - x);
+                dirty[column] = std::memcmp(previousLine + x * bytesPerPixel, nextLine + x * bytesPerPixel, width * bytesPerPixel) != 0;
+            }
+        }
+        for (int column = 0; column < tileColumns; ++column) {
+            if (!dirty[column]) {
+                continue;
+            }
+            int last = column;
+            while (last + 1 < tileColumns && dirty[last + 1]) {
+                ++last;
+            }
+            const int x = column * tileSize;
+            region += QRect(x, tileY, std::min((last + 1) * tileSize, next.width()) - x, rows);
+            column = last;
+        }
+    }
+    return region;
+}
+
+void OffscreenQuickView::Private::updateImage(const QImage &image)
+{
+    QRegion changed;
+    if (image.size() != m_image.size() || image.format() != m_image.format() || image.depth() < 8) {
+        changed = QRect(QPoint(0, 0), image.size());
+    } else {
+        changed = changedTiles(m_image, image);
+    }
+    m_image = image;
+    m_textureDirty += changed;
+
+    const QRect geometry = m_view->geometry();
+    if (geometry != m_paintedGeometry) {
+        // the view moved, both the old and the new position need to be repainted
+        m_dirtyRegion = QRegion(m_paintedGeometry) + geometry;
+        m_paintedGeometry = geometry;
+        return;
+    }
+
+    // map the device pixels back to the logical coordinates of the view
+    const qreal scale = 1.0 / image.devicePixelRatio();
+    m_dirtyRegion = QRegion();
+    for (const QRect &rect : changed) {
+        const QRectF logical(rect.x() * scale, rect.y() * scale, rect.width() * scale, rect.height() * scale);
+        m_dirtyRegion += logical.toAlignedRect().translated(geometry.topLeft());
+    }
+}
+
 void OffscreenQuickView::Private::releaseResources()
 {
     if (m_glcontext) {
@@ -12,6 +12,7 @@
 #include <QObject>
 #include <QUrl>
 #include <QRect>
+#include <QRegion>
 
 #include <deepin_kwineffects_export.h>
 
@@ -132,6 +133,13 @@ public:
      */
     QImage bufferAsImage() const;
 
+    /**
+     * Returns the part of the view, in global coordinates, that changed with the last
+     * update. The whole view is reported if the contents can't be compared cheaply,
+     * e.g. if they are rendered into a texture.
+     */
+    QRegion dirtyRegion() const;
+
     /**
      * Inject any mouse event into the QQuickWindow.
      * Local co-ordinates are transformed
@@ -151,6 +159,7 @@ public:
 Q_SIGNALS:
     /**
      * The frame buffer has changed, contents need re-rendering on screen
+     * @see dirtyRegion
      */
     void repaintNeeded();
     void geometryChanged(const QRect &oldGeometry, const QRect &newGeometry);
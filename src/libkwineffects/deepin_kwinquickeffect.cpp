@@ -233,7 +233,7 @@ void QuickSceneEffect::addScreen(EffectScreen *screen)
     view->setAutomaticRepaint(false);
 
     connect(view, &QuickSceneView::repaintNeeded, this, [view]() {
-        effects->addRepaint(view->geometry());
+        effects->addRepaint(view->dirtyRegion());
     });
     connect(view, &QuickSceneView::renderRequested, view, &QuickSceneView::scheduleRepaint);
     connect(view, &QuickSceneView::sceneChanged, view, &QuickSceneView::scheduleRepaint);
@@ -37,6 +37,8 @@ bool GLTexturePrivate::s_supportsTextureStorage = false;
 bool GLTexturePrivate::s_supportsTextureSwizzle = false;
 bool GLTexturePrivate::s_supportsTextureFormatRG = false;
 uint GLTexturePrivate::s_fbo = 0;
+std::atomic<int> GLTexturePrivate::s_allocatedCount{0};
+std::atomic<qint64> GLTexturePrivate::s_allocatedBytes{0};
 
 // Table of GL formats/types associated with different values of QImage::Format.
 // Zero values indicate a direct upload is not feasible.
@@ -153,6 +155,7 @@ GLTexture::GLTexture(const QImage& image, GLenum target)
             glTexImage2D(d->m_target, 0, internalFormat, im.width(), im.height(), 0,
                          format, type, im.constBits());
         }
+        d->setAllocatedSize(im.size(), d->m_mipLevels);
     } else {
         d->m_internalFormat = GL_RGBA8;
 
@@ -165,6 +168,7 @@ GLTexture::GLTexture(const QImage& image, GLenum target)
             glTexImage2D(d->m_target, 0, GL_RGBA, im.width(), im.height(),
                          0, GL_RGBA, GL_UNSIGNED_BYTE, im.constBits());
         }
+        d->setAllocatedSize(image.size(), d->m_mipLevels);
     }
 
     unbind();
@@ -221,6 +225,7 @@ GLTexture::GLTexture(GLenum internalFormat, int width, int height, int levels, b
         // internalFormat() won't need to be specialized for GLES2.
         d->m_internalFormat = GL_RGBA8;
     }
+    d->setAllocatedSize(QSize(width, height), levels);
 
     unbind();
 }
@@ -290,6 +295,10 @@ GLTexturePrivate::GLTexturePrivate()
 
 GLTexturePrivate::~GLTexturePrivate()
 {
+    if (m_allocatedBytes) {
+        s_allocatedCount.fetch_sub(1, std::memory_order_relaxed);
+        s_allocatedBytes.fetch_sub(m_allocatedBytes, std::memory_order_relaxed);
+    }
     delete m_vbo;
     if (m_texture != 0 && !m_foreign) {
         glDeleteTextures(1, &m_texture);
@@ -648,6 +657,39 @@ void GLTexturePrivate::updateMatrix()
     }
 }
 
+static int bytesPerTexel(GLenum internalFormat)
+{
+    switch (internalFormat) {
+    case GL_R8:
+        return 1;
+    case GL_RGB4:
+    case GL_RGB5:
+    case GL_RGBA4:
+    case GL_RG8:
+        return 2;
+    case GL_RGBA16F:
+    case GL_RGB16F:
+        return 8;
+    default:
+        return 4;
+    }
+}
+
+void GLTexturePrivate::setAllocatedSize(const QSize &size, int levels)
+{
+    qint64 bytes = 0;
+    QSize level = size;
+    for (int i = 0; i < levels; ++i) {
+        bytes += qint64(level.width()) * level.height() * bytesPerTexel(m_internalFormat);
+        level = QSize(qMax(1, level.width() / 2), qMax(1, level.height() / 2));
+    }
+    if (!m_allocatedBytes) {
+        s_allocatedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    s_allocatedBytes.fetch_add(bytes - m_allocatedBytes, std::memory_order_relaxed);
+    m_allocatedBytes = bytes;
+}
+
 bool GLTexture::isYInverted() const
 {
     Q_D(const GLTexture);
@@ -712,6 +754,16 @@ bool GLTexture::supportsFormatRG()
     return GLTexturePrivate::s_supportsTextureFormatRG;
 }
 
+int GLTexture::allocatedTextureCount()
+{
+    return GLTexturePrivate::s_allocatedCount.load(std::memory_order_relaxed);
+}
+
+qint64 GLTexture::allocatedTextureBytes()
+{
+    return GLTexturePrivate::s_allocatedBytes.load(std::memory_order_relaxed);
+}
+
 QImage GLTexture::toImage() const
 {
     QImage ret(size(), QImage::Format_RGBA8888_Premultiplied);
@@ -22,6 +22,8 @@
 #include <QMatrix4x4>
 #include <epoxy/gl.h>
 
+#include <atomic>
+
 namespace KWin
 {
 // forward declarations
@@ -37,6 +39,7 @@ public:
     virtual void onDamage();
 
     void updateMatrix();
+    void setAllocatedSize(const QSize &size, int levels);
 
     GLuint m_texture;
     GLenum m_target;
@@ -59,6 +62,7 @@ public:
     int m_normalizeActive; // 0 - no, otherwise refcount
     GLVertexBuffer* m_vbo;
     QSize m_cachedSize;
+    qint64 m_allocatedBytes = 0;
 
     static void initStatic();
 
@@ -69,6 +73,8 @@ public:
     static bool s_supportsTextureSwizzle;
     static bool s_supportsTextureFormatRG;
     static GLuint s_fbo;
+    static std::atomic<int> s_allocatedCount;
+    static std::atomic<qint64> s_allocatedBytes;
 private:
     friend void KWin::cleanupGL();
     static void cleanup();
@@ -0,0 +1,238 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "performancemonitor.h"
+#include "deleted.h"
+
+#include <deepin_kwingltexture.h>
+
+#include <algorithm>
+
+namespace KWin
+{
+
+// upper bounds of the histogram buckets, in microseconds
+static const std::array<qint64, PerformanceHistogram::BucketCount - 1> s_bucketLimits = {
+    1000, 2000, 4000, 6000, 8000, 10000, 12000, 14000, 16700, 20000, 25000, 33400, 50000, 100000, 250000,
+};
+
+static quint64 readCounter(std::atomic<quint64> &counter, bool reset)
+{
+    return reset ? counter.exchange(0, std::memory_order_relaxed) : counter.load(std::memory_order_relaxed);
+}
+
+void PerformanceHistogram::record(std::chrono::nanoseconds duration)
+{
+    const qint64 microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    const int bucket = std::upper_bound(s_bucketLimits.begin(), s_bucketLimits.end(), microseconds) - s_bucketLimits.begin();
+    const quint64 value = std::max<qint64>(0, duration.count());
+
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    quint64 max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+QVariantMap PerformanceHistogram::snapshot(bool reset)
+{
+    QVariantList limits;
+    QVariantList buckets;
+    for (int i = 0; i < BucketCount; ++i) {
+        if (i < int(s_bucketLimits.size())) {
+            limits.append(s_bucketLimits[i]);
+        }
+        buckets.append(readCounter(m_buckets[i], reset));
+    }
+    return QVariantMap{
+        {QStringLiteral("bucketLimits"), limits},
+        {QStringLiteral("buckets"), buckets},
+        {QStringLiteral("count"), readCounter(m_count, reset)},
+        {QStringLiteral("sum"), readCounter(m_sum, reset)},
+        {QStringLiteral("max"), readCounter(m_max, reset)},
+    };
+}
+
+QVariantMap FrameStatistics::snapshot(bool reset)
+{
+    const quint64 presented = readCounter(presentedFrames, reset);
+    const quint64 scanout = readCounter(directScanoutFrames, reset);
+    return QVariantMap{
+        {QStringLiteral("renderTime"), renderTime.snapshot(reset)},
+        {QStringLiteral("frameTime"), frameTime.snapshot(reset)},
+        {QStringLiteral("presentedFrames"), presented},
+        {QStringLiteral("failedFrames"), readCounter(failedFrames, reset)},
+        {QStringLiteral("missedVblanks"), readCounter(missedVblanks, reset)},
+        {QStringLiteral("directScanoutFrames"), scanout},
+        {QStringLiteral("directScanoutRate"), presented ? qreal(scanout) / presented : 0.0},
+        {QStringLiteral("cursorOnlyFrames"), readCounter(cursorOnlyFrames, reset)},
+    };
+}
+
+QVariantMap EffectStatistics::snapshot(bool reset)
+{
+    static const std::array<QString, HookCount> hookNames = {
+        QStringLiteral("prePaintScreen"),
+        QStringLiteral("paintScreen"),
+        QStringLiteral("postPaintScreen"),
+        QStringLiteral("prePaintWindow"),
+        QStringLiteral("paintWindow"),
+        QStringLiteral("drawWindow"),
+        QStringLiteral("postPaintWindow"),
+        QStringLiteral("paintEffectFrame"),
+    };
+
+    QVariantMap ret;
+    for (int i = 0; i < HookCount; ++i) {
+        ret.insert(hookNames[i], QVariantMap{
+            {QStringLiteral("time"), readCounter(time[i], reset)},
+            {QStringLiteral("gpuTime"), readCounter(gpuTime[i], reset)},
+            {QStringLiteral("calls"), readCounter(calls[i], reset)},
+        });
+    }
+    return ret;
+}
+
+QVariantMap X11SyncStatistics::snapshot(bool reset)
+{
+    return QVariantMap{
+        {QStringLiteral("fenceLatency"), fenceLatency.snapshot(reset)},
+        {QStringLiteral("stallTime"), stallTime.snapshot(reset)},
+        {QStringLiteral("skippedFrames"), readCounter(skippedFrames, reset)},
+        {QStringLiteral("timeouts"), readCounter(timeouts, reset)},
+        {QStringLiteral("fenceCount"), quint64(fenceCount.load(std::memory_order_relaxed))},
+    };
+}
+
+QVariantMap RenderNodeCacheStatistics::snapshot(bool reset)
+{
+    return QVariantMap{
+        {QStringLiteral("reused"), readCounter(reused, reset)},
+        {QStringLiteral("rebuilt"), readCounter(rebuilt, reset)},
+    };
+}
+
+KWIN_SINGLETON_FACTORY(PerformanceMonitor)
+
+PerformanceMonitor::PerformanceMonitor(QObject *parent)
+    : QObject(parent)
+    , m_resetTime(std::chrono::steady_clock::now())
+{
+    if (qEnvironmentVariableIntValue("KWIN_EFFECT_PROFILING")) {
+        beginEffectProfiling();
+    }
+}
+
+PerformanceMonitor::~PerformanceMonitor()
+{
+    s_self = nullptr;
+}
+
+template<typename T>
+static T *findOrCreate(std::map<QString, std::unique_ptr<T>> &map, const QString &key)
+{
+    auto it = map.find(key);
+    if (it == map.end()) {
+        it = map.emplace(key, std::make_unique<T>()).first;
+    }
+    return it->second.get();
+}
+
+FrameStatistics *PerformanceMonitor::frameStatistics(const QString &output)
+{
+    return findOrCreate(m_outputs, output);
+}
+
+EffectStatistics *PerformanceMonitor::effectStatistics(const QString &effect)
+{
+    return findOrCreate(m_effects, effect);
+}
+
+PerformanceHistogram *PerformanceMonitor::inputLatency(const QString &device)
+{
+    return findOrCreate(m_inputLatency, device);
+}
+
+X11SyncStatistics *PerformanceMonitor::x11SyncStatistics()
+{
+    return &m_x11Sync;
+}
+
+RenderNodeCacheStatistics *PerformanceMonitor::renderNodeCacheStatistics()
+{
+    return &m_renderNodeCache;
+}
+
+QVariantMap PerformanceMonitor::snapshot(bool reset)
+{
+    QVariantMap outputs;
+    for (const auto &[name, statistics] : m_outputs) {
+        outputs.insert(name, statistics->snapshot(reset));
+    }
+    QVariantMap effects;
+    for (const auto &[name, statistics] : m_effects) {
+        effects.insert(name, statistics->snapshot(reset));
+    }
+    QVariantMap inputLatency;
+    for (const auto &[name, histogram] : m_inputLatency) {
+        inputLatency.insert(name, histogram->snapshot(reset));
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const QVariantMap ret{
+        {QStringLiteral("interval"), qint64(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_resetTime).count())},
+        {QStringLiteral("outputs"), outputs},
+        {QStringLiteral("effects"), effects},
+        {QStringLiteral("inputLatency"), inputLatency},
+        {QStringLiteral("x11Sync"), m_x11Sync.snapshot(reset)},
+        {QStringLiteral("renderNodeCache"), m_renderNodeCache.snapshot(reset)},
+        {QStringLiteral("deletedWindows"), QVariantMap{
+            {QStringLiteral("count"), Deleted::retainedSnapshotCount()},
+            {QStringLiteral("bytes"), Deleted::retainedSnapshotBytes()},
+            {QStringLiteral("dropped"), Deleted::droppedSnapshotCount()},
+        }},
+        {QStringLiteral("textures"), QVariantMap{
+            {QStringLiteral("count"), GLTexture::allocatedTextureCount()},
+            {QStringLiteral("bytes"), GLTexture::allocatedTextureBytes()},
+        }},
+    };
+    if (reset) {
+        m_resetTime = now;
+    }
+    return ret;
+}
+
+void PerformanceMonitor::reset()
+{
+    snapshot(true);
+}
+
+QVector<EffectCost> PerformanceMonitor::effectCosts() const
+{
+    QVector<EffectCost> costs;
+    costs.reserve(m_effects.size());
+    for (const auto &[name, statistics] : m_effects) {
+        EffectCost cost{name, std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero()};
+        for (int i = 0; i < EffectStatistics::HookCount; ++i) {
+            cost.cpuTime += std::chrono::nanoseconds(statistics->time[i].load(std::memory_order_relaxed));
+            cost.gpuTime += std::chrono::nanoseconds(statistics->gpuTime[i].load(std::memory_order_relaxed));
+        }
+        costs.append(cost);
+    }
+    return costs;
+}
+
+void PerformanceMonitor::beginEffectProfiling()
+{
+    m_effectProfilingCount++;
+}
+
+void PerformanceMonitor::endEffectProfiling()
+{
+    Q_ASSERT(m_effectProfilingCount > 0);
+    m_effectProfilingCount--;
+}
+
+} // namespace KWin
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <deepin_kwineffectsex.h>
+#include <deepin_kwinglobals.h>
+
+#include <QObject>
+#include <QVariantMap>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+
+namespace KWin
+{
+
+/**
+ * The PerformanceHistogram class counts durations in fixed buckets.
+ *
+ * Recording a sample only touches relaxed atomics, so it is cheap enough to be done for
+ * every frame and can be read from another thread while samples are being recorded.
+ */
+class KWIN_EXPORT PerformanceHistogram
+{
+public:
+    static constexpr int BucketCount = 16;
+
+    void record(std::chrono::nanoseconds duration);
+
+    /**
+     * Returns the buckets, count, sum and maximum of the histogram. The upper bound of
+     * every bucket is reported in microseconds, the last bucket is open ended. If @a reset
+     * is @c true, the histogram is cleared while it is read.
+     */
+    QVariantMap snapshot(bool reset = false);
+
+private:
+    std::array<std::atomic<quint64>, BucketCount> m_buckets = {};
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sum{0};
+    std::atomic<quint64> m_max{0};
+};
+
+/**
+ * Frame statistics of a single output.
+ */
+struct KWIN_EXPORT FrameStatistics
+{
+    QVariantMap snapshot(bool reset = false);
+
+    // time spent in the compositing pass, from RenderLoop::beginFrame() to endFrame()
+    PerformanceHistogram renderTime;
+    // time from the start of the compositing pass until the frame was presented
+    PerformanceHistogram frameTime;
+    std::atomic<quint64> presentedFrames{0};
+    std::atomic<quint64> failedFrames{0};
+    std::atomic<quint64> missedVblanks{0};
+    std::atomic<quint64> directScanoutFrames{0};
+    // frames in which only the software cursor was repainted
+    std::atomic<quint64> cursorOnlyFrames{0};
+};
+
+/**
+ * Cumulative cost of a single effect in the paint chain, excluding the time spent in the
+ * effects further down the chain. GPU time is only collected while effect profiling is
+ * enabled and the driver supports timer queries.
+ */
+struct KWIN_EXPORT EffectStatistics
+{
+    enum Hook {
+        PrePaintScreen,
+        PaintScreen,
+        PostPaintScreen,
+        PrePaintWindow,
+        PaintWindow,
+        DrawWindow,
+        PostPaintWindow,
+        PaintEffectFrame,
+        HookCount,
+    };
+
+    void record(Hook hook, std::chrono::nanoseconds duration);
+    void recordGpu(Hook hook, std::chrono::nanoseconds duration);
+    QVariantMap snapshot(bool reset = false);
+
+    std::array<std::atomic<quint64>, HookCount> time = {};
+    std::array<std::atomic<quint64>, HookCount> gpuTime = {};
+    std::array<std::atomic<quint64>, HookCount> calls = {};
+};
+
+/**
+ * Statistics of the fences used to synchronize with the X command stream, see X11SyncManager.
+ */
+struct KWIN_EXPORT X11SyncStatistics
+{
+    QVariantMap snapshot(bool reset = false);
+
+    // time from triggering a fence until it was seen signaled
+    PerformanceHistogram fenceLatency;
+    // time frames were held back because no fence was free
+    PerformanceHistogram stallTime;
+    std::atomic<quint64> skippedFrames{0};
+    std::atomic<quint64> timeouts{0};
+    // the current size of the fence ring, it is not reset
+    std::atomic<quint64> fenceCount{0};
+};
+
+/**
+ * Counts the windows painted with the item list cached from a previous frame, and the
+ * ones whose item tree had to be walked again.
+ */
+struct KWIN_EXPORT RenderNodeCacheStatistics
+{
+    void record(bool reused);
+    QVariantMap snapshot(bool reset = false);
+
+    std::atomic<quint64> reused{0};
+    std::atomic<quint64> rebuilt{0};
+};
+
+/**
+ * The PerformanceMonitor collects performance counters of the compositor.
+ *
+ * The counters are always on and are exported through the org.deepin.KWin.Performance
+ * D-Bus interface. Entries are created on the main thread, the returned pointers stay
+ * valid for the lifetime of the monitor.
+ */
+class KWIN_EXPORT PerformanceMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~PerformanceMonitor() override;
+
+    FrameStatistics *frameStatistics(const QString &output);
+    EffectStatistics *effectStatistics(const QString &effect);
+    PerformanceHistogram *inputLatency(const QString &device);
+    X11SyncStatistics *x11SyncStatistics();
+    RenderNodeCacheStatistics *renderNodeCacheStatistics();
+
+    /**
+     * Returns all counters collected since the last reset. If @a reset is @c true, the
+     * counters are cleared while they are read, so no sample is lost between two
+     * consecutive snapshots.
+     */
+    QVariantMap snapshot(bool reset = false);
+    void reset();
+
+    /**
+     * Returns the cumulative cost of all effects, summed over the paint hooks.
+     */
+    QVector<EffectCost> effectCosts() const;
+
+    /**
+     * Returns @c true if the window hooks of effects are measured too. Effect profiling is
+     * enabled as long as there is at least one user of it, or if the KWIN_EFFECT_PROFILING
+     * environment variable is set.
+     */
+    bool isEffectProfilingEnabled() const;
+    void beginEffectProfiling();
+    void endEffectProfiling();
+
+private:
+    std::map<QString, std::unique_ptr<FrameStatistics>> m_outputs;
+    std::map<QString, std::unique_ptr<EffectStatistics>> m_effects;
+    std::map<QString, std::unique_ptr<PerformanceHistogram>> m_inputLatency;
+    X11SyncStatistics m_x11Sync;
+    RenderNodeCacheStatistics m_renderNodeCache;
+    std::chrono::steady_clock::time_point m_resetTime;
+    int m_effectProfilingCount = 0;
+    KWIN_SINGLETON(PerformanceMonitor)
+};
+
+inline void EffectStatistics::record(Hook hook, std::chrono::nanoseconds duration)
+{
+    time[hook].fetch_add(duration.count(), std::memory_order_relaxed);
+    calls[hook].fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void EffectStatistics::recordGpu(Hook hook, std::chrono::nanoseconds duration)
+{
+    gpuTime[hook].fetch_add(duration.count(), std::memory_order_relaxed);
+}
+
+inline void RenderNodeCacheStatistics::record(bool reused)
+{
+    (reused ? this->reused : rebuilt).fetch_add(1, std::memory_order_relaxed);
+}
+
+inline bool PerformanceMonitor::isEffectProfilingEnabled() const
+{
+    return m_effectProfilingCount > 0;
+}
+
+} // namespace KWin
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "screencastpacer.h"
+
+namespace KWin
+{
+
+void ScreenCastPacer::addDamage(const QRegion &region)
+{
+    m_pendingDamage += region;
+}
+
+void ScreenCastPacer::addCursorUpdate()
+{
+    m_pendingCursorUpdate = true;
+}
+
+bool ScreenCastPacer::hasPendingUpdate() const
+{
+    return m_pendingCursorUpdate || !m_pendingDamage.isEmpty();
+}
+
+QRegion ScreenCastPacer::pendingDamage() const
+{
+    return m_pendingDamage;
+}
+
+bool ScreenCastPacer::hasPendingCursorUpdate() const
+{
+    return m_pendingCursorUpdate;
+}
+
+std::chrono::milliseconds ScreenCastPacer::delay(Clock::time_point now, std::chrono::nanoseconds interval) const
+{
+    const auto elapsed = now - m_lastCaptureTime;
+    if (interval <= std::chrono::nanoseconds::zero() || elapsed >= interval) {
+        return std::chrono::milliseconds::zero();
+    }
+    return std::chrono::ceil<std::chrono::milliseconds>(interval - elapsed);
+}
+
+QRegion ScreenCastPacer::takeDamage(Clock::time_point now)
+{
+    const QRegion damage = m_pendingDamage;
+    m_pendingDamage = QRegion();
+    m_pendingCursorUpdate = false;
+    m_lastCaptureTime = now;
+    return damage;
+}
+
+} // namespace KWin
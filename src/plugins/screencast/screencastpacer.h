@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <QRegion>
+
+#include <chrono>
+
+namespace KWin
+{
+
+/**
+ * The ScreenCastPacer class collects the updates of a screencast stream between two
+ * queued buffers and decides when the next buffer may be captured.
+ *
+ * The output may repaint far more often than the consumer wants frames. The damage of
+ * the repaints that are not captured is accumulated, so the next captured frame reports
+ * everything that changed since the previous one. Cursor updates of a metadata cursor
+ * are paced the same way and sent with the next buffer.
+ */
+class ScreenCastPacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void addDamage(const QRegion &region);
+    void addCursorUpdate();
+
+    bool hasPendingUpdate() const;
+    QRegion pendingDamage() const;
+    bool hasPendingCursorUpdate() const;
+
+    /**
+     * Returns how long to wait at @a now until the pending update may be captured at one
+     * buffer per @a interval, or zero if it may be captured right away. An @a interval of
+     * zero doesn't limit the rate.
+     */
+    std::chrono::milliseconds delay(Clock::time_point now, std::chrono::nanoseconds interval) const;
+
+    /**
+     * Returns the damage accumulated since the previous buffer and clears the pending
+     * update. The interval to the next buffer starts at @a now.
+     */
+    QRegion takeDamage(Clock::time_point now);
+
+private:
+    QRegion m_pendingDamage;
+    bool m_pendingCursorUpdate = false;
+    Clock::time_point m_lastCaptureTime;
+};
+
+} // namespace KWin
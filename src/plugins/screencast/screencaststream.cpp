@@ -216,10 +216,17 @@ ScreenCastStream::ScreenCastStream(ScreenCastSource *source, QObject *parent)
     pwStreamEvents.remove_buffer = &ScreenCastStream::onStreamRemoveBuffer;
     pwStreamEvents.state_changed = &ScreenCastStream::onStreamStateChanged;
     pwStreamEvents.param_changed = &ScreenCastStream::onStreamParamChanged;
+
+    m_pendingFrameTimer.setSingleShot(true);
+    m_pendingFrameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_pendingFrameTimer, &QTimer::timeout, this, &ScreenCastStream::capturePendingFrame);
 }
 
 ScreenCastStream::~ScreenCastStream()
 {
+    qCDebug(KWIN_SCREENCAST) << "Stream" << objectName() << "captured" << m_statistics.capturedFrames
+                             << "frames, skipped" << m_statistics.skippedFrames
+                             << "and sent" << m_statistics.cursorUpdates << "cursor updates";
     m_stopped = true;
     if (pwStream) {
         pw_stream_destroy(pwStream);
@@ -327,17 +334,56 @@ void ScreenCastStream::stop()
     delete this;
 }
 
+std::chrono::nanoseconds ScreenCastStream::frameInterval() const
+{
+    if (!videoFormat.max_framerate.num) {
+        return std::chrono::nanoseconds::zero();
+    }
+    return std::chrono::nanoseconds(std::chrono::seconds(videoFormat.max_framerate.denom)) / videoFormat.max_framerate.num;
+}
+
+void ScreenCastStream::capturePendingFrame()
+{
+    if (m_stopped) {
+        return;
+    }
+    if (auto scene = Compositor::self()->scene()) {
+        scene->makeOpenGLContextCurrent();
+    }
+    recordFrame(QRegion());
+}
+
 void ScreenCastStream::recordFrame(const QRegion &damagedRegion)
 {
     Q_ASSERT(!m_stopped);
 
+    m_pacer.addDamage(damagedRegion);
+    if (!m_pacer.hasPendingUpdate()) {
+        return;
+    }
+
     if (m_pendingBuffer) {
-        qCWarning(KWIN_SCREENCAST) << "Dropping a screencast frame because the compositor is slow";
+        // the previous frame is still being rendered, enqueue() will pick up the damage
+        m_statistics.skippedFrames++;
+        return;
+    }
+
+    // only capture at the negotiated rate, the skipped updates go into the next buffer
+    const std::chrono::nanoseconds interval = frameInterval();
+    const auto now = ScreenCastPacer::Clock::now();
+    const std::chrono::milliseconds delay = m_pacer.delay(now, interval);
+    if (delay > std::chrono::milliseconds::zero()) {
+        m_statistics.skippedFrames++;
+        if (!m_pendingFrameTimer.isActive()) {
+            m_pendingFrameTimer.start(delay);
+        }
         return;
     }
+    m_pendingFrameTimer.stop();
 
     if (m_source->textureSize() != m_resolution) {
         m_resolution = m_source->textureSize();
+        m_pacer.addDamage(QRect(QPoint(), m_resolution));
         newStreamParams();
         return;
     }
@@ -354,12 +400,32 @@ void ScreenCastStream::recordFrame(const QRegion &damagedRegion)
     struct pw_buffer *buffer = pw_stream_dequeue_buffer(pwStream);
 
     if (!buffer) {
+        // All buffers are held by the consumer, keep the damage and retry once it had a
+        // chance to give one back. The output may not repaint again, so don't wait for that.
+        m_statistics.skippedFrames++;
+        if (!m_pendingFrameTimer.isActive()) {
+            const std::chrono::milliseconds retry = interval > std::chrono::nanoseconds::zero()
+                ? std::chrono::ceil<std::chrono::milliseconds>(interval)
+                : std::chrono::milliseconds(16);
+            m_pendingFrameTimer.start(retry);
+        }
         return;
     }
 
     struct spa_buffer *spa_buffer = buffer->buffer;
     struct spa_data *spa_data = spa_buffer->datas;
 
+    if (m_pacer.pendingDamage().isEmpty()) {
+        // only the metadata cursor moved, send it without the contents
+        m_pacer.takeDamage(now);
+        m_statistics.cursorUpdates++;
+        spa_data->chunk->size = 0;
+        sendCursorData(Cursors::self()->currentCursor(),
+                       (spa_meta_cursor *) spa_buffer_find_meta_data (spa_buffer, SPA_META_Cursor, sizeof (spa_meta_cursor)));
+        tryEnqueue(buffer);
+        return;
+    }
+
     uint8_t *data = (uint8_t *) spa_data->data;
     if (!data && spa_buffer->datas->type != SPA_DATA_DmaBuf) {
         qCWarning(KWIN_SCREENCAST) << "Failed to record frame: invalid buffer data";
@@ -367,6 +433,9 @@ void ScreenCastStream::recordFrame(const QRegion &damagedRegion)
         return;
     }
 
+    const QRegion damage = m_pacer.takeDamage(now);
+    m_statistics.capturedFrames++;
+
     const auto size = m_source->textureSize();
     spa_data->chunk->offset = 0;
     if (data || spa_data[0].type == SPA_DATA_MemFd) {
@@ -441,14 +510,14 @@ void ScreenCastStream::recordFrame(const QRegion &damagedRegion)
         struct spa_meta_region *r = (spa_meta_region *) spa_meta_first(vdMeta);
 
         // If there's too many rectangles, we just send the bounding rect
-        if (damagedRegion.rectCount() > videoDamageRegionCount - 1) {
+        if (damage.rectCount() > videoDamageRegionCount - 1) {
             if (spa_meta_check(r, vdMeta)) {
-                auto rect = damagedRegion.boundingRect();
+                auto rect = damage.boundingRect();
                 r->region = SPA_REGION(rect.x(), rect.y(), quint32(rect.width()), quint32(rect.height()));
                 r++;
             }
         } else {
-            for (const QRect &rect : damagedRegion) {
+            for (const QRect &rect : damage) {
                 if (spa_meta_check(r, vdMeta)) {
                     r->region = SPA_REGION(rect.x(), rect.y(), quint32(rect.width()), quint32(rect.height()));
                     r++;
@@ -468,32 +537,8 @@ void ScreenCastStream::recordCursor()
 {
     Q_ASSERT(!m_stopped);
 
-    if (m_pendingBuffer) {
-        qCWarning(KWIN_SCREENCAST) << "Dropping a screencast cursor update because the compositor is slow";
-        return;
-    }
-
-    const char *error = "";
-    auto state = pw_stream_get_state(pwStream, &error);
-    if (state != PW_STREAM_STATE_STREAMING) {
-        if (error) {
-            qCWarning(KWIN_SCREENCAST) << "Failed to record cursor position: stream is not active" << error;
-        }
-        return;
-    }
-
-    struct pw_buffer *buffer = pw_stream_dequeue_buffer(pwStream);
-
-    if (!buffer) {
-        return;
-    }
-
-    struct spa_buffer *spa_buffer = buffer->buffer;
-    spa_buffer->datas[0].chunk->size = 0;
-    sendCursorData(Cursors::self()->currentCursor(),
-                   (spa_meta_cursor *) spa_buffer_find_meta_data (spa_buffer, SPA_META_Cursor, sizeof (spa_meta_cursor)));
-
-    tryEnqueue(buffer);
+    m_pacer.addCursorUpdate();
+    capturePendingFrame();
 }
 
 void ScreenCastStream::tryEnqueue(pw_buffer *buffer)
@@ -536,6 +581,11 @@ void ScreenCastStream::enqueue()
     m_pendingBuffer = nullptr;
     m_pendingFence = nullptr;
     m_pendingNotifier = nullptr;
+
+    // catch up with the updates that arrived while the buffer was busy
+    if (m_pacer.hasPendingUpdate() && !m_pendingFrameTimer.isActive()) {
+        m_pendingFrameTimer.start(0);
+    }
 }
 
 spa_pod *ScreenCastStream::buildFormat(struct spa_pod_builder *b, enum spa_video_format format, struct spa_rectangle *resolution,
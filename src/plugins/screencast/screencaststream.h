@@ -10,6 +10,7 @@
 
 #include "config-kwin.h"
 #include "deepin_kwinglobals.h"
+#include "screencastpacer.h"
 
 #include <DWayland/Server/screencast_v1_interface.h>
 
@@ -18,6 +19,9 @@
 #include <QSharedPointer>
 #include <QSize>
 #include <QSocketNotifier>
+#include <QTimer>
+
+#include <chrono>
 
 #include <pipewire/pipewire.h>
 #include <spa/param/format-utils.h>
@@ -50,9 +54,26 @@ public:
 
     void stop();
 
-    /** Renders @p frame into the current framebuffer into the stream */
+    /**
+     * Renders the source into the stream. The damage is accumulated and the frame is only
+     * captured if the negotiated maximum framerate allows it, otherwise it is captured
+     * later with the damage of all skipped frames.
+     */
     void recordFrame(const QRegion &damagedRegion);
 
+    struct Statistics
+    {
+        // frames that have been rendered into a buffer and queued
+        quint64 capturedFrames = 0;
+        // repaints that were folded into a later frame due to pacing or a busy buffer
+        quint64 skippedFrames = 0;
+        // buffers that only carry the position of a metadata cursor
+        quint64 cursorUpdates = 0;
+    };
+    const Statistics &statistics() const {
+        return m_statistics;
+    }
+
     void setCursorMode(KWaylandServer::ScreencastV1Interface::CursorMode mode, qreal scale, const QRect &viewport);
 
 public Q_SLOTS:
@@ -76,6 +97,8 @@ private:
     void newStreamParams();
     void tryEnqueue(pw_buffer *buffer);
     void enqueue();
+    void capturePendingFrame();
+    std::chrono::nanoseconds frameInterval() const;
     spa_pod* buildFormat(struct spa_pod_builder *b, enum spa_video_format format, struct spa_rectangle *resolution,
                          struct spa_fraction *defaultFramerate, struct spa_fraction *minFramerate, struct spa_fraction *maxFramerate,
                          uint64_t *modifiers, int modifier_count);
@@ -111,6 +134,10 @@ private:
     pw_buffer *m_pendingBuffer = nullptr;
     QSocketNotifier *m_pendingNotifier = nullptr;
     EGLNativeFence *m_pendingFence = nullptr;
+
+    ScreenCastPacer m_pacer;
+    QTimer m_pendingFrameTimer;
+    Statistics m_statistics;
 };
 
 } // namespace KWin
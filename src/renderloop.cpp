@@ -5,7 +5,9 @@
 */
 
 #include "renderloop.h"
+#include "inputlatencytracker.h"
 #include "options.h"
+#include "performancemonitor.h"
 #include "renderloop_p.h"
 #include "surfaceitem.h"
 #include "utils/common.h"
@@ -114,6 +116,10 @@ void RenderLoopPrivate::notifyFrameFailed()
     Q_ASSERT(pendingFrameCount > 0);
     pendingFrameCount--;
 
+    if (statistics) {
+        statistics->failedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+
     if (!inhibitCount) {
         maybeScheduleRepaint();
     }
@@ -134,6 +140,23 @@ void RenderLoopPrivate::notifyFrameCompleted(std::chrono::nanoseconds timestamp)
         lastPresentationTimestamp = std::chrono::steady_clock::now().time_since_epoch();
     }
 
+    if (statistics) {
+        statistics->presentedFrames.fetch_add(1, std::memory_order_relaxed);
+        statistics->frameTime.record(lastPresentationTimestamp - frameStartTimestamp);
+        // With a fixed refresh rate, the frame is expected at the vblank it has been scheduled for.
+        if (presentMode == SyncMode::Fixed && nextPresentationTimestamp != std::chrono::nanoseconds::zero()) {
+            const std::chrono::nanoseconds vblankInterval(1'000'000'000'000ull / refreshRate);
+            const std::chrono::nanoseconds delay = lastPresentationTimestamp - nextPresentationTimestamp + vblankInterval / 2;
+            if (delay >= vblankInterval) {
+                statistics->missedVblanks.fetch_add(delay / vblankInterval, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (InputLatencyTracker *tracker = InputLatencyTracker::self()) {
+        tracker->notifyFramePresented(frameStartTimestamp, lastPresentationTimestamp);
+    }
+
     if (!inhibitCount) {
         maybeScheduleRepaint();
     }
@@ -195,11 +218,15 @@ void RenderLoop::beginFrame()
     d->pendingRepaint = false;
     d->pendingFrameCount++;
     d->renderJournal.beginFrame();
+    d->frameStartTimestamp = std::chrono::steady_clock::now().time_since_epoch();
 }
 
 void RenderLoop::endFrame()
 {
     d->renderJournal.endFrame();
+    if (d->statistics) {
+        d->statistics->renderTime.record(std::chrono::steady_clock::now().time_since_epoch() - d->frameStartTimestamp);
+    }
 }
 
 int RenderLoop::refreshRate() const
@@ -218,7 +245,13 @@ void RenderLoop::setRefreshRate(int refreshRate)
 
 void RenderLoop::scheduleRepaint(Item *item)
 {
-    if (d->pendingRepaint || (d->fullscreenItem != nullptr && item != nullptr && item != d->fullscreenItem)) {
+    if (d->fullscreenItem != nullptr && item != nullptr && item != d->fullscreenItem) {
+        return;
+    }
+    if (InputLatencyTracker *tracker = InputLatencyTracker::self()) {
+        tracker->notifyRepaintScheduled();
+    }
+    if (d->pendingRepaint) {
         return;
     }
     if (!d->pendingFrameCount && !d->inhibitCount) {
@@ -14,6 +14,8 @@
 namespace KWin
 {
 
+struct FrameStatistics;
+
 class KWIN_EXPORT RenderLoopPrivate
 {
 public:
@@ -33,6 +35,7 @@ public:
     RenderLoop *q;
     std::chrono::nanoseconds lastPresentationTimestamp = std::chrono::nanoseconds::zero();
     std::chrono::nanoseconds nextPresentationTimestamp = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds frameStartTimestamp = std::chrono::nanoseconds::zero();
     QTimer compositeTimer;
     RenderJournal renderJournal;
     int refreshRate = 60000;
@@ -42,6 +45,7 @@ public:
     bool pendingRepaint = false;
     RenderLoop::VrrPolicy vrrPolicy = RenderLoop::VrrPolicy::Never;
     Item *fullscreenItem = nullptr;
+    FrameStatistics *statistics = nullptr;
 
     enum class SyncMode {
         Fixed,
@@ -70,8 +70,11 @@
 #include "x11client.h"
 #include "deleted.h"
 #include "effects.h"
+#include "performancemonitor.h"
 #include "renderloop.h"
+#include "renderloop_p.h"
 #include "shadow.h"
+#include "splitmanage.h"
 #include "wayland_server.h"
 #include "composite.h"
 #include <QtMath>
@@ -119,7 +122,14 @@ void Scene::addCursorRepaints()
     repaintRegion |= m_lastCursorGeometry;
     for (const auto &output : outputs) {
         auto intersection = repaintRegion.intersected(output->geometry());
-        if (!intersection.isEmpty() && output->usesSoftwareCursor()) {
+        if (intersection.isEmpty() || !output->usesSoftwareCursor()) {
+            continue;
+        }
+        if (kwinApp()->platform()->isPerScreenRenderingEnabled()) {
+            // kept apart from the other repaints so that the cursor can be painted on its own
+            m_cursorRepaints[output] += intersection;
+            output->renderLoop()->scheduleRepaint();
+        } else {
             addRepaint(intersection);
         }
     }
@@ -176,14 +186,72 @@ QRegion Scene::repaints(AbstractOutput *output) const
     return m_repaints.value(output, infiniteRegion());
 }
 
+QRegion Scene::cursorRepaints(AbstractOutput *output) const
+{
+    return m_cursorRepaints.value(output);
+}
+
 void Scene::resetRepaints(AbstractOutput *output)
 {
     m_repaints.insert(output, QRegion());
+    m_cursorRepaints.remove(output);
 }
 
 void Scene::removeRepaints(AbstractOutput *output)
 {
     m_repaints.remove(output);
+    m_cursorRepaints.remove(output);
+}
+
+static bool hasRepaints(Item *item, AbstractOutput *output)
+{
+    if (!item->repaints(output).isEmpty()) {
+        return true;
+    }
+    const auto childItems = item->childItems();
+    for (Item *childItem : childItems) {
+        if (hasRepaints(childItem, output)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Scene::paintCursorOnly(AbstractOutput *output, const QRegion &damage, const QList<Toplevel *> &windows,
+                            RenderLoop *renderLoop)
+{
+    // the cursor-only frame skips the effect hooks, an active effect may transform the
+    // screen or react to the pointer in its own way
+    if (!output || effects->hasActiveFullScreenEffect()
+            || static_cast<EffectsHandlerImpl *>(effects)->hasActiveEffects()) {
+        return false;
+    }
+    // the split outline follows the pointer, showing it needs a full frame
+    if (SplitManage::instance()->isShowSplitLine(output->name())) {
+        return false;
+    }
+    for (Toplevel *toplevel : windows) {
+        Window *window = m_windows.value(toplevel);
+        if (window && hasRepaints(window->windowItem(), output)) {
+            return false;
+        }
+    }
+    if (!paintCursorFrame(output, damage & output->geometry(), renderLoop)) {
+        return false;
+    }
+    if (FrameStatistics *statistics = RenderLoopPrivate::get(renderLoop)->statistics) {
+        statistics->cursorOnlyFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    Q_EMIT frameRendered();
+    return true;
+}
+
+bool Scene::paintCursorFrame(AbstractOutput *output, const QRegion &damage, RenderLoop *renderLoop)
+{
+    Q_UNUSED(output)
+    Q_UNUSED(damage)
+    Q_UNUSED(renderLoop)
+    return false;
 }
 
 
@@ -339,6 +407,9 @@ void Scene::paintGenericScreen(int orig_mask, const ScreenPaintData &)
         if (!w->isPaintingEnabled()) {
             continue;
         }
+        if (w->window()->isDeleted()) {
+            static_cast<Deleted *>(w->window())->markAsPainted();
+        }
         phase2.append({w, infiniteRegion(), data.clip, data.mask,});
     }
 
@@ -429,6 +500,9 @@ void Scene::paintSimpleScreen(int orig_mask, const QRegion &region)
         if (!window->isPaintingEnabled()) {
             continue;
         }
+        if (toplevel->isDeleted()) {
+            static_cast<Deleted *>(toplevel)->markAsPainted();
+        }
         dirtyArea |= data.paint;
         // Schedule the window for painting
         phase2data.append({ window, data.paint, data.clip, data.mask, });
@@ -69,6 +69,11 @@ public:
      * Returns the repaints region for output with the specified @a output.
      */
     QRegion repaints(AbstractOutput *output) const;
+    /**
+     * Returns the region of @a output that needs to be repainted because the software
+     * cursor has moved or changed its shape. It is not part of repaints().
+     */
+    QRegion cursorRepaints(AbstractOutput *output) const;
     void resetRepaints(AbstractOutput *output);
 
     // Returns true if the ctor failed to properly initialize.
@@ -80,7 +85,14 @@ public:
     // ie. "what of this frame is lost to painting"
     virtual void paint(AbstractOutput *output, const QRegion &damage, const QList<Toplevel *> &windows,
                        RenderLoop *renderLoop) = 0;
-
+    /**
+     * Repaints only the software cursor on @a output, restoring the parts of the last frame
+     * in @a damage that the cursor has left. This requires that nothing but the cursor has
+     * changed since the last frame. Returns @c false if the cursor could not be painted on
+     * its own, the caller has to paint a full frame then.
+     */
+    bool paintCursorOnly(AbstractOutput *output, const QRegion &damage, const QList<Toplevel *> &windows,
+                         RenderLoop *renderLoop);
 
     void paintScreen(AbstractOutput *output, const QList<Toplevel *> &toplevels);
 
@@ -207,6 +219,9 @@ protected:
                      const QMatrix4x4 &projection = QMatrix4x4());
     // Render cursor texture in case hardware cursor is disabled/non-applicable
     virtual void paintCursor(AbstractOutput *output, const QRegion &region) = 0;
+    // Restore @p damage from the last frame and paint the cursor on top of it, the default
+    // implementation can't do that and returns false
+    virtual bool paintCursorFrame(AbstractOutput *output, const QRegion &damage, RenderLoop *renderLoop);
     friend class EffectsHandlerImpl;
     // called after all effects had their paintScreen() called
     void finalPaintScreen(int mask, const QRegion &region, ScreenPaintData& data);
@@ -265,6 +280,7 @@ private:
     std::chrono::milliseconds m_expectedPresentTimestamp = std::chrono::milliseconds::zero();
     QHash< Toplevel*, Window* > m_windows;
     QMap<AbstractOutput *, QRegion> m_repaints;
+    QMap<AbstractOutput *, QRegion> m_cursorRepaints;
     QRect m_geometry;
     // how many times finalPaintScreen() has been called
     int m_paintScreenCount = 0;
@@ -27,7 +27,9 @@
 #include "lanczosfilter.h"
 #include "main.h"
 #include "overlaywindow.h"
+#include "performancemonitor.h"
 #include "renderloop.h"
+#include "renderloop_p.h"
 #include "cursor.h"
 #include "decorations/decoratedclient.h"
 #include "shadowitem.h"
@@ -38,9 +40,13 @@
 #include <cmath>
 #include <cstddef>
 
+#include <QFontMetricsF>
+#include <QGlyphRun>
 #include <QGraphicsScale>
 #include <QPainter>
+#include <QRawFont>
 #include <QStringList>
+#include <QTextLayout>
 #include <QVector2D>
 #include <QVector4D>
 #include <QMatrix4x4>
@@ -69,6 +75,13 @@ SceneOpenGL::SceneOpenGL(OpenGLBackend *backend, QObject *parent)
         glGenVertexArrays(1, &vao);
         glBindVertexArray(vao);
     }
+
+    connect(kwinApp()->platform(), &Platform::outputDisabled, this, [this](AbstractOutput *output) {
+        if (m_cursorFrameCaches.contains(output)) {
+            makeOpenGLContextCurrent();
+            m_cursorFrameCaches.remove(output);
+        }
+    });
 }
 
 SceneOpenGL *SceneOpenGL::createScene(OpenGLBackend *backend, QObject *parent)
@@ -178,6 +191,93 @@ void SceneOpenGL::paintCursor(AbstractOutput *output, const QRegion &rendered)
     glDisable(GL_BLEND);
 }
 
+/**
+ * Copy the parts of the output that were @p updated in this frame, or that the cache still
+ * misses, before the cursor is drawn on top of them, so that a later cursor-only frame can
+ * restore what the cursor has left. Only the @p valid parts of the frame can be copied.
+ */
+void SceneOpenGL::updateCursorFrameCache(AbstractOutput *output, const QRegion &updated, const QRegion &valid)
+{
+    // the output may be rendered into a part of a larger framebuffer, at any scale
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const QRect geo = output->geometry();
+    const QSize size(viewport[2], viewport[3]);
+    if (geo.isEmpty() || size.isEmpty()) {
+        return;
+    }
+
+    CursorFrameCache &cache = m_cursorFrameCaches[output];
+    if (!cache.texture || cache.texture->size() != size) {
+        cache.texture.reset(new GLTexture(GL_RGBA8, size));
+        cache.missing = QRect(QPoint(0, 0), geo.size());
+    }
+
+    const qreal xScale = qreal(size.width()) / geo.width();
+    const qreal yScale = qreal(size.height()) / geo.height();
+    // the rest of the cache still holds what this frame painted there
+    const QRegion localRegion = (updated.translated(-geo.topLeft()) | cache.missing)
+        & valid.translated(-geo.topLeft()) & QRect(QPoint(0, 0), geo.size());
+    if (localRegion.isEmpty()) {
+        return;
+    }
+
+    cache.texture->bind();
+    for (const QRect &rect : localRegion) {
+        const int x1 = std::floor(rect.x() * xScale);
+        const int x2 = std::ceil((rect.x() + rect.width()) * xScale);
+        // the framebuffer is bottom-up, and so is the texture
+        const int y1 = std::floor((geo.height() - rect.y() - rect.height()) * yScale);
+        const int y2 = std::ceil((geo.height() - rect.y()) * yScale);
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x1, y1, viewport[0] + x1, viewport[1] + y1,
+                            std::min(x2, size.width()) - x1, std::min(y2, size.height()) - y1);
+    }
+    cache.texture->unbind();
+    cache.missing -= localRegion;
+}
+
+bool SceneOpenGL::paintCursorFrame(AbstractOutput *output, const QRegion &damage, RenderLoop *renderLoop)
+{
+    auto it = m_cursorFrameCaches.constFind(output);
+    if (it == m_cursorFrameCaches.constEnd() || !it->missing.isEmpty()) {
+        return false;
+    }
+    const QSharedPointer<GLTexture> texture = it->texture;
+    const QRect geo = output->geometry();
+
+    renderLoop->beginFrame();
+
+    // the back buffer may be older than the last frame
+    const QRegion restore = (damage | m_backend->beginFrame(output)) & geo;
+    GLVertexBuffer::streamingBuffer()->beginFrame();
+
+    GLVertexBuffer::setVirtualScreenGeometry(geo);
+    GLRenderTarget::setVirtualScreenGeometry(geo);
+    GLVertexBuffer::setVirtualScreenScale(output->scale());
+    GLRenderTarget::setVirtualScreenScale(output->scale());
+
+    updateProjectionMatrix(geo);
+
+    QMatrix4x4 mvp = m_projectionMatrix;
+    mvp.translate(geo.x(), geo.y());
+
+    texture->bind();
+    ShaderBinder binder(ShaderTrait::MapTexture);
+    binder.shader()->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
+    glEnable(GL_SCISSOR_TEST);
+    texture->render(restore, QRect(QPoint(0, 0), geo.size()), true);
+    glDisable(GL_SCISSOR_TEST);
+    texture->unbind();
+
+    paintCursor(output, restore);
+
+    renderLoop->endFrame();
+
+    GLVertexBuffer::streamingBuffer()->endOfFrame();
+    m_backend->endFrame(output, restore, damage);
+    return true;
+}
+
 void SceneOpenGL::aboutToStartPainting(AbstractOutput *output, const QRegion &damage)
 {
     m_backend->aboutToStartPainting(output, damage);
@@ -252,6 +352,11 @@ void SceneOpenGL::paint(AbstractOutput *output, const QRegion &damage, const QLi
         directScanout = m_backend->scanout(output, fullscreenSurface);
     }
     if (directScanout) {
+        if (FrameStatistics *statistics = RenderLoopPrivate::get(renderLoop)->statistics) {
+            statistics->directScanoutFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+        // the scanout buffer is not ours to copy from
+        m_cursorFrameCaches.remove(output);
         renderLoop->endFrame();
     } else {
         // prepare rendering makescontext current on the output
@@ -267,6 +372,12 @@ void SceneOpenGL::paint(AbstractOutput *output, const QRegion &damage, const QLi
 
         paintScreen(damage.intersected(geo), repaint, &update, &valid,
                     renderLoop, projectionMatrix());   // call generic implementation
+        if (output && output->usesSoftwareCursor()) {
+            updateCursorFrameCache(output, update, valid);
+        } else {
+            // the cache would fall behind the frames painted in the meantime
+            m_cursorFrameCaches.remove(output);
+        }
         paintCursor(output, valid);
 
         renderLoop->endFrame();
@@ -586,37 +697,47 @@ static GLTexture *bindSurfaceTexture(SurfaceItem *surfaceItem)
     return platformSurfaceTexture->texture();
 }
 
-static WindowQuadList clipQuads(const Item *item, const OpenGLWindow::RenderContext *context)
+static WindowQuadList clipQuads(const WindowQuadList &quads, const QMatrix4x4 &transform, const OpenGLWindow::RenderContext *context)
 {
-    const WindowQuadList quads = item->quads();
     if (context->clip != infiniteRegion() && !context->hardwareClipping) {
-        const QPoint offset = context->transforms.top().map(QPoint(0, 0));
+        const QPoint offset = transform.map(QPoint(0, 0));
 
         WindowQuadList ret;
         ret.reserve(quads.count());
 
-        // split all quads in bounding rect with the actual rects in the region
+        // split all quads in bounding rect with the actual rects in the region,
+        // only the clip rects that overlap the quad are visited
         for (const WindowQuad &quad : qAsConst(quads)) {
-            for (const QRect &r : qAsConst(context->clip)) {
-                const QRectF rf(r.translated(-offset));
-                const QRectF quadRect(QPointF(quad.left(), quad.top()), QPointF(quad.right(), quad.bottom()));
+            const QRectF quadRect(QPointF(quad.left(), quad.top()), QPointF(quad.right(), quad.bottom()));
+            context->clipRects.forEachIntersection(quadRect.translated(offset), [&](const QRectF &r) {
+                const QRectF rf = r.translated(-offset);
                 const QRectF &intersected = rf.intersected(quadRect);
                 if (intersected.isValid()) {
                     if (quadRect == intersected) {
                         // case 1: completely contains, include and do not check other rects
                         ret << quad;
-                        break;
+                        return false;
                     }
                     // case 2: intersection
                     ret << quad.makeSubQuad(intersected.left(), intersected.top(), intersected.right(), intersected.bottom());
                 }
-            }
+                return true;
+            });
         }
         return ret;
     }
     return quads;
 }
 
+static QRect quadsBoundingRect(const WindowQuadList &quads)
+{
+    QRectF bounds;
+    for (const WindowQuad &quad : quads) {
+        bounds |= QRectF(QPointF(quad.left(), quad.top()), QPointF(quad.right(), quad.bottom()));
+    }
+    return bounds.toAlignedRect();
+}
+
 void OpenGLWindow::createRenderNode(Item *item, RenderContext *context)
 {
     const QList<Item *> sortedChildItems = item->sortedChildItems();
@@ -636,44 +757,106 @@ void OpenGLWindow::createRenderNode(Item *item, RenderContext *context)
     }
 
     item->preprocess();
-    if (auto shadowItem = qobject_cast<ShadowItem *>(item)) {
-        WindowQuadList quads = clipQuads(item, context);
 
-        auto effWin = window()->effectWindow();
-        if (effWin) {
-            const QVariant &data_clip_path = effWin->data(KWin::DataRole::LanczosCacheRole + 102);
-            if (data_clip_path.isValid()) quads.clear();
+    CachedItem cachedItem;
+    cachedItem.item = item;
+    if (qobject_cast<ShadowItem *>(item)) {
+        cachedItem.type = CachedItem::Type::Shadow;
+    } else if (qobject_cast<DecorationItem *>(item)) {
+        cachedItem.type = CachedItem::Type::Decoration;
+    } else if (qobject_cast<SurfaceItem *>(item)) {
+        cachedItem.type = CachedItem::Type::Surface;
+    }
+    if (cachedItem.type != CachedItem::Type::Other) {
+        cachedItem.quads = item->quads();
+        cachedItem.bounds = quadsBoundingRect(cachedItem.quads);
+        cachedItem.transformMatrix = context->transforms.top();
+    }
+    m_cachedItems.append(cachedItem);
+
+    for (Item *childItem : sortedChildItems) {
+        if (childItem->z() < 0) {
+            continue;
+        }
+        if (childItem->isVisible()) {
+            createRenderNode(childItem, context);
         }
+    }
+
+    context->transforms.pop();
+}
 
-        if (!quads.isEmpty()) {
+bool OpenGLWindow::reuseCachedItems(const RenderContext *context)
+{
+    // Check the tree before touching any cached item, a removed item is destroyed by now.
+    if (!m_cacheValid || windowItem()->isSubtreeDirty()) {
+        return false;
+    }
+
+    for (const CachedItem &cachedItem : qAsConst(m_cachedItems)) {
+        cachedItem.item->preprocess();
+    }
+
+    // Preprocessing may have updated the quads of an item, e.g. when a new pixmap got created.
+    return !windowItem()->isSubtreeDirty();
+}
+
+void OpenGLWindow::emitRenderNodes(RenderContext *context) const
+{
+    for (const CachedItem &cachedItem : qAsConst(m_cachedItems)) {
+        if (cachedItem.quads.isEmpty()) {
+            continue;
+        }
+        // skip items outside of the damage before splitting any of their quads
+        if (!context->clipRects.isEmpty()) {
+            const QPoint offset = cachedItem.transformMatrix.map(QPoint(0, 0));
+            if (!context->clipRects.intersects(cachedItem.bounds.translated(offset))) {
+                continue;
+            }
+        }
+        // the cached quads are unclipped, the clip changes with the damage of every frame
+        const WindowQuadList quads = clipQuads(cachedItem.quads, cachedItem.transformMatrix, context);
+        if (quads.isEmpty()) {
+            continue;
+        }
+
+        switch (cachedItem.type) {
+        case CachedItem::Type::Shadow: {
+            auto effWin = window()->effectWindow();
+            if (effWin) {
+                const QVariant &data_clip_path = effWin->data(KWin::DataRole::LanczosCacheRole + 102);
+                if (data_clip_path.isValid()) break;
+            }
+
+            auto shadowItem = static_cast<ShadowItem *>(cachedItem.item);
             SceneOpenGLShadow *shadow = static_cast<SceneOpenGLShadow *>(shadowItem->shadow());
             context->renderNodes.append(RenderNode{
                 .texture = shadow->shadowTexture(),
                 .quads = quads,
-                .transformMatrix = context->transforms.top(),
+                .transformMatrix = cachedItem.transformMatrix,
                 .opacity = context->paintData.opacity(),
                 .hasAlpha = true,
                 .coordinateType = UnnormalizedCoordinates,
                 .typ1 = 0,
             });
+            break;
         }
-    } else if (auto decorationItem = qobject_cast<DecorationItem *>(item)) {
-        WindowQuadList quads = clipQuads(item, context);
-        if (!quads.isEmpty()) {
+        case CachedItem::Type::Decoration: {
+            auto decorationItem = static_cast<DecorationItem *>(cachedItem.item);
             auto renderer = static_cast<const SceneOpenGLDecorationRenderer *>(decorationItem->renderer());
             context->renderNodes.append(RenderNode{
                 .texture = renderer->texture(),
                 .quads = quads,
-                .transformMatrix = context->transforms.top(),
+                .transformMatrix = cachedItem.transformMatrix,
                 .opacity = context->paintData.opacity(),
                 .hasAlpha = true,
                 .coordinateType = UnnormalizedCoordinates,
                 .typ1 = 0,
             });
+            break;
         }
-    } else if (auto surfaceItem = qobject_cast<SurfaceItem *>(item)) {
-        WindowQuadList quads = clipQuads(item, context);
-        if (!quads.isEmpty()) {
+        case CachedItem::Type::Surface: {
+            auto surfaceItem = static_cast<SurfaceItem *>(cachedItem.item);
             SurfacePixmap *pixmap = surfaceItem->pixmap();
             if (pixmap) {
                 // Don't bother with blending if the entire surface is opaque
@@ -681,26 +864,19 @@ void OpenGLWindow::createRenderNode(Item *item, RenderContext *context)
                 context->renderNodes.append(RenderNode{
                     .texture = bindSurfaceTexture(surfaceItem),
                     .quads = quads,
-                    .transformMatrix = context->transforms.top(),
+                    .transformMatrix = cachedItem.transformMatrix,
                     .opacity = context->paintData.opacity(),
                     .hasAlpha = hasAlpha,
                     .coordinateType = UnnormalizedCoordinates,
                     .typ1 = 1,
                 });
             }
+            break;
         }
-    }
-
-    for (Item *childItem : sortedChildItems) {
-        if (childItem->z() < 0) {
-            continue;
-        }
-        if (childItem->isVisible()) {
-            createRenderNode(childItem, context);
+        case CachedItem::Type::Other:
+            break;
         }
     }
-
-    context->transforms.pop();
 }
 
 QMatrix4x4 OpenGLWindow::modelViewProjectionMatrix(int mask, const WindowPaintData &data) const
@@ -758,17 +934,28 @@ void OpenGLWindow::performPaint(int mask, const QRegion &region, const WindowPai
         return;
     }
 
+    const bool hardwareClipping = region != infiniteRegion() && ((mask & Scene::PAINT_WINDOW_TRANSFORMED) || (mask & Scene::PAINT_SCREEN_TRANSFORMED));
     RenderContext renderContext {
         .clip = region,
         .paintData = data,
-        .hardwareClipping = region != infiniteRegion() && ((mask & Scene::PAINT_WINDOW_TRANSFORMED) || (mask & Scene::PAINT_SCREEN_TRANSFORMED)),
+        .hardwareClipping = hardwareClipping,
+        .clipRects = (hardwareClipping || region == infiniteRegion()) ? ClipRectList() : ClipRectList(region),
     };
 
     renderContext.transforms.push(QMatrix4x4());
 
     windowItem()->setTransform(transformForPaintData(mask, data));
 
-    createRenderNode(windowItem(), &renderContext);
+    const bool reused = reuseCachedItems(&renderContext);
+    if (!reused) {
+        m_cachedItems.clear();
+        createRenderNode(windowItem(), &renderContext);
+        windowItem()->resetSubtreeDirty();
+        m_cacheValid = true;
+    }
+    PerformanceMonitor::self()->renderNodeCacheStatistics()->record(reused);
+
+    emitRenderNodes(&renderContext);
 
     int quadCount = 0;
     for (const RenderNode &node : qAsConst(renderContext.renderNodes)) {
@@ -874,6 +1061,292 @@ void OpenGLWindow::performPaint(int mask, const QRegion &region, const WindowPai
     }
 }
 
+//****************************************
+// GlyphAtlas
+//****************************************
+struct SceneOpenGL::EffectFrame::TextRun
+{
+    // two triangles for every glyph, relative to the effect frame
+    QVector<float> vertices;
+    QVector<float> texCoords;
+    // the glyphs are only valid while the atlas hasn't been started over
+    quint64 generation = 0;
+};
+
+/**
+ * Keeps the glyphs of the effect frame texts in a single texture, so that a text is drawn
+ * from it as textured quads in one draw call instead of getting a texture of its own. The
+ * glyphs are stored in white and tinted when they are drawn, so a glyph is shared between
+ * all colors of a font. The laid out texts are cached too, effects tend to show the same
+ * captions in every frame. Once the texture is full it is started over; the runs laid out
+ * before are detected by their generation and laid out again.
+ */
+class GlyphAtlas
+{
+public:
+    using TextRun = SceneOpenGL::EffectFrame::TextRun;
+
+    ~GlyphAtlas();
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    static GlyphAtlas &instance();
+
+    QSharedPointer<TextRun> layout(const QFont &font, const QString &text, const QRect &rect, Qt::Alignment alignment);
+    bool isValid(const TextRun &run) const;
+    void render(const TextRun &run, const QRegion &region);
+    void clear();
+
+private:
+    GlyphAtlas() = default;
+    struct Glyph {
+        QRect rect; // in the texture
+        QPoint offset; // from the pen position
+    };
+    struct Shelf {
+        int y;
+        int height;
+        int used;
+    };
+    QSharedPointer<TextRun> createRun(const QFont &font, const QString &text, const QRect &rect, Qt::Alignment alignment);
+    const Glyph *glyph(const QRawFont &font, quint32 index);
+    bool allocate(const QSize &size, QRect *rect);
+    void restart();
+
+    QScopedPointer<GLTexture> m_texture;
+    QVector<Shelf> m_shelves;
+    int m_bottom = 0;
+    quint64 m_generation = 0;
+    QHash<QString, QHash<quint32, Glyph>> m_glyphs;
+    QHash<QString, QSharedPointer<TextRun>> m_runs;
+};
+
+// 1 MiB of glyphs, plenty for the few fonts the effects use
+static const int s_glyphAtlasSize = 512;
+// the laid out texts kept around, dropped all at once when there are more
+static const int s_maxTextRuns = 1024;
+
+GlyphAtlas &GlyphAtlas::instance()
+{
+    static GlyphAtlas s_instance;
+    return s_instance;
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    Q_ASSERT(m_texture.isNull());
+}
+
+bool GlyphAtlas::isValid(const TextRun &run) const
+{
+    return !m_texture.isNull() && run.generation == m_generation;
+}
+
+bool GlyphAtlas::allocate(const QSize &size, QRect *rect)
+{
+    Shelf *best = nullptr;
+    for (Shelf &shelf : m_shelves) {
+        if (shelf.height < size.height() || shelf.height > size.height() + size.height() / 4 + 2) {
+            continue;
+        }
+        if (s_glyphAtlasSize - shelf.used < size.width()) {
+            continue;
+        }
+        if (!best || shelf.height < best->height) {
+            best = &shelf;
+        }
+    }
+    if (!best) {
+        if (m_bottom + size.height() > s_glyphAtlasSize || size.width() > s_glyphAtlasSize) {
+            return false;
+        }
+        m_shelves.append(Shelf{m_bottom, size.height(), 0});
+        m_bottom += size.height();
+        best = &m_shelves.last();
+    }
+    *rect = QRect(QPoint(best->used, best->y), size);
+    best->used += size.width();
+    return true;
+}
+
+void GlyphAtlas::restart()
+{
+    m_shelves.clear();
+    m_bottom = 0;
+    m_glyphs.clear();
+    m_runs.clear();
+    m_generation++;
+}
+
+const GlyphAtlas::Glyph *GlyphAtlas::glyph(const QRawFont &font, quint32 index)
+{
+    const QString fontKey = font.familyName() + QLatin1Char('/') + font.styleName() + QLatin1Char('/') + QString::number(font.pixelSize());
+    QHash<quint32, Glyph> &glyphs = m_glyphs[fontKey];
+    auto it = glyphs.constFind(index);
+    if (it != glyphs.constEnd()) {
+        return &it.value();
+    }
+
+    // one pixel of transparent border keeps the neighbors out when the texture is filtered
+    const QRect bounds = font.boundingRect(index).toAlignedRect().adjusted(-1, -1, 1, 1);
+    Glyph glyph{QRect(), bounds.topLeft()};
+    if (bounds.width() > 2 && bounds.height() > 2) {
+        if (!allocate(bounds.size(), &glyph.rect)) {
+            restart();
+            if (!allocate(bounds.size(), &glyph.rect)) {
+                return nullptr;
+            }
+        }
+        QImage image(bounds.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QGlyphRun run;
+        run.setRawFont(font);
+        run.setGlyphIndexes({index});
+        run.setPositions({QPointF(-bounds.x(), -bounds.y())});
+        QPainter p(&image);
+        p.setPen(Qt::white);
+        p.drawGlyphRun(QPointF(0, 0), run);
+        p.end();
+        m_texture->update(image, glyph.rect.topLeft());
+    }
+    // starting over above has dropped the hash of the font
+    return &m_glyphs[fontKey].insert(index, glyph).value();
+}
+
+QSharedPointer<GlyphAtlas::TextRun> GlyphAtlas::createRun(const QFont &font, const QString &text, const QRect &rect, Qt::Alignment alignment)
+{
+    // lay the text out the way QPainter::drawText() does: lines are broken at '\n', words
+    // are only wrapped when asked to and the lines below the rect are left out
+    QString lines = text;
+    lines.replace(QLatin1Char('\n'), QChar::LineSeparator);
+    QTextOption option;
+    option.setWrapMode((int(alignment) & Qt::TextWordWrap) ? QTextOption::WordWrap : QTextOption::ManualWrap);
+    QTextLayout layout(lines, font);
+    layout.setTextOption(option);
+    const qreal leading = QFontMetricsF(font).leading();
+    qreal height = -leading;
+    layout.beginLayout();
+    for (QTextLine line = layout.createLine(); line.isValid(); line = layout.createLine()) {
+        line.setLineWidth(rect.width());
+        height += leading;
+        line.setPosition(QPointF(0, height));
+        height += line.height();
+        if (height >= rect.height()) {
+            break;
+        }
+    }
+    layout.endLayout();
+    if (layout.lineCount() == 0) {
+        return {};
+    }
+
+    qreal top = rect.y();
+    if (alignment & Qt::AlignBottom) {
+        top += rect.height() - height;
+    } else if (alignment & Qt::AlignVCenter) {
+        top += (rect.height() - height) / 2;
+    }
+
+    auto run = QSharedPointer<TextRun>::create();
+    run->generation = m_generation;
+    for (int i = 0; i < layout.lineCount(); ++i) {
+        const QTextLine line = layout.lineAt(i);
+        QPointF origin(rect.x(), top);
+        if (alignment & Qt::AlignRight) {
+            origin.rx() += rect.width() - line.naturalTextWidth();
+        } else if (alignment & Qt::AlignHCenter) {
+            origin.rx() += (rect.width() - line.naturalTextWidth()) / 2;
+        }
+
+        const auto glyphRuns = line.glyphRuns();
+        for (const QGlyphRun &glyphRun : glyphRuns) {
+            const QRawFont rawFont = glyphRun.rawFont();
+            const QVector<quint32> indexes = glyphRun.glyphIndexes();
+            const QVector<QPointF> positions = glyphRun.positions();
+            for (int j = 0; j < indexes.count(); ++j) {
+                const Glyph *glyph = this->glyph(rawFont, indexes[j]);
+                if (!glyph || glyph->rect.isEmpty()) {
+                    continue;
+                }
+                // the glyphs are mapped 1:1, clipping them to the rect crops the source alike
+                const QRect target((origin + positions[j]).toPoint() + glyph->offset, glyph->rect.size());
+                const QRect visible = target & rect;
+                if (visible.isEmpty()) {
+                    continue;
+                }
+                const QRect texels = QRect(glyph->rect.topLeft() + visible.topLeft() - target.topLeft(), visible.size());
+                const QRectF source(QPointF(texels.x() / float(s_glyphAtlasSize), texels.y() / float(s_glyphAtlasSize)),
+                                    QSizeF(texels.width() / float(s_glyphAtlasSize), texels.height() / float(s_glyphAtlasSize)));
+                const QRectF quad(visible);
+                run->vertices << quad.left() << quad.top()
+                              << quad.left() << quad.bottom()
+                              << quad.right() << quad.top()
+                              << quad.left() << quad.bottom()
+                              << quad.right() << quad.bottom()
+                              << quad.right() << quad.top();
+                run->texCoords << source.left() << source.top()
+                               << source.left() << source.bottom()
+                               << source.right() << source.top()
+                               << source.left() << source.bottom()
+                               << source.right() << source.bottom()
+                               << source.right() << source.top();
+            }
+        }
+    }
+    return run;
+}
+
+QSharedPointer<GlyphAtlas::TextRun> GlyphAtlas::layout(const QFont &font, const QString &text, const QRect &rect, Qt::Alignment alignment)
+{
+    if (m_texture.isNull()) {
+        m_texture.reset(new GLTexture(GL_RGBA8, s_glyphAtlasSize, s_glyphAtlasSize));
+        m_texture->setYInverted(true);
+        m_texture->setFilter(GL_LINEAR);
+        m_texture->setWrapMode(GL_CLAMP_TO_EDGE);
+        m_texture->clear();
+    }
+
+    const QString key = font.key() + QLatin1Char('\n')
+        + QString::number(rect.x()) + QLatin1Char(',') + QString::number(rect.y()) + QLatin1Char(',')
+        + QString::number(rect.width()) + QLatin1Char(',') + QString::number(rect.height()) + QLatin1Char(',')
+        + QString::number(int(alignment)) + QLatin1Char('\n') + text;
+    QSharedPointer<TextRun> run = m_runs.value(key);
+    if (run) {
+        return run;
+    }
+
+    run = createRun(font, text, rect, alignment);
+    if (run && run->generation != m_generation) {
+        // the atlas was full, the glyphs placed before that are gone
+        run = createRun(font, text, rect, alignment);
+    }
+    if (!run) {
+        return run;
+    }
+    if (m_runs.count() >= s_maxTextRuns) {
+        m_runs.clear();
+    }
+    m_runs.insert(key, run);
+    return run;
+}
+
+void GlyphAtlas::render(const TextRun &run, const QRegion &region)
+{
+    if (run.vertices.isEmpty()) {
+        return;
+    }
+    GLVertexBuffer *vbo = GLVertexBuffer::streamingBuffer();
+    vbo->reset();
+    vbo->setData(run.vertices.count() / 2, 2, run.vertices.constData(), run.texCoords.constData());
+    m_texture->bind();
+    vbo->render(region, GL_TRIANGLES);
+    m_texture->unbind();
+}
+
+void GlyphAtlas::clear()
+{
+    restart();
+    m_texture.reset();
+}
+
 //****************************************
 // SceneOpenGL::EffectFrame
 //****************************************
@@ -884,9 +1357,6 @@ QPixmap* SceneOpenGL::EffectFrame::m_unstyledPixmap = nullptr;
 SceneOpenGL::EffectFrame::EffectFrame(EffectFrameImpl* frame, SceneOpenGL *scene)
     : Scene::EffectFrame(frame)
     , m_texture(nullptr)
-    , m_textTexture(nullptr)
-    , m_oldTextTexture(nullptr)
-    , m_textPixmap(nullptr)
     , m_iconTexture(nullptr)
     , m_oldIconTexture(nullptr)
     , m_selectionTexture(nullptr)
@@ -898,9 +1368,6 @@ SceneOpenGL::EffectFrame::EffectFrame(EffectFrameImpl* frame, SceneOpenGL *scene
 SceneOpenGL::EffectFrame::~EffectFrame()
 {
     delete m_texture;
-    delete m_textTexture;
-    delete m_textPixmap;
-    delete m_oldTextTexture;
     delete m_iconTexture;
     delete m_oldIconTexture;
     delete m_selectionTexture;
@@ -912,10 +1379,7 @@ void SceneOpenGL::EffectFrame::free()
     glFlush();
     delete m_texture;
     m_texture = nullptr;
-    delete m_textTexture;
-    m_textTexture = nullptr;
-    delete m_textPixmap;
-    m_textPixmap = nullptr;
+    m_textRun.reset();
     delete m_iconTexture;
     m_iconTexture = nullptr;
     delete m_selectionTexture;
@@ -924,8 +1388,7 @@ void SceneOpenGL::EffectFrame::free()
     m_unstyledVBO = nullptr;
     delete m_oldIconTexture;
     m_oldIconTexture = nullptr;
-    delete m_oldTextTexture;
-    m_oldTextTexture = nullptr;
+    m_oldTextRun.reset();
 }
 
 void SceneOpenGL::EffectFrame::freeIconFrame()
@@ -936,10 +1399,7 @@ void SceneOpenGL::EffectFrame::freeIconFrame()
 
 void SceneOpenGL::EffectFrame::freeTextFrame()
 {
-    delete m_textTexture;
-    m_textTexture = nullptr;
-    delete m_textPixmap;
-    m_textPixmap = nullptr;
+    m_textRun.reset();
 }
 
 void SceneOpenGL::EffectFrame::freeSelection()
@@ -957,9 +1417,8 @@ void SceneOpenGL::EffectFrame::crossFadeIcon()
 
 void SceneOpenGL::EffectFrame::crossFadeText()
 {
-    delete m_oldTextTexture;
-    m_oldTextTexture = m_textTexture;
-    m_textTexture = nullptr;
+    m_oldTextRun = m_textRun;
+    m_textRun.reset();
 }
 
 void SceneOpenGL::EffectFrame::render(const QRegion &_region, double opacity, double frameOpacity)
@@ -1198,32 +1657,35 @@ void SceneOpenGL::EffectFrame::render(const QRegion &_region, double opacity, do
         QMatrix4x4 mvp(projection);
         mvp.translate(m_effectFrame->geometry().x(), m_effectFrame->geometry().y());
         shader->setUniform(GLShader::ModelViewProjectionMatrix, mvp);
-        if (m_effectFrame->isCrossFade() && m_oldTextTexture) {
+
+        // the glyphs are white, they get their color from the modulation
+        QColor color = Qt::white;
+        if (m_effectFrame->style() == EffectFrameStyled)
+            color = m_effectFrame->styledTextColor();  // TODO: What about no frame? Custom color setting required
+        auto modulation = [&color](float opacity) {
+            const float a = opacity * color.alphaF();
+            return QVector4D(color.redF() * a, color.greenF() * a, color.blueF() * a, a);
+        };
+
+        GlyphAtlas &atlas = GlyphAtlas::instance();
+        if (m_effectFrame->isCrossFade() && m_oldTextRun && atlas.isValid(*m_oldTextRun)) {
             if (shader) {
-                const float a = opacity * (1.0 - m_effectFrame->crossFadeProgress());
-                shader->setUniform(GLShader::ModulationConstant, QVector4D(a, a, a, a));
+                shader->setUniform(GLShader::ModulationConstant, modulation(opacity * (1.0 - m_effectFrame->crossFadeProgress())));
             }
-
-            m_oldTextTexture->bind();
-            m_oldTextTexture->render(region, m_effectFrame->geometry());
-            m_oldTextTexture->unbind();
+            atlas.render(*m_oldTextRun, region);
             if (shader) {
-                const float a = opacity * m_effectFrame->crossFadeProgress();
-                shader->setUniform(GLShader::ModulationConstant, QVector4D(a, a, a, a));
+                shader->setUniform(GLShader::ModulationConstant, modulation(opacity * m_effectFrame->crossFadeProgress()));
             }
         } else {
             if (shader) {
-                const QVector4D constant(opacity, opacity, opacity, opacity);
-                shader->setUniform(GLShader::ModulationConstant, constant);
+                shader->setUniform(GLShader::ModulationConstant, modulation(opacity));
             }
         }
-        if (!m_textTexture)   // Lazy creation
-            updateTextTexture();
+        if (!m_textRun || !atlas.isValid(*m_textRun))   // Lazy creation
+            updateTextRun();
 
-        if (m_textTexture) {
-            m_textTexture->bind();
-            m_textTexture->render(region, m_effectFrame->geometry());
-            m_textTexture->unbind();
+        if (m_textRun) {
+            atlas.render(*m_textRun, region);
         }
     }
 
@@ -1243,12 +1705,9 @@ void SceneOpenGL::EffectFrame::updateTexture()
     }
 }
 
-void SceneOpenGL::EffectFrame::updateTextTexture()
+void SceneOpenGL::EffectFrame::updateTextRun()
 {
-    delete m_textTexture;
-    m_textTexture = nullptr;
-    delete m_textPixmap;
-    m_textPixmap = nullptr;
+    m_textRun.reset();
 
     if (m_effectFrame->text().isEmpty())
         return;
@@ -1265,17 +1724,7 @@ void SceneOpenGL::EffectFrame::updateTextTexture()
         text = metrics.elidedText(text, Qt::ElideRight, rect.width());
     }
 
-    m_textPixmap = new QPixmap(m_effectFrame->geometry().size());
-    m_textPixmap->fill(Qt::transparent);
-    QPainter p(m_textPixmap);
-    p.setFont(m_effectFrame->font());
-    if (m_effectFrame->style() == EffectFrameStyled)
-        p.setPen(m_effectFrame->styledTextColor());
-    else // TODO: What about no frame? Custom color setting required
-        p.setPen(Qt::white);
-    p.drawText(rect, m_effectFrame->alignment(), text);
-    p.end();
-    m_textTexture = new GLTexture(*m_textPixmap);
+    m_textRun = GlyphAtlas::instance().layout(m_effectFrame->font(), text, rect, m_effectFrame->alignment());
 }
 
 void SceneOpenGL::EffectFrame::updateUnstyledTexture()
@@ -1386,6 +1835,316 @@ QSharedPointer<GLTexture> DecorationShadowTextureCache::getTexture(SceneOpenGLSh
     return d.texture;
 }
 
+//****************************************
+// DecorationTextureAtlas
+//****************************************
+/**
+ * Packs the decoration textures of all windows into a few pages, so a decoration doesn't
+ * need a texture of its own. Each page is cut into shelves and a decoration is placed on
+ * the shelf whose height fits it best. A page starts just large enough for the decoration
+ * that opened it and doubles in size when it runs full, up to maximumPageSize(). Space a
+ * decoration leaves on a shelf is reused by later decorations. Empty pages are deleted
+ * right away; a page that has become mostly empty is evacuated, i.e. its decorations are
+ * rendered into the other pages again.
+ */
+class DecorationTextureAtlas
+{
+public:
+    ~DecorationTextureAtlas();
+    DecorationTextureAtlas(const DecorationTextureAtlas&) = delete;
+    static DecorationTextureAtlas &instance();
+
+    static QSize maximumPageSize();
+
+    GLTexture *allocate(SceneOpenGLDecorationRenderer *renderer, const QSize &size, QRect *rect);
+    void release(SceneOpenGLDecorationRenderer *renderer);
+    void clear();
+
+private:
+    DecorationTextureAtlas() = default;
+    struct Shelf {
+        int y;
+        int height;
+        // the free space at the end of the shelf starts here
+        int used;
+        int allocations;
+        // free spans in front of used, as x and width
+        QVector<QPair<int, int>> holes;
+    };
+    struct Page {
+        QScopedPointer<GLTexture> texture;
+        QSize size;
+        QVector<Shelf> shelves;
+        QHash<SceneOpenGLDecorationRenderer*, QRect> allocations;
+        int bottom = 0;
+        qint64 usedArea = 0;
+        qint64 area() const {
+            return qint64(size.width()) * size.height();
+        }
+    };
+    static bool allocateInPage(Page *page, const QSize &size, QRect *rect);
+    static bool growPage(Page *page, const QSize &size);
+    void evict(Page *page);
+    void compact();
+
+    QVector<Page*> m_pages;
+    QHash<SceneOpenGLDecorationRenderer*, Page*> m_owners;
+};
+
+DecorationTextureAtlas &DecorationTextureAtlas::instance()
+{
+    static DecorationTextureAtlas s_instance;
+    return s_instance;
+}
+
+DecorationTextureAtlas::~DecorationTextureAtlas()
+{
+    Q_ASSERT(m_pages.isEmpty());
+}
+
+QSize DecorationTextureAtlas::maximumPageSize()
+{
+    // 8 MiB, wide enough for the title bar of a maximized window on most outputs
+    return QSize(2048, 1024);
+}
+
+static QSize pageSizeFor(const QSize &minimum, const QSize &size)
+{
+    QSize pageSize = minimum;
+    while (pageSize.width() < size.width()) {
+        pageSize.rwidth() *= 2;
+    }
+    while (pageSize.height() < size.height()) {
+        pageSize.rheight() *= 2;
+    }
+    return pageSize.boundedTo(DecorationTextureAtlas::maximumPageSize());
+}
+
+bool DecorationTextureAtlas::allocateInPage(Page *page, const QSize &size, QRect *rect)
+{
+    Shelf *best = nullptr;
+    int bestHole = -1;
+    for (Shelf &shelf : page->shelves) {
+        // don't let short decorations waste the space of tall shelves
+        if (shelf.height < size.height() || shelf.height > size.height() + size.height() / 2 + 8) {
+            continue;
+        }
+        int hole = -1;
+        for (int i = 0; i < shelf.holes.count(); ++i) {
+            const int width = shelf.holes[i].second;
+            if (width >= size.width() && (hole == -1 || width < shelf.holes[hole].second)) {
+                hole = i;
+            }
+        }
+        if (hole == -1 && page->size.width() - shelf.used < size.width()) {
+            continue;
+        }
+        if (!best || shelf.height < best->height) {
+            best = &shelf;
+            bestHole = hole;
+        }
+    }
+    if (!best) {
+        if (page->bottom + size.height() > page->size.height()) {
+            return false;
+        }
+        page->shelves.append(Shelf{page->bottom, size.height(), 0, 0, {}});
+        page->bottom += size.height();
+        best = &page->shelves.last();
+    }
+
+    if (bestHole != -1) {
+        QPair<int, int> &hole = best->holes[bestHole];
+        *rect = QRect(QPoint(hole.first, best->y), size);
+        hole.first += size.width();
+        hole.second -= size.width();
+        if (hole.second == 0) {
+            best->holes.remove(bestHole);
+        }
+    } else {
+        *rect = QRect(QPoint(best->used, best->y), size);
+        best->used += size.width();
+    }
+    best->allocations++;
+    page->usedArea += qint64(size.width()) * size.height();
+    return true;
+}
+
+bool DecorationTextureAtlas::growPage(Page *page, const QSize &size)
+{
+    if (!GLRenderTarget::supported()) {
+        return false;
+    }
+    // the shelves stay where they are, so a new shelf has to fit below them
+    const QSize grown = pageSizeFor(page->size, QSize(size.width(), page->bottom + size.height()));
+    if (grown == page->size || grown.width() < size.width() || grown.height() < page->bottom + size.height()) {
+        return false;
+    }
+
+    QScopedPointer<GLTexture> texture(new GLTexture(GL_RGBA8, grown));
+    texture->setYInverted(true);
+    texture->setWrapMode(GL_CLAMP_TO_EDGE);
+    texture->clear();
+
+    {
+        GLRenderTarget target(*page->texture);
+        if (!target.valid()) {
+            return false;
+        }
+        GLRenderTarget::pushRenderTarget(&target);
+        texture->bind();
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, page->size.width(), page->size.height());
+        texture->unbind();
+        GLRenderTarget::popRenderTarget();
+    }
+
+    page->texture.swap(texture);
+    page->size = grown;
+    // the decorations in the page draw from the new texture
+    for (auto it = page->allocations.constBegin(); it != page->allocations.constEnd(); ++it) {
+        it.key()->m_atlasTexture = page->texture.data();
+    }
+    return true;
+}
+
+GLTexture *DecorationTextureAtlas::allocate(SceneOpenGLDecorationRenderer *renderer, const QSize &size, QRect *rect)
+{
+    Q_ASSERT(!m_owners.contains(renderer));
+    const QSize maximumPageSize = DecorationTextureAtlas::maximumPageSize();
+    if (size.isEmpty() || size.width() > maximumPageSize.width() || size.height() > maximumPageSize.height()) {
+        return nullptr;
+    }
+
+    Page *target = nullptr;
+    for (Page *page : qAsConst(m_pages)) {
+        if (allocateInPage(page, size, rect)) {
+            target = page;
+            break;
+        }
+    }
+    if (!target) {
+        for (Page *page : qAsConst(m_pages)) {
+            if (growPage(page, size) && allocateInPage(page, size, rect)) {
+                target = page;
+                break;
+            }
+        }
+    }
+    if (!target) {
+        target = new Page;
+        target->size = pageSizeFor(QSize(512, 128), size);
+        target->texture.reset(new GLTexture(GL_RGBA8, target->size));
+        target->texture->setYInverted(true);
+        target->texture->setWrapMode(GL_CLAMP_TO_EDGE);
+        target->texture->clear();
+        m_pages.append(target);
+        allocateInPage(target, size, rect);
+    }
+
+    target->allocations.insert(renderer, *rect);
+    m_owners.insert(renderer, target);
+    return target->texture.data();
+}
+
+void DecorationTextureAtlas::release(SceneOpenGLDecorationRenderer *renderer)
+{
+    Page *page = m_owners.take(renderer);
+    if (!page) {
+        return;
+    }
+    const QRect rect = page->allocations.take(renderer);
+    page->usedArea -= qint64(rect.width()) * rect.height();
+
+    for (Shelf &shelf : page->shelves) {
+        if (shelf.y != rect.y()) {
+            continue;
+        }
+        if (--shelf.allocations == 0) {
+            shelf.used = 0;
+            shelf.holes.clear();
+            break;
+        }
+        // merge the span with the free space around it
+        int x = rect.x();
+        int width = rect.width();
+        for (int i = shelf.holes.count() - 1; i >= 0; --i) {
+            const QPair<int, int> hole = shelf.holes[i];
+            if (hole.first + hole.second == x) {
+                x = hole.first;
+                width += hole.second;
+                shelf.holes.remove(i);
+            } else if (x + width == hole.first) {
+                width += hole.second;
+                shelf.holes.remove(i);
+            }
+        }
+        if (x + width == shelf.used) {
+            shelf.used = x;
+        } else {
+            shelf.holes.append(qMakePair(x, width));
+        }
+        break;
+    }
+    while (!page->shelves.isEmpty() && page->shelves.constLast().allocations == 0) {
+        page->bottom = page->shelves.constLast().y;
+        page->shelves.removeLast();
+    }
+
+    if (page->allocations.isEmpty()) {
+        m_pages.removeOne(page);
+        delete page;
+    } else {
+        compact();
+    }
+}
+
+void DecorationTextureAtlas::evict(Page *page)
+{
+    m_pages.removeOne(page);
+    const auto allocations = page->allocations;
+    for (auto it = allocations.constBegin(); it != allocations.constEnd(); ++it) {
+        m_owners.remove(it.key());
+        it.key()->evictFromAtlas();
+    }
+    delete page;
+}
+
+void DecorationTextureAtlas::compact()
+{
+    if (m_pages.count() < 2) {
+        return;
+    }
+
+    Page *emptiest = nullptr;
+    qint64 usedArea = 0;
+    qint64 area = 0;
+    for (Page *page : qAsConst(m_pages)) {
+        usedArea += page->usedArea;
+        area += page->area();
+        if (!emptiest || page->usedArea * emptiest->area() < emptiest->usedArea * page->area()) {
+            emptiest = page;
+        }
+    }
+    // only worth it if the other pages can most likely take the decorations
+    if (emptiest->usedArea > emptiest->area() / 4 || usedArea > (area - emptiest->area()) / 2) {
+        return;
+    }
+    // decorations of closed windows can't be rendered again
+    for (auto it = emptiest->allocations.constBegin(); it != emptiest->allocations.constEnd(); ++it) {
+        if (!it.key()->client()) {
+            return;
+        }
+    }
+    evict(emptiest);
+}
+
+void DecorationTextureAtlas::clear()
+{
+    while (!m_pages.isEmpty()) {
+        evict(m_pages.constFirst());
+    }
+}
+
 SceneOpenGL::~SceneOpenGL()
 {
     if (init_ok) {
@@ -1395,9 +2154,12 @@ SceneOpenGL::~SceneOpenGL()
         delete m_lanczosFilter;
         m_lanczosFilter = nullptr;
     }
+    m_cursorFrameCaches.clear();
     SceneOpenGL::EffectFrame::cleanup();
+    GlyphAtlas::instance().clear();
     // SceneOpenGL2 被销毁时（可能发生在切换为2D模式）应该清理窗口阴影的材质缓存，否则在多次切换3D/2D后会导致窗口阴影绘制出现异常
     DecorationShadowTextureCache::instance().clear();
+    DecorationTextureAtlas::instance().clear();
 }
 
 SceneOpenGLShadow::SceneOpenGLShadow(Toplevel *toplevel)
@@ -1513,6 +2275,20 @@ SceneOpenGLDecorationRenderer::~SceneOpenGLDecorationRenderer()
     if (Scene *scene = Compositor::self()->scene()) {
         scene->makeOpenGLContextCurrent();
     }
+    DecorationTextureAtlas::instance().release(this);
+}
+
+QPoint SceneOpenGLDecorationRenderer::textureOrigin() const
+{
+    return m_atlasRect.topLeft();
+}
+
+void SceneOpenGLDecorationRenderer::evictFromAtlas()
+{
+    m_atlasTexture = nullptr;
+    m_atlasRect = QRect();
+    Q_EMIT textureOriginChanged();
+    invalidate();
 }
 
 static void clamp_row(int left, int width, int right, const uint32_t *src, uint32_t *dest)
@@ -1528,16 +2304,13 @@ static void clamp_sides(int left, int width, int right, const uint32_t *src, uin
     std::fill_n(dest + left + width, right, *(src + width - 1));
 }
 
-static void clamp(QImage &image, const QRect &viewport)
+static void clamp(QImage &image, const QRect &rect, const QRect &viewport)
 {
     Q_ASSERT(image.depth() == 32);
     if (viewport.isEmpty()) {
-        image = {};
         return;
     }
 
-    const QRect rect = image.rect();
-
     const int left = viewport.left() - rect.left();
     const int top = viewport.top() - rect.top();
     const int right = rect.right() - viewport.right();
@@ -1567,12 +2340,14 @@ static void clamp(QImage &image, const QRect &viewport)
 
 void SceneOpenGLDecorationRenderer::render(const QRegion &region)
 {
-    if (areImageSizesDirty()) {
-        resizeTexture();
+    bool reallocated = false;
+    const bool resized = areImageSizesDirty();
+    if (resized) {
+        reallocated = resizeTexture();
         resetImageSizesDirty();
     }
 
-    if (!m_texture) {
+    if (!texture()) {
         // for invalid sizes we get no texture, see BUG 361551
         return;
     }
@@ -1585,17 +2360,23 @@ void SceneOpenGLDecorationRenderer::render(const QRegion &region)
     const int bottomHeight = std::ceil(bottom.height() * devicePixelRatio);
     const int leftWidth = std::ceil(left.width() * devicePixelRatio);
 
-    const QPoint topPosition(0, 0);
-    const QPoint bottomPosition(0, topPosition.y() + topHeight + (2 * TexturePad));
-    const QPoint leftPosition(0, bottomPosition.y() + bottomHeight + (2 * TexturePad));
-    const QPoint rightPosition(0, leftPosition.y() + leftWidth + (2 * TexturePad));
+    const QPoint topPosition = textureOrigin();
+    const QPoint bottomPosition(topPosition.x(), topPosition.y() + topHeight + (2 * TexturePad));
+    const QPoint leftPosition(topPosition.x(), bottomPosition.y() + bottomHeight + (2 * TexturePad));
+    const QPoint rightPosition(topPosition.x(), leftPosition.y() + leftWidth + (2 * TexturePad));
 
-    const QRect dirtyRect = region.boundingRect();
+    // a new place in the atlas holds whatever was there before
+    const QRect dirtyRect = reallocated ? (left | top | right | bottom) : region.boundingRect();
 
     renderPart(top.intersected(dirtyRect), top, topPosition, devicePixelRatio);
     renderPart(bottom.intersected(dirtyRect), bottom, bottomPosition, devicePixelRatio);
     renderPart(left.intersected(dirtyRect), left, leftPosition, devicePixelRatio, true);
     renderPart(right.intersected(dirtyRect), right, rightPosition, devicePixelRatio, true);
+
+    // only worth keeping while the decoration is being resized and repainted on every configure
+    if (!resized) {
+        m_scratchImage = QImage();
+    }
 }
 
 void SceneOpenGLDecorationRenderer::renderPart(const QRect &rect, const QRect &partRect,
@@ -1620,9 +2401,20 @@ void SceneOpenGLDecorationRenderer::renderPart(const QRect &rect, const QRect &p
     QSize paddedImageSize = imageSize;
     paddedImageSize.rheight() += verticalPadding;
     paddedImageSize.rwidth() += horizontalPadding;
-    QImage image(paddedImageSize, QImage::Format_ARGB32_Premultiplied);
+
+    // The parts are painted one after the other into a scratch image that only grows,
+    // and only the used sub-rect of it is uploaded.
+    if (m_scratchImage.width() < paddedImageSize.width() || m_scratchImage.height() < paddedImageSize.height()) {
+        m_scratchImage = QImage(paddedImageSize.expandedTo(m_scratchImage.size()), QImage::Format_ARGB32_Premultiplied);
+    }
+    QImage &image = m_scratchImage;
     image.setDevicePixelRatio(devicePixelRatio);
-    image.fill(Qt::transparent);
+
+    const QRect imageRect(QPoint(0, 0), paddedImageSize);
+    for (int i = 0; i < imageRect.height(); ++i) {
+        uint32_t *dest = reinterpret_cast<uint32_t *>(image.scanLine(i));
+        std::fill_n(dest, imageRect.width(), 0);
+    }
 
     QRect padClip = QRect(padding.left(), padding.top(), imageSize.width(), imageSize.height());
     QPainter painter(&image);
@@ -1641,7 +2433,10 @@ void SceneOpenGLDecorationRenderer::renderPart(const QRect &rect, const QRect &p
     painter.end();
 
     // fill padding pixels by copying from the neighbour row
-    clamp(image, padClip);
+    if (padClip.isEmpty()) {
+        return;
+    }
+    clamp(image, imageRect, padClip);
 
     QPoint dirtyOffset = (rect.topLeft() - partRect.topLeft()) * devicePixelRatio;
     if (padding.top() == 0) {
@@ -1650,7 +2445,7 @@ void SceneOpenGLDecorationRenderer::renderPart(const QRect &rect, const QRect &p
     if (padding.left() == 0) {
         dirtyOffset.rx() += TexturePad;
     }
-    m_texture->update(image, textureOffset + dirtyOffset);
+    texture()->update(image, textureOffset + dirtyOffset, imageRect);
 }
 
 const QMargins SceneOpenGLDecorationRenderer::texturePadForPart(
@@ -1677,7 +2472,15 @@ static int align(int value, int align)
     return (value + align - 1) & ~(align - 1);
 }
 
-void SceneOpenGLDecorationRenderer::resizeTexture()
+void SceneOpenGLDecorationRenderer::releaseTexture()
+{
+    DecorationTextureAtlas::instance().release(this);
+    m_atlasTexture = nullptr;
+    m_atlasRect = QRect();
+    m_texture.reset();
+}
+
+bool SceneOpenGLDecorationRenderer::resizeTexture()
 {
     QRect left, top, right, bottom;
     client()->client()->layoutDecorationRects(left, top, right, bottom);
@@ -1691,19 +2494,48 @@ void SceneOpenGLDecorationRenderer::resizeTexture()
 
     size.rheight() += 4 * (2 * TexturePad);
     size.rwidth() += 2 * TexturePad;
-    size.rwidth() = align(size.width(), 128);
 
-    if (m_texture && m_texture->size() == size)
-        return;
+    const QPoint oldOrigin = textureOrigin();
+    if (size.isEmpty()) {
+        releaseTexture();
+        if (oldOrigin != textureOrigin()) {
+            Q_EMIT textureOriginChanged();
+        }
+        return false;
+    }
 
-    if (!size.isEmpty()) {
-        m_texture.reset(new GLTexture(GL_RGBA8, size.width(), size.height()));
+    // The quads address the texture in unnormalized coordinates, so a larger texture
+    // can be kept. This avoids reallocating it on every step of an interactive resize,
+    // as long as not more than half of it would be wasted.
+    QSize current;
+    if (m_atlasTexture) {
+        current = m_atlasRect.size();
+    } else if (m_texture) {
+        current = m_texture->size();
+    }
+    if (current.isValid()) {
+        if (current.width() >= size.width() && current.height() >= size.height()
+                && current.width() * current.height() <= 2 * size.width() * size.height()) {
+            return false;
+        }
+        if (current.width() < size.width()) {
+            // leave some headroom when the decoration is growing
+            size.rwidth() += size.width() / 4;
+        }
+    }
+
+    releaseTexture();
+    m_atlasTexture = DecorationTextureAtlas::instance().allocate(this, QSize(align(size.width(), 16), size.height()), &m_atlasRect);
+    if (!m_atlasTexture) {
+        m_texture.reset(new GLTexture(GL_RGBA8, align(size.width(), 128), size.height()));
         m_texture->setYInverted(true);
         m_texture->setWrapMode(GL_CLAMP_TO_EDGE);
         m_texture->clear();
-    } else {
-        m_texture.reset();
     }
+    if (oldOrigin != textureOrigin()) {
+        Q_EMIT textureOriginChanged();
+    }
+    return true;
 }
 
 } // namespace
@@ -18,6 +18,7 @@
 #include "shadow.h"
 
 #include "deepin_kwinglutils.h"
+#include "utils/cliprectlist.h"
 
 namespace KWin
 {
@@ -72,9 +73,11 @@ protected:
     Scene::Window *createWindow(Toplevel *t) override;
     void finalDrawWindow(EffectWindowImpl* w, int mask, const QRegion &region, WindowPaintData& data) override;
     void paintCursor(AbstractOutput *output, const QRegion &region) override;
+    bool paintCursorFrame(AbstractOutput *output, const QRegion &damage, RenderLoop *renderLoop) override;
 
 private:
     void doPaintBackground(const QVector< float >& vertices);
+    void updateCursorFrameCache(AbstractOutput *output, const QRegion &updated, const QRegion &valid);
     void updateProjectionMatrix(const QRect &geometry);
     void performPaintWindow(EffectWindowImpl* w, int mask, const QRegion &region, WindowPaintData& data);
 
@@ -83,6 +86,13 @@ private:
     LanczosFilter *m_lanczosFilter = nullptr;
     QScopedPointer<GLTexture> m_cursorTexture;
     bool m_cursorTextureDirty = false;
+    // copy of the last frame without the software cursor, per output
+    struct CursorFrameCache {
+        QSharedPointer<GLTexture> texture;
+        // output local region that hasn't been copied yet
+        QRegion missing;
+    };
+    QHash<AbstractOutput *, CursorFrameCache> m_cursorFrameCaches;
     QMatrix4x4 m_projectionMatrix;
     QMatrix4x4 m_screenProjectionMatrix;
     GLuint vao = 0;
@@ -97,6 +107,8 @@ public:
     {
         GLTexture *texture = nullptr;
         WindowQuadList quads;
+        // bounding rect of the quads in item coordinates
+        QRect bounds;
         QMatrix4x4 transformMatrix;
         int firstVertex = 0;
         int vertexCount = 0;
@@ -113,6 +125,7 @@ public:
         const QRegion clip;
         const WindowPaintData &paintData;
         const bool hardwareClipping;
+        const ClipRectList clipRects;
     };
 
     OpenGLWindow(Toplevel *toplevel, SceneOpenGL *scene);
@@ -125,9 +138,32 @@ private:
     QVector4D modulate(float opacity, float brightness) const;
     void setBlendEnabled(bool enabled);
     void createRenderNode(Item *item, RenderContext *context);
+    bool reuseCachedItems(const RenderContext *context);
+    void emitRenderNodes(RenderContext *context) const;
+
+    /**
+     * An item visited while building the render nodes, in paint order. The list is kept
+     * across frames and only rebuilt if an item in the window's subtree becomes dirty. The
+     * quads are stored unclipped, the clip of the frame is applied when emitting the nodes.
+     */
+    struct CachedItem
+    {
+        enum class Type {
+            Other,
+            Shadow,
+            Decoration,
+            Surface,
+        };
+        Item *item = nullptr;
+        Type type = Type::Other;
+        WindowQuadList quads;
+        QMatrix4x4 transformMatrix;
+    };
 
     SceneOpenGL *m_scene;
     bool m_blendingEnabled = false;
+    QVector<CachedItem> m_cachedItems;
+    bool m_cacheValid = false;
 };
 
 class SceneOpenGL::EffectFrame
@@ -149,14 +185,15 @@ public:
 
     static void cleanup();
 
+    struct TextRun;
+
 private:
     void updateTexture();
-    void updateTextTexture();
+    void updateTextRun();
 
     GLTexture *m_texture;
-    GLTexture *m_textTexture;
-    GLTexture *m_oldTextTexture;
-    QPixmap *m_textPixmap; // need to keep the pixmap around to workaround some driver problems
+    QSharedPointer<TextRun> m_textRun;
+    QSharedPointer<TextRun> m_oldTextRun;
     GLTexture *m_iconTexture;
     GLTexture *m_oldIconTexture;
     GLTexture *m_selectionTexture;
@@ -205,19 +242,29 @@ public:
     ~SceneOpenGLDecorationRenderer() override;
 
     void render(const QRegion &region) override;
+    QPoint textureOrigin() const override;
 
     GLTexture *texture() {
-        return m_texture.data();
+        return m_atlasTexture ? m_atlasTexture : m_texture.data();
     }
     GLTexture *texture() const {
-        return m_texture.data();
+        return m_atlasTexture ? m_atlasTexture : m_texture.data();
     }
 
 private:
     void renderPart(const QRect &rect, const QRect &partRect, const QPoint &textureOffset, qreal devicePixelRatio, bool rotated = false);
     static const QMargins texturePadForPart(const QRect &rect, const QRect &partRect);
-    void resizeTexture();
+    bool resizeTexture();
+    void releaseTexture();
+    void evictFromAtlas();
+    // only used if the decoration doesn't fit into a page of the shared atlas
     QScopedPointer<GLTexture> m_texture;
+    GLTexture *m_atlasTexture = nullptr;
+    QRect m_atlasRect;
+    // reused by the parts of a render pass, and kept between passes while resizing
+    QImage m_scratchImage;
+
+    friend class DecorationTextureAtlas;
 };
 
 } // namespace
@@ -16,6 +16,7 @@
 #include "deleted.h"
 #include "effects.h"
 #include "main.h"
+#include "performancemonitor.h"
 #include "renderloop.h"
 #include "screens.h"
 #include "surfaceitem.h"
@@ -48,6 +49,9 @@ SceneQPainter::SceneQPainter(QPainterBackend *backend, QObject *parent)
     , m_backend(backend)
     , m_painter(new QPainter())
 {
+    connect(kwinApp()->platform(), &Platform::outputDisabled, this, [this](AbstractOutput *output) {
+        m_cursorFrameCaches.remove(output);
+    });
 }
 
 SceneQPainter::~SceneQPainter()
@@ -87,6 +91,12 @@ void SceneQPainter::paint(AbstractOutput *output, const QRegion &damage, const Q
 
         QRegion updateRegion, validRegion;
         paintScreen(damage.intersected(geometry), repaint, &updateRegion, &validRegion, renderLoop);
+        if (output->usesSoftwareCursor()) {
+            updateCursorFrameCache(output, *buffer, updateRegion, validRegion);
+        } else {
+            // the cache would fall behind the frames painted in the meantime
+            m_cursorFrameCaches.remove(output);
+        }
         paintCursor(output, updateRegion);
 
         m_painter->end();
@@ -98,6 +108,64 @@ void SceneQPainter::paint(AbstractOutput *output, const QRegion &damage, const Q
     clearStackingOrder();
 }
 
+void SceneQPainter::updateCursorFrameCache(AbstractOutput *output, const QImage &buffer,
+                                           const QRegion &updated, const QRegion &valid)
+{
+    const QRect geometry = output->geometry();
+    CursorFrameCache &cache = m_cursorFrameCaches[output];
+    if (cache.image.size() != buffer.size() || cache.image.format() != buffer.format()) {
+        cache.image = QImage(buffer.size(), buffer.format());
+        cache.missing = geometry;
+    }
+
+    // the rest of the cache still holds what this frame painted there
+    const QRegion region = (updated | cache.missing) & valid;
+    if (region.isEmpty()) {
+        return;
+    }
+
+    QPainter painter(&cache.image);
+    painter.setWindow(geometry);
+    painter.setClipRegion(region);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(geometry, buffer);
+    cache.missing -= region;
+}
+
+bool SceneQPainter::paintCursorFrame(AbstractOutput *output, const QRegion &damage, RenderLoop *renderLoop)
+{
+    auto it = m_cursorFrameCaches.constFind(output);
+    if (it == m_cursorFrameCaches.constEnd() || !it->missing.isEmpty()
+            || it->image.size() != output->pixelSize()) {
+        return false;
+    }
+    const QImage cache = it->image;
+    const QRect geometry = output->geometry();
+
+    // the back buffer may be older than the last frame
+    const QRegion restore = (damage | m_backend->beginFrame(output)) & geometry;
+
+    QImage *buffer = m_backend->bufferForScreen(output);
+    if (!buffer || buffer->isNull()) {
+        return false;
+    }
+    renderLoop->beginFrame();
+    m_painter->begin(buffer);
+    m_painter->setWindow(geometry);
+
+    m_painter->save();
+    m_painter->setClipRegion(restore);
+    m_painter->setCompositionMode(QPainter::CompositionMode_Source);
+    m_painter->drawImage(geometry, cache);
+    m_painter->restore();
+    paintCursor(output, restore);
+
+    m_painter->end();
+    renderLoop->endFrame();
+    m_backend->endFrame(output, restore, damage);
+    return true;
+}
+
 void SceneQPainter::paintBackground(const QRegion &region)
 {
     for (const QRect &rect : region) {
@@ -107,7 +175,7 @@ void SceneQPainter::paintBackground(const QRegion &region)
 
 void SceneQPainter::paintCursor(AbstractOutput *output, const QRegion &rendered)
 {
-    if (!output || output->usesSoftwareCursor() || Cursors::self()->isCursorHidden()) {
+    if (!output || !output->usesSoftwareCursor() || Cursors::self()->isCursorHidden()) {
         return;
     }
 
@@ -189,67 +257,99 @@ void SceneQPainter::Window::performPaint(int mask, const QRegion &_region, const
     }
 
     const bool opaque = qFuzzyCompare(1.0, data.opacity());
-    QImage tempImage;
+    QRect paintRect;
     QPainter tempPainter;
     if (!opaque) {
-        // need a temp render target which we later on blit to the screen
-        tempImage = QImage(boundingRect.size(), QImage::Format_ARGB32_Premultiplied);
-        tempImage.fill(Qt::transparent);
-        tempPainter.begin(&tempImage);
-        tempPainter.save();
+        // need a temp render target which we later on blit to the screen, it is kept
+        // across frames and only the repainted part of it is touched
+        if (m_offscreenBuffer.size() != boundingRect.size()) {
+            m_offscreenBuffer = QImage(boundingRect.size(), QImage::Format_ARGB32_Premultiplied);
+        }
+        tempPainter.begin(&m_offscreenBuffer);
         tempPainter.translate(-boundingRect.topLeft());
+        if (mask & (PAINT_WINDOW_TRANSFORMED | PAINT_SCREEN_TRANSFORMED)) {
+            // the region is in screen coordinates, but the window is painted untransformed
+            paintRect = boundingRect;
+        } else {
+            paintRect = region.boundingRect();
+            tempPainter.setClipRegion(region);
+        }
+        tempPainter.setCompositionMode(QPainter::CompositionMode_Source);
+        tempPainter.fillRect(paintRect, Qt::transparent);
+        tempPainter.setCompositionMode(QPainter::CompositionMode_SourceOver);
         painter = &tempPainter;
+    } else {
+        m_offscreenBuffer = QImage();
     }
 
-    renderItem(painter, windowItem());
+    renderItems(painter);
 
     if (!opaque) {
-        tempPainter.restore();
-        tempPainter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
-        QColor translucent(Qt::transparent);
-        translucent.setAlphaF(data.opacity());
-        tempPainter.fillRect(QRect(QPoint(0, 0), boundingRect.size()), translucent);
         tempPainter.end();
         painter = scenePainter;
-        painter->drawImage(boundingRect.topLeft(), tempImage);
+        // the opacity is applied while blending the buffer, no extra pass over it is needed
+        painter->setOpacity(data.opacity());
+        painter->drawImage(paintRect, m_offscreenBuffer, paintRect.translated(-boundingRect.topLeft()));
     }
 
     painter->restore();
 }
 
-void SceneQPainter::Window::renderItem(QPainter *painter, Item *item) const
+void SceneQPainter::Window::renderItems(QPainter *painter)
 {
-    const QList<Item *> sortedChildItems = item->sortedChildItems();
+    // Check the tree before touching any cached item, a removed item is destroyed by now.
+    bool reused = m_cacheValid && !windowItem()->isSubtreeDirty();
+    if (reused) {
+        for (const CachedItem &cachedItem : qAsConst(m_cachedItems)) {
+            cachedItem.item->preprocess();
+        }
+        // Preprocessing may have updated the quads of an item, e.g. when a new pixmap got created.
+        reused = !windowItem()->isSubtreeDirty();
+    }
+    if (!reused) {
+        m_cachedItems.clear();
+        collectItems(windowItem(), QPoint());
+        windowItem()->resetSubtreeDirty();
+        m_cacheValid = true;
+    }
+    PerformanceMonitor::self()->renderNodeCacheStatistics()->record(reused);
+
+    for (const CachedItem &cachedItem : qAsConst(m_cachedItems)) {
+        painter->translate(cachedItem.offset);
+        if (auto surfaceItem = qobject_cast<SurfaceItem *>(cachedItem.item)) {
+            renderSurfaceItem(painter, surfaceItem);
+        } else if (auto decorationItem = qobject_cast<DecorationItem *>(cachedItem.item)) {
+            renderDecorationItem(painter, decorationItem);
+        }
+        painter->translate(-cachedItem.offset);
+    }
+}
 
-    painter->save();
-    painter->translate(item->position());
+void SceneQPainter::Window::collectItems(Item *item, const QPoint &offset)
+{
+    const QList<Item *> sortedChildItems = item->sortedChildItems();
+    const QPoint position = offset + item->position();
 
     for (Item *childItem : sortedChildItems) {
         if (childItem->z() >= 0) {
             break;
         }
         if (childItem->isVisible()) {
-            renderItem(painter, childItem);
+            collectItems(childItem, position);
         }
     }
 
     item->preprocess();
-    if (auto surfaceItem = qobject_cast<SurfaceItem *>(item)) {
-        renderSurfaceItem(painter, surfaceItem);
-    } else if (auto decorationItem = qobject_cast<DecorationItem *>(item)) {
-        renderDecorationItem(painter, decorationItem);
-    }
+    m_cachedItems.append(CachedItem{item, position});
 
     for (Item *childItem : sortedChildItems) {
         if (childItem->z() < 0) {
             continue;
         }
         if (childItem->isVisible()) {
-            renderItem(painter, childItem);
+            collectItems(childItem, position);
         }
     }
-
-    painter->restore();
 }
 
 void SceneQPainter::Window::renderSurfaceItem(QPainter *painter, SurfaceItem *surfaceItem) const
@@ -325,13 +425,14 @@ QPainterEffectFrame::~QPainterEffectFrame()
 void QPainterEffectFrame::render(const QRegion &region, double opacity, double frameOpacity)
 {
     Q_UNUSED(region)
-    Q_UNUSED(opacity)
-    // TODO: adjust opacity
     if (m_effectFrame->geometry().isEmpty()) {
         return; // Nothing to display
     }
     QPainter *painter = m_scene->scenePainter();
-
+    // the parts of the frame don't overlap much, so they are blended one by one
+    // instead of going through an intermediate image
+    painter->save();
+    painter->setOpacity(opacity);
 
     // Render the actual frame
     if (m_effectFrame->style() == EffectFrameUnstyled) {
@@ -388,6 +489,7 @@ void QPainterEffectFrame::render(const QRegion &region, double opacity, double f
         painter->drawText(rect.translated(m_effectFrame->geometry().topLeft()), m_effectFrame->alignment(), text);
         painter->restore();
     }
+    painter->restore();
 }
 
 //****************************************
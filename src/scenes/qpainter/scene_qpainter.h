@@ -50,12 +50,23 @@ protected:
     void paintBackground(const QRegion &region) override;
     Scene::Window *createWindow(Toplevel *toplevel) override;
     void paintCursor(AbstractOutput *output, const QRegion &region) override;
+    bool paintCursorFrame(AbstractOutput *output, const QRegion &damage, RenderLoop *renderLoop) override;
     void paintOffscreenQuickView(OffscreenQuickView *w) override;
 
 private:
     explicit SceneQPainter(QPainterBackend *backend, QObject *parent = nullptr);
+    void updateCursorFrameCache(AbstractOutput *output, const QImage &buffer,
+                                const QRegion &updated, const QRegion &valid);
+
     QPainterBackend *m_backend;
     QScopedPointer<QPainter> m_painter;
+    // copy of the last frame without the software cursor, per output
+    struct CursorFrameCache {
+        QImage image;
+        // region that hasn't been copied yet
+        QRegion missing;
+    };
+    QHash<AbstractOutput *, CursorFrameCache> m_cursorFrameCaches;
     class Window;
 };
 
@@ -70,8 +81,24 @@ public:
 private:
     void renderSurfaceItem(QPainter *painter, SurfaceItem *surfaceItem) const;
     void renderDecorationItem(QPainter *painter, DecorationItem *decorationItem) const;
-    void renderItem(QPainter *painter, Item *item) const;
+    void renderItems(QPainter *painter);
+    void collectItems(Item *item, const QPoint &offset);
+
+    /**
+     * An item in paint order along with its offset relative to the window item. The list
+     * is only rebuilt when an item in the window's subtree becomes dirty.
+     */
+    struct CachedItem
+    {
+        Item *item;
+        QPoint offset;
+    };
+
     SceneQPainter *m_scene;
+    QVector<CachedItem> m_cachedItems;
+    bool m_cacheValid = false;
+    // offscreen buffer for painting the window translucent, released once it's opaque again
+    QImage m_offscreenBuffer;
 };
 
 class QPainterEffectFrame : public Scene::EffectFrame
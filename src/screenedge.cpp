@@ -113,6 +113,7 @@ void Edge::reserve()
     m_reserved++;
     if (m_reserved == 1) {
         // got activated
+        m_edges->invalidateEdgeBands();
         if (!m_screenEdgeDisabled || !isScreenEdge())
             activate();
     }
@@ -153,6 +154,7 @@ void Edge::unreserve()
     m_reserved--;
     if (m_reserved == 0) {
         // got deactivated
+        m_edges->invalidateEdgeBands();
         stopApproaching();
         deactivate();
     }
@@ -240,13 +242,13 @@ bool Edge::triggersFor(const QPoint &cursorPos) const
     return true;
 }
 
-bool Edge::check(const QPoint &cursorPos, const QDateTime &triggerTime, bool forceNoPushBack)
+bool Edge::check(const QPoint &cursorPos, std::chrono::milliseconds triggerTime, bool forceNoPushBack)
 {
     if (!triggersFor(cursorPos)) {
         return false;
     }
-    if (m_lastTrigger.isValid() && // still in cooldown
-        m_lastTrigger.msecsTo(triggerTime) < edges()->reActivationThreshold() - edges()->timeThreshold()) {
+    if (m_lastTrigger && // still in cooldown
+        (triggerTime - *m_lastTrigger).count() < edges()->reActivationThreshold() - edges()->timeThreshold()) {
         return false;
     }
     // no pushback so we have to activate at once
@@ -262,27 +264,27 @@ bool Edge::check(const QPoint &cursorPos, const QDateTime &triggerTime, bool for
     return false;
 }
 
-void Edge::markAsTriggered(const QPoint &cursorPos, const QDateTime &triggerTime)
+void Edge::markAsTriggered(const QPoint &cursorPos, std::chrono::milliseconds triggerTime)
 {
     m_lastTrigger = triggerTime;
-    m_lastReset = QDateTime(); // invalidate
+    m_lastReset.reset(); // invalidate
     m_triggeredPoint = cursorPos;
 }
 
-bool Edge::canActivate(const QPoint &cursorPos, const QDateTime &triggerTime)
+bool Edge::canActivate(const QPoint &cursorPos, std::chrono::milliseconds triggerTime)
 {
     // we check whether either the timer has explicitly been invalidated (successful trigger) or is
     // bigger than the reactivation threshold (activation "aborted", usually due to moving away the cursor
     // from the corner after successful activation)
     // either condition means that "this is the first event in a new attempt"
-    if (!m_lastReset.isValid() || m_lastReset.msecsTo(triggerTime) > edges()->reActivationThreshold()) {
+    if (!m_lastReset || (triggerTime - *m_lastReset).count() > edges()->reActivationThreshold()) {
         m_lastReset = triggerTime;
         return false;
     }
-    if (m_lastTrigger.isValid() && m_lastTrigger.msecsTo(triggerTime) < edges()->reActivationThreshold() - edges()->timeThreshold()) {
+    if (m_lastTrigger && (triggerTime - *m_lastTrigger).count() < edges()->reActivationThreshold() - edges()->timeThreshold()) {
         return false;
     }
-    if (m_lastReset.msecsTo(triggerTime) < edges()->timeThreshold()) {
+    if ((triggerTime - *m_lastReset).count() < edges()->timeThreshold()) {
         return false;
     }
     // does the check on position make any sense at all?
@@ -523,6 +525,7 @@ void Edge::setGeometry(const QRect &geometry)
         }
     }
     m_approachGeometry = QRect(x, y, width, height);
+    m_edges->invalidateEdgeBands();
     doGeometryUpdate();
 
     if (isScreenEdge()) {
@@ -588,6 +591,7 @@ void Edge::startApproaching()
         return;
     }
     m_approaching = true;
+    m_edges->notifyApproaching();
     doStartApproaching();
     m_lastApproachingFactor = 0;
     Q_EMIT approaching(border(), 0.0, m_approachGeometry);
@@ -1023,6 +1027,7 @@ void ScreenEdges::recreateEdges()
 {
     QList<Edge*> oldEdges(m_edges);
     m_edges.clear();
+    invalidateEdgeBands();
     const QRect fullArea = workspace()->geometry();
     QRegion processedRegion;
 
@@ -1256,6 +1261,7 @@ void ScreenEdges::reserve(AbstractClient *client, ElectricBorder border)
             hadBorder = true;
             delete *it;
             it = m_edges.erase(it);
+            invalidateEdgeBands();
         } else {
             it++;
         }
@@ -1369,13 +1375,14 @@ void ScreenEdges::deleteEdgeForClient(AbstractClient* c)
         if ((*it)->client() == c) {
             delete *it;
             it = m_edges.erase(it);
+            invalidateEdgeBands();
         } else {
             it++;
         }
     }
 }
 
-void ScreenEdges::check(const QPoint &pos, const QDateTime &now, bool forceNoPushBack)
+void ScreenEdges::check(const QPoint &pos, std::chrono::milliseconds now, bool forceNoPushBack)
 {
     bool activatedForClient = false;
     for (auto it = m_edges.begin(); it != m_edges.end(); ++it) {
@@ -1400,51 +1407,129 @@ void ScreenEdges::check(const QPoint &pos, const QDateTime &now, bool forceNoPus
     }
 }
 
+void ScreenEdges::invalidateEdgeBands()
+{
+    m_edgeBandsDirty = true;
+}
+
+void ScreenEdges::notifyApproaching()
+{
+    m_maybeApproaching = true;
+}
+
+void ScreenEdges::updateEdgeBands()
+{
+    m_edgeBands.clear();
+    const auto outputs = kwinApp()->platform()->enabledOutputs();
+    for (const AbstractOutput *output : outputs) {
+        EdgeBand band{output->geometry(), output->geometry()};
+        for (const Edge *edge : qAsConst(m_edges)) {
+            if (!edge->isReserved()) {
+                continue;
+            }
+            const QRect area = edge->geometry().united(edge->approachGeometry()).intersected(band.quiet);
+            if (area.isEmpty()) {
+                continue;
+            }
+            // cut the edge off along the side of the output it sits on, prefer the smaller cut
+            // in the corners; an edge away from the sides disables the fast path for the output
+            QRect cut;
+            auto tryCut = [&cut](const QRect &candidate) {
+                const qint64 area = qint64(candidate.width()) * candidate.height();
+                if (cut.isNull() || area > qint64(cut.width()) * cut.height()) {
+                    cut = candidate;
+                }
+            };
+            if (area.left() == band.quiet.left()) {
+                tryCut(band.quiet.adjusted(area.width(), 0, 0, 0));
+            }
+            if (area.right() == band.quiet.right()) {
+                tryCut(band.quiet.adjusted(0, 0, -area.width(), 0));
+            }
+            if (area.top() == band.quiet.top()) {
+                tryCut(band.quiet.adjusted(0, area.height(), 0, 0));
+            }
+            if (area.bottom() == band.quiet.bottom()) {
+                tryCut(band.quiet.adjusted(0, 0, 0, -area.height()));
+            }
+            band.quiet = cut;
+            if (band.quiet.isEmpty()) {
+                break;
+            }
+        }
+        m_edgeBands.append(band);
+    }
+    m_edgeBandsDirty = false;
+}
+
+bool ScreenEdges::isAwayFromEdges(const QPoint &pos)
+{
+    if (m_edgeBandsDirty) {
+        updateEdgeBands();
+    }
+    for (const EdgeBand &band : qAsConst(m_edgeBands)) {
+        if (band.output.contains(pos)) {
+            return band.quiet.contains(pos);
+        }
+    }
+    return false;
+}
+
 bool ScreenEdges::isEntered(QMouseEvent *event)
 {
     if (event->type() != QEvent::MouseMove) {
         return false;
     }
+    const QPoint pos = event->globalPos();
+    // the common case, nothing to do unless an edge has to stop approaching
+    if (!m_maybeApproaching && isAwayFromEdges(pos)) {
+        return false;
+    }
+    const std::chrono::milliseconds timestamp(event->timestamp());
     bool activated = false;
     bool activatedForClient = false;
+    bool approaching = false;
     for (auto it = m_edges.begin(); it != m_edges.end(); ++it) {
         Edge *edge = *it;
         if (!edge->isReserved()) {
             continue;
         }
         if (!edge->activatesForPointer()) {
+            approaching = approaching || edge->isApproaching();
             continue;
         }
-        if (edge->approachGeometry().contains(event->globalPos())) {
+        if (edge->approachGeometry().contains(pos)) {
             if (!edge->isApproaching()) {
                 edge->startApproaching();
             } else {
-                edge->updateApproaching(event->globalPos());
+                edge->updateApproaching(pos);
             }
         } else {
             if (edge->isApproaching()) {
                 edge->stopApproaching();
             }
         }
-        if (edge->geometry().contains(event->globalPos())) {
-            if (edge->check(event->globalPos(), QDateTime::fromMSecsSinceEpoch(event->timestamp(), Qt::UTC))) {
+        if (edge->geometry().contains(pos)) {
+            if (edge->check(pos, timestamp)) {
                 if (edge->client()) {
                     activatedForClient = true;
                 }
             }
         }
+        approaching = approaching || edge->isApproaching();
     }
     if (activatedForClient) {
         for (auto it = m_edges.constBegin(); it != m_edges.constEnd(); ++it) {
             if ((*it)->client()) {
-                (*it)->markAsTriggered(event->globalPos(), QDateTime::fromMSecsSinceEpoch(event->timestamp(), Qt::UTC));
+                (*it)->markAsTriggered(pos, timestamp);
             }
         }
     }
+    m_maybeApproaching = approaching;
     return activated;
 }
 
-bool ScreenEdges::handleEnterNotifiy(xcb_window_t window, const QPoint &point, const QDateTime &timestamp)
+bool ScreenEdges::handleEnterNotifiy(xcb_window_t window, const QPoint &point, std::chrono::milliseconds timestamp)
 {
     bool activated = false;
     bool activatedForClient = false;
@@ -1493,7 +1578,7 @@ bool ScreenEdges::handleDndNotify(xcb_window_t window, const QPoint &point)
         }
         if (edge->isReserved() && edge->window() == window) {
             updateXTime();
-            edge->check(point, QDateTime::fromMSecsSinceEpoch(xTime(), Qt::UTC), true);
+            edge->check(point, std::chrono::milliseconds(xTime()), true);
             return true;
         }
     }
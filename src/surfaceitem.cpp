@@ -130,6 +130,14 @@ void SurfaceItem::discardPixmap()
     addDamage(rect());
 }
 
+void SurfaceItem::releasePixmaps()
+{
+    m_pixmap.reset();
+    m_previousPixmap.reset();
+    m_referencePixmapCounter = 0;
+    discardQuads();
+}
+
 void SurfaceItem::preprocess()
 {
     updatePixmap();
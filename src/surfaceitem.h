@@ -37,6 +37,10 @@ public:
 
     void discardPixmap();
     void updatePixmap();
+    /**
+     * Destroys the current and the previous pixmap, including their textures.
+     */
+    void releasePixmaps();
 
     SurfacePixmap *pixmap() const;
     SurfacePixmap *previousPixmap() const;
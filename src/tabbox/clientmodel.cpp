@@ -161,8 +161,7 @@ void ClientModel::createClientList(int desktop, bool partialReset)
         }
     }
 
-    beginResetModel();
-    m_clientList.clear();
+    TabBoxClientList clientList;
     QList< QWeakPointer< TabBoxClient > > stickyClients;
 
     switch(tabBox->config().clientSwitchingMode()) {
@@ -178,7 +177,7 @@ void ClientModel::createClientList(int desktop, bool partialReset)
         do {
             QSharedPointer<TabBoxClient> add = tabBox->clientToAddToList(c.data(), desktop);
             if (!add.isNull()) {
-                m_clientList += add;
+                clientList += add;
                 if (add.data()->isFirstInTabBox()) {
                     stickyClients << add;
                 }
@@ -197,10 +196,10 @@ void ClientModel::createClientList(int desktop, bool partialReset)
             QSharedPointer<TabBoxClient> add = tabBox->clientToAddToList(c.data(), desktop);
             if (!add.isNull()) {
                 if (start == add.data()) {
-                    m_clientList.removeAll(add);
-                    m_clientList.prepend(add);
+                    clientList.removeAll(add);
+                    clientList.prepend(add);
                 } else
-                    m_clientList += add;
+                    clientList += add;
                 if (add.data()->isFirstInTabBox()) {
                     stickyClients << add;
                 }
@@ -218,16 +217,56 @@ void ClientModel::createClientList(int desktop, bool partialReset)
     }
     }
     for (const QWeakPointer< TabBoxClient > &c : qAsConst(stickyClients)) {
-        m_clientList.removeAll(c);
-        m_clientList.prepend(c);
+        clientList.removeAll(c);
+        clientList.prepend(c);
     }
     if (tabBox->config().clientApplicationsMode() != TabBoxConfig::AllWindowsCurrentApplication
-            && (tabBox->config().showDesktopMode() == TabBoxConfig::ShowDesktopClient || m_clientList.isEmpty())) {
+            && (tabBox->config().showDesktopMode() == TabBoxConfig::ShowDesktopClient || clientList.isEmpty())) {
         QWeakPointer<TabBoxClient> desktopClient = tabBox->desktopClient();
         if (!desktopClient.isNull())
-            m_clientList.append(desktopClient);
+            clientList.append(desktopClient);
+    }
+    updateClientList(clientList);
+}
+
+void ClientModel::updateClientList(const TabBoxClientList &clientList)
+{
+    // Apply the differences instead of resetting the model, so the views can keep the
+    // delegates of the clients that are still there. Usually only the previously active
+    // client moves.
+    for (int i = m_clientList.count() - 1; i >= 0; --i) {
+        const QWeakPointer<TabBoxClient> &client = m_clientList.at(i);
+        if (client.isNull() || !clientList.contains(client)) {
+            beginRemoveRows(QModelIndex(), i, i);
+            m_clientList.removeAt(i);
+            endRemoveRows();
+        }
+    }
+    for (int i = 0; i < clientList.count(); ++i) {
+        const QWeakPointer<TabBoxClient> &client = clientList.at(i);
+        if (i < m_clientList.count() && m_clientList.at(i) == client) {
+            continue;
+        }
+        const int from = m_clientList.indexOf(client, i + 1);
+        if (from != -1) {
+            beginMoveRows(QModelIndex(), from, from, QModelIndex(), i);
+            m_clientList.move(from, i);
+            endMoveRows();
+        } else {
+            beginInsertRows(QModelIndex(), i, i);
+            m_clientList.insert(i, client);
+            endInsertRows();
+        }
+    }
+    if (m_clientList.count() > clientList.count()) {
+        beginRemoveRows(QModelIndex(), clientList.count(), m_clientList.count() - 1);
+        m_clientList.erase(m_clientList.begin() + clientList.count(), m_clientList.end());
+        endRemoveRows();
+    }
+    // captions, icons and states might have changed since the list was created
+    if (!m_clientList.isEmpty()) {
+        Q_EMIT dataChanged(index(0, 0), index(m_clientList.count() - 1, 0));
     }
-    endResetModel();
 }
 
 void ClientModel::close(int i)
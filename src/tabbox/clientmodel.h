@@ -65,7 +65,8 @@ public:
 
     /**
      * Generates a new list of TabBoxClients based on the current config.
-     * Calling this method will reset the model. If partialReset is true
+     * The model is updated with row moves, insertions and removals, it is
+     * not reset. If partialReset is true
      * the top of the list is kept as a starting point. If not the
      * current active client is used as the starting point to generate the
      * list.
@@ -94,6 +95,7 @@ public Q_SLOTS:
     void activate(int index);
 
 private:
+    void updateClientList(const TabBoxClientList &clientList);
     TabBoxClientList m_clientList;
 };
 
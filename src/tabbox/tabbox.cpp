@@ -508,6 +508,9 @@ TabBox::TabBox(QObject *parent)
     m_tabBoxMode = TabBoxDesktopMode; // init variables
     connect(&m_delayedShowTimer, &QTimer::timeout, this, &TabBox::show);
     connect(Workspace::self(), &Workspace::configChanged, this, &TabBox::reconfigure);
+    m_prewarmTimer.setSingleShot(true);
+    m_prewarmTimer.setInterval(5000);
+    connect(&m_prewarmTimer, &QTimer::timeout, this, &TabBox::prewarmSwitchers);
 }
 
 TabBox::~TabBox()
@@ -745,6 +748,22 @@ void TabBox::hide(bool abort)
     }
 }
 
+void TabBox::prewarmSwitchers()
+{
+    if (m_prewarmQueue.isEmpty()) {
+        return;
+    }
+    if (isDisplayed() || isGrabbed()) {
+        m_prewarmTimer.start();
+        return;
+    }
+    m_tabBox->prewarm(m_prewarmQueue.takeFirst());
+    if (!m_prewarmQueue.isEmpty()) {
+        // one layout per event loop iteration
+        QTimer::singleShot(0, this, &TabBox::prewarmSwitchers);
+    }
+}
+
 void TabBox::reconfigure()
 {
     KSharedConfigPtr c = kwinApp()->config();
@@ -760,6 +779,10 @@ void TabBox::reconfigure()
 
     m_tabBox->setConfig(m_defaultConfig);
 
+    // the desktop switchers are rarely used, don't spend memory on them
+    m_prewarmQueue = {m_defaultConfig, m_alternativeConfig};
+    m_prewarmTimer.start();
+
     m_delayShow = config.readEntry<bool>("ShowDelay", true);
     m_delayShowTime = config.readEntry<int>("DelayTime", 90);
 
@@ -319,6 +319,7 @@ private:
 private Q_SLOTS:
     void reconfigure();
     void globalShortcutChanged(QAction *action, const QKeySequence &seq);
+    void prewarmSwitchers();
 
 private:
     TabBoxMode m_tabBoxMode;
@@ -330,6 +331,9 @@ private:
 
     QTimer m_delayedShowTimer;
     int m_displayRefcount;
+    // loads the window switchers once things have settled, so the first Alt+Tab is fast
+    QTimer m_prewarmTimer;
+    QList<TabBoxConfig> m_prewarmQueue;
 
     TabBoxConfig m_defaultConfig;
     TabBoxConfig m_alternativeConfig;
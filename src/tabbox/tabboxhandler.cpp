@@ -59,6 +59,7 @@ public:
     void endHighlightWindows(bool abort = false);
 
     void show();
+    void prewarm(bool desktopMode, const QString &layoutName);
     QQuickWindow *window() const;
     SwitcherItem *switcherItem() const;
 
@@ -85,7 +86,9 @@ public:
     bool m_lastRaisedClientWasMinimized;
 
 private:
-    QObject *createSwitcherItem(bool desktopMode);
+    void ensureQmlContext();
+    QObject *findOrCreateSwitcherItem(bool desktopMode, const QString &layoutName, bool reportErrors);
+    QObject *createSwitcherItem(bool desktopMode, const QString &layoutName, bool reportErrors);
     bool isUseQSGSoftwareRender();
 };
 
@@ -227,21 +230,21 @@ void TabBoxHandlerPrivate::endHighlightWindows(bool abort)
 }
 
 #ifndef KWIN_UNIT_TEST
-QObject *TabBoxHandlerPrivate::createSwitcherItem(bool desktopMode)
+QObject *TabBoxHandlerPrivate::createSwitcherItem(bool desktopMode, const QString &layoutName, bool reportErrors)
 {
     // first try look'n'feel package
     QString file = QStandardPaths::locate(
         QStandardPaths::GenericDataLocation,
         QStringLiteral("plasma/look-and-feel/%1/contents/%2")
-            .arg(config.layoutName(),
+            .arg(layoutName,
                  desktopMode ? QStringLiteral("desktopswitcher/DesktopSwitcher.qml") : QStringLiteral("windowswitcher/WindowSwitcher.qml")));
     if (file.isNull()) {
         const QString folderName = QLatin1String(KWIN_NAME) + (desktopMode ? QLatin1String("/desktoptabbox/") : QLatin1String("/tabbox/"));
-        auto findSwitcher = [this, desktopMode, folderName] {
+        auto findSwitcher = [desktopMode, folderName, layoutName] {
             const QString type = desktopMode ? QStringLiteral("KWin/DesktopSwitcher") : QStringLiteral("KWin/WindowSwitcher");
             auto offers = KPackage::PackageLoader::self()->findPackages(type,  folderName,
-                [this] (const KPluginMetaData &data) {
-                    return data.pluginId().compare(config.layoutName(), Qt::CaseInsensitive) == 0;
+                [layoutName] (const KPluginMetaData &data) {
+                    return data.pluginId().compare(layoutName, Qt::CaseInsensitive) == 0;
                 }
             );
             if (offers.isEmpty()) {
@@ -280,6 +283,9 @@ QObject *TabBoxHandlerPrivate::createSwitcherItem(bool desktopMode)
     m_qmlComponent->loadUrl(QUrl::fromLocalFile(file));
     if (m_qmlComponent->isError()) {
         qCDebug(KWIN_TABBOX) << "Component failed to load: " << m_qmlComponent->errors();
+        if (!reportErrors) {
+            return nullptr;
+        }
         QStringList args;
         args << QStringLiteral("--passivepopup") << i18n("The Window Switcher installation is broken, resources are missing.\n"
                                             "Contact your distribution about this.") << QStringLiteral("20");
@@ -287,14 +293,58 @@ QObject *TabBoxHandlerPrivate::createSwitcherItem(bool desktopMode)
     } else {
         QObject *object = m_qmlComponent->create(m_qmlContext.data());
         if (desktopMode) {
-            m_desktopTabBoxes.insert(config.layoutName(), object);
+            m_desktopTabBoxes.insert(layoutName, object);
         } else {
-            m_clientTabBoxes.insert(config.layoutName(), object);
+            m_clientTabBoxes.insert(layoutName, object);
         }
         return object;
     }
     return nullptr;
 }
+
+void TabBoxHandlerPrivate::ensureQmlContext()
+{
+#ifdef __mips__
+    if(isUseQSGSoftwareRender()) {
+        QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+    }
+#endif
+    if (m_qmlContext.isNull()) {
+        qmlRegisterType<SwitcherItem>("org.kde.kwin", 2, 0, "Switcher");
+        qmlRegisterType<SwitcherItem>("org.kde.kwin", 3, 0, "TabBoxSwitcher");
+        m_qmlContext.reset(new QQmlContext(Scripting::self()->qmlEngine()));
+    }
+    if (m_qmlComponent.isNull()) {
+        m_qmlComponent.reset(new QQmlComponent(Scripting::self()->qmlEngine()));
+    }
+}
+
+QObject *TabBoxHandlerPrivate::findOrCreateSwitcherItem(bool desktopMode, const QString &layoutName, bool reportErrors)
+{
+    const QMap<QString, QObject *> &tabBoxes = desktopMode ? m_desktopTabBoxes : m_clientTabBoxes;
+    auto it = tabBoxes.constFind(layoutName);
+    if (it != tabBoxes.constEnd()) {
+        return it.value();
+    }
+    return createSwitcherItem(desktopMode, layoutName, reportErrors);
+}
+
+void TabBoxHandlerPrivate::prewarm(bool desktopMode, const QString &layoutName)
+{
+    ensureQmlContext();
+    QObject *item = findOrCreateSwitcherItem(desktopMode, layoutName, false);
+    if (!item) {
+        return;
+    }
+    // hand over the model now, so the delegates only need to be updated when it is shown
+    SwitcherItem *switcher = qobject_cast<SwitcherItem*>(item);
+    if (!switcher) {
+        switcher = item->findChild<SwitcherItem*>();
+    }
+    if (switcher && !switcher->model()) {
+        switcher->setModel(desktopMode ? static_cast<QAbstractItemModel *>(desktopModel()) : clientModel());
+    }
+}
 #endif
 bool TabBoxHandlerPrivate::isUseQSGSoftwareRender()
 {
@@ -327,34 +377,11 @@ bool TabBoxHandlerPrivate::isUseQSGSoftwareRender()
 void TabBoxHandlerPrivate::show()
 {
 #ifndef KWIN_UNIT_TEST
-#ifdef __mips__
-    if(isUseQSGSoftwareRender()) {
-        QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
-    }
-#endif
-    if (m_qmlContext.isNull()) {
-        qmlRegisterType<SwitcherItem>("org.kde.kwin", 2, 0, "Switcher");
-        qmlRegisterType<SwitcherItem>("org.kde.kwin", 3, 0, "TabBoxSwitcher");
-        m_qmlContext.reset(new QQmlContext(Scripting::self()->qmlEngine()));
-    }
-    if (m_qmlComponent.isNull()) {
-        m_qmlComponent.reset(new QQmlComponent(Scripting::self()->qmlEngine()));
-    }
+    ensureQmlContext();
     const bool desktopMode = (config.tabBoxMode() == TabBoxConfig::DesktopTabBox);
-    auto findMainItem = [this](const QMap<QString, QObject *> &tabBoxes) -> QObject* {
-        auto it = tabBoxes.constFind(config.layoutName());
-        if (it != tabBoxes.constEnd()) {
-            return it.value();
-        }
-        return nullptr;
-    };
-    m_mainItem = nullptr;
-    m_mainItem = desktopMode ? findMainItem(m_desktopTabBoxes) : findMainItem(m_clientTabBoxes);
+    m_mainItem = findOrCreateSwitcherItem(desktopMode, config.layoutName(), true);
     if (!m_mainItem) {
-        m_mainItem = createSwitcherItem(desktopMode);
-        if (!m_mainItem) {
-            return;
-        }
+        return;
     }
     if (SwitcherItem *item = switcherItem()) {
         // In case the model isn't yet set (see below), index will be reset and therefore we
@@ -412,6 +439,18 @@ void TabBoxHandler::setConfig(const TabBoxConfig& config)
     Q_EMIT configChanged();
 }
 
+void TabBoxHandler::prewarm(const TabBoxConfig &config)
+{
+#ifndef KWIN_UNIT_TEST
+    if (d->isShown || !config.isShowTabBox()) {
+        return;
+    }
+    d->prewarm(config.tabBoxMode() == TabBoxConfig::DesktopTabBox, config.layoutName());
+#else
+    Q_UNUSED(config)
+#endif
+}
+
 void TabBoxHandler::show()
 {
     d->isShown = true;
@@ -231,6 +231,11 @@ public:
      * @see TabBoxConfig::isHighlightWindows
      */
     void show();
+    /**
+     * Loads the layout of @p config and creates its view ahead of time, so that showing
+     * it for the first time doesn't have to. Nothing is shown.
+     */
+    void prewarm(const TabBoxConfig &config);
     /**
      * Hides the TabBoxView if shown.
      * Deactivates highlight windows effect if active.
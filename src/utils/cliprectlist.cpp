@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#include "cliprectlist.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+namespace KWin
+{
+
+ClipRectList::ClipRectList(const QRegion &region)
+    : m_boundingRect(region.boundingRect())
+{
+    m_boxes.reserve(region.rectCount());
+    for (const QRect &rect : region) {
+        m_boxes.append(Box{rect.x(), rect.y(), rect.x() + rect.width(), rect.y() + rect.height()});
+    }
+}
+
+int ClipRectList::firstCandidate(qreal top) const
+{
+    // Bands are sorted from top to bottom, so the bottom edges never decrease.
+    const auto it = std::partition_point(m_boxes.constBegin(), m_boxes.constEnd(), [top](const Box &box) {
+        return box.y2 <= top;
+    });
+    return it - m_boxes.constBegin();
+}
+
+bool ClipRectList::boxesIntersect(const Box &a, const Box &b)
+{
+#if defined(__SSE2__)
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&a));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&b));
+    // [a.x1, a.y1, b.x1, b.y1] must be less than [b.x2, b.y2, a.x2, a.y2] component-wise
+    const __m128i lower = _mm_unpacklo_epi64(va, vb);
+    const __m128i upper = _mm_unpackhi_epi64(vb, va);
+    return _mm_movemask_epi8(_mm_cmpgt_epi32(upper, lower)) == 0xffff;
+#else
+    return a.x1 < b.x2 && b.x1 < a.x2 && a.y1 < b.y2 && b.y1 < a.y2;
+#endif
+}
+
+bool ClipRectList::intersects(const QRect &rect) const
+{
+    if (m_boxes.isEmpty() || !m_boundingRect.intersects(rect)) {
+        return false;
+    }
+    const Box box{rect.x(), rect.y(), rect.x() + rect.width(), rect.y() + rect.height()};
+    for (int i = firstCandidate(box.y1); i < m_boxes.count(); ++i) {
+        const Box &candidate = m_boxes[i];
+        if (candidate.y1 >= box.y2) {
+            break;
+        }
+        if (boxesIntersect(candidate, box)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace KWin
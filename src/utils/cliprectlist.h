@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2018 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+#pragma once
+
+#include <deepin_kwin_export.h>
+
+#include <QRect>
+#include <QRectF>
+#include <QRegion>
+#include <QVarLengthArray>
+
+namespace KWin
+{
+
+/**
+ * The ClipRectList class is a flat, read-only copy of the rectangles of a QRegion that
+ * is optimized for testing many rectangles against the same clip.
+ *
+ * The rectangles are kept in the banded y-x order of QRegion, so lookups skip whole
+ * bands with a binary search and stop as soon as a rectangle starts below the tested
+ * area. Small clips are stored inline without touching the heap.
+ */
+class KWIN_EXPORT ClipRectList
+{
+public:
+    ClipRectList() = default;
+    explicit ClipRectList(const QRegion &region);
+
+    bool isEmpty() const;
+    int count() const;
+    QRect boundingRect() const;
+
+    /**
+     * Returns @c true if @a rect intersects any rectangle in the list.
+     */
+    bool intersects(const QRect &rect) const;
+
+    /**
+     * Calls @a func for each rectangle in the list that overlaps @a rect. Iteration stops
+     * if @a func returns @c false.
+     */
+    template<typename Func>
+    void forEachIntersection(const QRectF &rect, Func func) const;
+
+private:
+    // right and bottom edges are exclusive
+    struct Box
+    {
+        int x1;
+        int y1;
+        int x2;
+        int y2;
+    };
+
+    int firstCandidate(qreal top) const;
+    static bool boxesIntersect(const Box &a, const Box &b);
+
+    QVarLengthArray<Box, 16> m_boxes;
+    QRect m_boundingRect;
+};
+
+inline bool ClipRectList::isEmpty() const
+{
+    return m_boxes.isEmpty();
+}
+
+inline int ClipRectList::count() const
+{
+    return m_boxes.count();
+}
+
+inline QRect ClipRectList::boundingRect() const
+{
+    return m_boundingRect;
+}
+
+template<typename Func>
+void ClipRectList::forEachIntersection(const QRectF &rect, Func func) const
+{
+    if (m_boxes.isEmpty() || !QRectF(m_boundingRect).intersects(rect)) {
+        return;
+    }
+    for (int i = firstCandidate(rect.top()); i < m_boxes.count(); ++i) {
+        const Box &box = m_boxes[i];
+        if (box.y1 >= rect.bottom()) {
+            break;
+        }
+        if (box.x2 <= rect.left() || box.x1 >= rect.right()) {
+            continue;
+        }
+        if (!func(QRectF(box.x1, box.y1, box.x2 - box.x1, box.y2 - box.y1))) {
+            break;
+        }
+    }
+}
+
+} // namespace KWin
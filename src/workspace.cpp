@@ -822,6 +822,8 @@ void Workspace::addClient(X11Client *c)
     }
     m_x11Clients.append(c);
     m_allClients.append(c);
+    m_x11ClientWindows.insert(c, {});
+    updateX11ClientIndex(c);
     addToStack(c);
     markXStackingOrderAsDirty();
     updateClientArea(); // This cannot be in manage(), because the client got added only now
@@ -843,6 +845,7 @@ void Workspace::addClient(X11Client *c)
 void Workspace::addUnmanaged(Unmanaged* c)
 {
     m_unmanaged.append(c);
+    m_unmanagedIndex.insert(c->window(), c);
     markXStackingOrderAsDirty();
 }
 
@@ -860,6 +863,10 @@ void Workspace::removeX11Client(X11Client *c)
     Q_ASSERT(m_x11Clients.contains(c));
     // TODO: if marked client is removed, notify the marked list
     m_x11Clients.removeAll(c);
+    const auto windows = m_x11ClientWindows.take(c);
+    for (xcb_window_t window : windows) {
+        m_x11ClientIndex.remove(window);
+    }
     Group* group = findGroup(c->window());
     if (group != nullptr)
         group->lostLeader();
@@ -870,6 +877,11 @@ void Workspace::removeUnmanaged(Unmanaged* c)
 {
     Q_ASSERT(m_unmanaged.contains(c));
     m_unmanaged.removeAll(c);
+    // a window that got mapped again while its release was scheduled has a new Unmanaged
+    auto it = m_unmanagedIndex.find(c->window());
+    if (it != m_unmanagedIndex.end() && *it == c) {
+        m_unmanagedIndex.erase(it);
+    }
     Q_EMIT unmanagedRemoved(c);
     markXStackingOrderAsDirty();
 }
@@ -2035,34 +2047,52 @@ Unmanaged *Workspace::findUnmanaged(std::function<bool (const Unmanaged*)> func)
 
 Unmanaged *Workspace::findUnmanaged(xcb_window_t w) const
 {
-    return findUnmanaged([w](const Unmanaged *u) {
-        return u->window() == w;
-    });
+    return m_unmanagedIndex.value(w);
 }
 
 X11Client *Workspace::findClient(Predicate predicate, xcb_window_t w) const
 {
+    X11Client *c = m_x11ClientIndex.value(w);
+    if (!c) {
+        return nullptr;
+    }
     switch (predicate) {
     case Predicate::WindowMatch:
-        return findClient([w](const X11Client *c) {
-            return c->window() == w;
-        });
+        return c->window() == w ? c : nullptr;
     case Predicate::WrapperIdMatch:
-        return findClient([w](const X11Client *c) {
-            return c->wrapperId() == w;
-        });
+        return c->wrapperId() == w ? c : nullptr;
     case Predicate::FrameIdMatch:
-        return findClient([w](const X11Client *c) {
-            return c->frameId() == w;
-        });
+        return c->frameId() == w ? c : nullptr;
     case Predicate::InputIdMatch:
-        return findClient([w](const X11Client *c) {
-            return c->inputId() == w;
-        });
+        return c->inputId() == w ? c : nullptr;
     }
     return nullptr;
 }
 
+X11Client *Workspace::findClientOwningWindow(xcb_window_t w) const
+{
+    return m_x11ClientIndex.value(w);
+}
+
+void Workspace::updateX11ClientIndex(X11Client *c)
+{
+    auto it = m_x11ClientWindows.find(c);
+    if (it == m_x11ClientWindows.end()) {
+        return;
+    }
+    for (xcb_window_t window : qAsConst(*it)) {
+        m_x11ClientIndex.remove(window);
+    }
+    it->clear();
+    const xcb_window_t windows[] = {c->window(), c->wrapperId(), c->frameId(), c->inputId()};
+    for (xcb_window_t window : windows) {
+        if (window != XCB_WINDOW_NONE) {
+            m_x11ClientIndex.insert(window, c);
+            it->append(window);
+        }
+    }
+}
+
 Toplevel *Workspace::findToplevel(std::function<bool (const Toplevel*)> func) const
 {
     if (auto *ret = Toplevel::findInList(m_allClients, func)) {
@@ -2263,12 +2293,33 @@ KWaylandServer::DDEShellSurfaceInterface* Workspace::getDDEShellSurface(Abstract
 Group* Workspace::findGroup(xcb_window_t leader) const
 {
     Q_ASSERT(leader != XCB_WINDOW_NONE);
-    for (auto it = groups.constBegin();
-            it != groups.constEnd();
-            ++it)
-        if ((*it)->leader() == leader)
-            return *it;
-    return nullptr;
+    return m_groupIndex.value(leader);
+}
+
+void Workspace::addGroup(Group* group)
+{
+    Q_EMIT groupAdded(group);
+    groups.append(group);
+    if (!m_groupIndex.contains(group->leader())) {
+        m_groupIndex.insert(group->leader(), group);
+    }
+}
+
+void Workspace::removeGroup(Group* group)
+{
+    groups.removeAll(group);
+    auto it = m_groupIndex.find(group->leader());
+    if (it == m_groupIndex.end() || *it != group) {
+        return;
+    }
+    m_groupIndex.erase(it);
+    // keep finding the first group with this leader, like a scan of the list would
+    for (Group *other : qAsConst(groups)) {
+        if (other->leader() == group->leader()) {
+            m_groupIndex.insert(other->leader(), other);
+            break;
+        }
+    }
 }
 
 // Client is group transient, but has no group set. Try to find
@@ -18,7 +18,9 @@
 #include "sm.h"
 #include "utils/common.h"
 // Qt
+#include <QHash>
 #include <QTimer>
+#include <QVarLengthArray>
 #include <QVector>
 // std
 #include <functional>
@@ -120,12 +122,22 @@ public:
     /**
      * @brief Finds the Client matching the given match @p predicate for the given window.
      *
+     * The lookup goes through an index of the X11 windows of all managed clients, so it
+     * takes constant time.
+     *
      * @param predicate Which window should be compared
      * @param w The window id to test against
      * @return KWin::X11Client *The found Client or @c null
      * @see findClient(std::function<bool (const X11Client *)>)
      */
     X11Client *findClient(Predicate predicate, xcb_window_t w) const;
+    /**
+     * @brief Finds the Client owning the given window, whichever of its windows it is.
+     *
+     * @param w The window id to search for
+     * @return KWin::X11Client *The found Client or @c null
+     */
+    X11Client *findClientOwningWindow(xcb_window_t w) const;
     void forEachClient(std::function<void (X11Client *)> func);
     void forEachAbstractClient(std::function<void (AbstractClient*)> func);
     Unmanaged *findUnmanaged(std::function<bool (const Unmanaged*)> func) const;
@@ -367,6 +379,11 @@ public:
     xcb_timestamp_t showingDesktopTimestamp() const;
 
     void removeX11Client(X11Client *);   // Only called from X11Client::destroyClient() or X11Client::releaseWindow()
+    /**
+     * Updates the window id index after the managed client @p c created or destroyed
+     * one of its X11 windows. Does nothing if @p c is not managed (yet).
+     */
+    void updateX11ClientIndex(X11Client *c);
     Q_SLOT void setPreviewClientList(const QList<AbstractClient *> &list);
     Q_SLOT bool previewingClientList() const;
     Q_SLOT bool previewingClient(const AbstractClient *c) const;
@@ -713,6 +730,11 @@ private:
     QList<X11Client *> m_x11Clients;
     QList<AbstractClient*> m_allClients;
     QList<Unmanaged *> m_unmanaged;
+    // every X11 window owned by a managed client (client, wrapper, frame and input window)
+    // or an unmanaged one, so X11 events don't need to scan the client lists
+    QHash<xcb_window_t, X11Client *> m_x11ClientIndex;
+    QHash<const X11Client *, QVarLengthArray<xcb_window_t, 4>> m_x11ClientWindows;
+    QHash<xcb_window_t, Unmanaged *> m_unmanagedIndex;
     QList<Deleted *> deleted;
     QList<InternalClient *> m_internalClients;
 
@@ -734,6 +756,7 @@ private:
     QList<AbstractClient*> previewMinimizedClients; // FIXME: qobject setProperty not working.
 
     QList<Group *> groups;
+    QHash<xcb_window_t, Group *> m_groupIndex;
 
     bool was_user_interaction;
     QScopedPointer<X11EventFilter> m_wasUserInteractionFilter;
@@ -851,17 +874,6 @@ inline AbstractClient *Workspace::mostRecentlyActivatedClient() const
     return should_get_focus.count() > 0 ? should_get_focus.last() : active_client;
 }
 
-inline void Workspace::addGroup(Group* group)
-{
-    Q_EMIT groupAdded(group);
-    groups.append(group);
-}
-
-inline void Workspace::removeGroup(Group* group)
-{
-    groups.removeAll(group);
-}
-
 inline const QList<Toplevel *> &Workspace::stackingOrder() const
 {
     // TODO: Q_ASSERT( block_stacking_updates == 0 );
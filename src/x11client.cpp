@@ -1077,7 +1077,10 @@ void X11Client::updateInputWindow()
     }
 
     if (region.isEmpty()) {
-        m_decoInputExtent.reset();
+        if (m_decoInputExtent.isValid()) {
+            m_decoInputExtent.reset();
+            workspace()->updateX11ClientIndex(this);
+        }
         return;
     }
 
@@ -1100,6 +1103,7 @@ void X11Client::updateInputWindow()
             XCB_EVENT_MASK_POINTER_MOTION
         };
         m_decoInputExtent.create(bounds, XCB_WINDOW_CLASS_INPUT_ONLY, mask, values);
+        workspace()->updateX11ClientIndex(this);
         if (mapping_state == Mapped)
             m_decoInputExtent.map();
     } else {
@@ -1165,7 +1169,10 @@ void X11Client::destroyDecoration()
             Q_EMIT geometryShapeChanged(this, oldgeom);
         }
     }
-    m_decoInputExtent.reset();
+    if (m_decoInputExtent.isValid()) {
+        m_decoInputExtent.reset();
+        workspace()->updateX11ClientIndex(this);
+    }
 }
 
 void X11Client::maybeCreateX11DecorationRenderer()
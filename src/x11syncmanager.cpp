@@ -9,6 +9,7 @@
 #include "x11syncmanager.h"
 #include "composite.h"
 #include "main.h"
+#include "performancemonitor.h"
 #include "platform.h"
 #include "renderbackend.h"
 #include "scene.h"
@@ -19,6 +20,11 @@
 namespace KWin
 {
 
+// a fence that is not signaled within this time is considered lost
+static const std::chrono::seconds s_fenceTimeout(1);
+// the number of frames after which the ring is shrunk to the fences needed in that time
+static const int s_resizeInterval = 600;
+
 X11SyncObject::X11SyncObject()
 {
     m_state = Ready;
@@ -31,8 +37,16 @@ X11SyncObject::X11SyncObject()
     m_sync = glImportSyncEXT(GL_SYNC_X11_FENCE_EXT, m_fence, 0);
 }
 
+X11SyncObject::X11SyncObject(Unmanaged)
+    : m_state(Ready)
+{
+}
+
 X11SyncObject::~X11SyncObject()
 {
+    if (m_fence == XCB_NONE) {
+        return;
+    }
     xcb_connection_t *const connection = kwinApp()->x11Connection();
     // If glDeleteSync is called before the xcb fence is signalled
     // the nvidia driver (the only one to implement GL_SYNC_X11_FENCE_EXT)
@@ -40,7 +54,9 @@ X11SyncObject::~X11SyncObject()
     // To avoid this, make sure the fence is signalled before
     // deleting the sync.
     if (m_state == Resetting || m_state == Ready){
-        trigger();
+        // The X server processes the reset request before the trigger request,
+        // so there is no need to wait for the reset to finish.
+        xcb_sync_trigger_fence(connection, m_fence);
         // The flush is necessary!
         // The trigger command needs to be sent to the X server.
         xcb_flush(connection);
@@ -55,15 +71,11 @@ X11SyncObject::~X11SyncObject()
 
 void X11SyncObject::trigger()
 {
-    Q_ASSERT(m_state == Ready || m_state == Resetting);
-
-    // Finish resetting the fence if necessary
-    if (m_state == Resetting) {
-        finishResetting();
-    }
+    Q_ASSERT(m_state == Ready);
 
     xcb_sync_trigger_fence(kwinApp()->x11Connection(), m_fence);
     m_state = TriggerSent;
+    m_triggerTime = std::chrono::steady_clock::now();
 }
 
 void X11SyncObject::wait()
@@ -76,7 +88,7 @@ void X11SyncObject::wait()
     m_state = Waiting;
 }
 
-bool X11SyncObject::finish()
+bool X11SyncObject::isSignaled()
 {
     if (m_state == Done) {
         return true;
@@ -87,25 +99,10 @@ bool X11SyncObject::finish()
     //       window because it is fully occluded.
     Q_ASSERT(m_state == TriggerSent || m_state == Waiting);
 
-    // Check if the fence is signaled
     GLint value;
     glGetSynciv(m_sync, GL_SYNC_STATUS, 1, nullptr, &value);
-
     if (value != GL_SIGNALED) {
-        qCDebug(KWIN_CORE) << "Waiting for X fence to finish";
-
-        // Wait for the fence to become signaled with a one second timeout
-        const GLenum result = glClientWaitSync(m_sync, 0, 1000000000);
-
-        switch (result) {
-        case GL_TIMEOUT_EXPIRED:
-            qCWarning(KWIN_CORE) << "Timeout while waiting for X fence";
-            return false;
-
-        case GL_WAIT_FAILED:
-            qCWarning(KWIN_CORE) << "glClientWaitSync() failed";
-            return false;
-        }
+        return false;
     }
 
     m_state = Done;
@@ -130,11 +127,19 @@ void X11SyncObject::reset()
     m_state = Resetting;
 }
 
-void X11SyncObject::finishResetting()
+bool X11SyncObject::pollResetting()
 {
     Q_ASSERT(m_state == Resetting);
-    free(xcb_get_input_focus_reply(kwinApp()->x11Connection(), m_reset_cookie, nullptr));
+
+    void *reply = nullptr;
+    xcb_generic_error_t *error = nullptr;
+    if (!xcb_poll_for_reply(kwinApp()->x11Connection(), m_reset_cookie.sequence, &reply, &error)) {
+        return false;
+    }
+    free(reply);
+    free(error);
     m_state = Ready;
+    return true;
 }
 
 X11SyncManager *X11SyncManager::create()
@@ -165,28 +170,47 @@ X11SyncManager *X11SyncManager::create()
     return nullptr;
 }
 
+static void makeOpenGLContextCurrent()
+{
+    if (Compositor::self() && Compositor::self()->scene()) {
+        Compositor::self()->scene()->makeOpenGLContextCurrent();
+    }
+}
+
 X11SyncManager::X11SyncManager()
+    : X11SyncManager([]() {
+        return new X11SyncObject;
+    })
 {
-    for (int i = 0; i < MaxFences; ++i) {
-        m_fences.append(new X11SyncObject);
+}
+
+X11SyncManager::X11SyncManager(const FenceFactory &createFence)
+    : m_createFence(createFence)
+{
+    for (int i = 0; i < MinFences; ++i) {
+        m_fences.append(m_createFence());
     }
+    PerformanceMonitor::self()->x11SyncStatistics()->fenceCount.store(m_fences.count(), std::memory_order_relaxed);
 }
 
 X11SyncManager::~X11SyncManager()
 {
-    Compositor::self()->scene()->makeOpenGLContextCurrent();
+    makeOpenGLContextCurrent();
     qDeleteAll(m_fences);
+    PerformanceMonitor::self()->x11SyncStatistics()->fenceCount.store(0, std::memory_order_relaxed);
 }
 
-bool X11SyncManager::endFrame()
+void X11SyncManager::pollFences()
 {
-    if (!m_currentFence) {
-        return true;
-    }
-
-    for (int i = 0; i < std::min(2, m_fences.count() - 1); i++) {
-        const int index = (m_next + i) % m_fences.count();
-        X11SyncObject *fence = m_fences[index];
+    X11SyncStatistics *statistics = PerformanceMonitor::self()->x11SyncStatistics();
+    const auto now = std::chrono::steady_clock::now();
+
+    int inFlight = 0;
+    for (X11SyncObject *fence : qAsConst(m_fences)) {
+        if (fence == m_currentFence) {
+            inFlight++;
+            continue;
+        }
 
         switch (fence->state()) {
         case X11SyncObject::Ready:
@@ -194,32 +218,113 @@ bool X11SyncManager::endFrame()
 
         case X11SyncObject::TriggerSent:
         case X11SyncObject::Waiting:
-            if (!fence->finish()) {
-                return false;
+            if (!fence->isSignaled()) {
+                if (now - fence->triggerTime() > s_fenceTimeout) {
+                    qCWarning(KWIN_CORE) << "Timeout while waiting for X fence";
+                    statistics->timeouts.fetch_add(1, std::memory_order_relaxed);
+                    m_timedOut = true;
+                }
+                inFlight++;
+                break;
             }
+            statistics->fenceLatency.record(now - fence->triggerTime());
             fence->reset();
+            inFlight++;
             break;
 
-        // Should not happen in practice since we always reset the fence after finishing it
+        // Should not happen in practice since we always reset the fence after it is signaled
         case X11SyncObject::Done:
             fence->reset();
+            inFlight++;
             break;
 
         case X11SyncObject::Resetting:
-            fence->finishResetting();
+            if (!fence->pollResetting()) {
+                inFlight++;
+            }
             break;
         }
     }
+    m_peakInFlight = std::max(m_peakInFlight, inFlight);
+}
+
+void X11SyncManager::resizeRing()
+{
+    // keep a fence in reserve for the frame being rendered and one for the next frame
+    const int wanted = std::max<int>(MinFences, m_peakInFlight + 2);
+    m_peakInFlight = 0;
+    m_framesSinceResize = 0;
+    if (m_fences.count() <= wanted) {
+        return;
+    }
+
+    makeOpenGLContextCurrent();
+    for (int i = m_fences.count() - 1; i >= 0 && m_fences.count() > wanted; --i) {
+        X11SyncObject *fence = m_fences[i];
+        if (fence == m_currentFence || fence->state() != X11SyncObject::Ready) {
+            continue;
+        }
+        m_fences.removeAt(i);
+        delete fence;
+        if (i < m_next) {
+            m_next--;
+        }
+    }
+    m_next %= m_fences.count();
+    PerformanceMonitor::self()->x11SyncStatistics()->fenceCount.store(m_fences.count(), std::memory_order_relaxed);
+}
 
+bool X11SyncManager::endFrame()
+{
     m_currentFence = nullptr;
+    pollFences();
+    if (m_timedOut) {
+        return false;
+    }
+    if (++m_framesSinceResize >= s_resizeInterval) {
+        resizeRing();
+    }
     return true;
 }
 
-void X11SyncManager::triggerFence()
+X11SyncManager::TriggerResult X11SyncManager::triggerFence()
 {
-    m_currentFence = m_fences[m_next];
+    pollFences();
+    if (m_timedOut) {
+        // a stuck fence would otherwise keep the ring full and every frame skipped
+        return TriggerResult::TimedOut;
+    }
+
+    X11SyncStatistics *statistics = PerformanceMonitor::self()->x11SyncStatistics();
+    const auto now = std::chrono::steady_clock::now();
+
+    X11SyncObject *fence = m_fences[m_next];
+    if (fence->state() != X11SyncObject::Ready) {
+        if (m_fences.count() >= MaxFences) {
+            // The X server is busy, skip the frame instead of waiting for it
+            if (!m_stallStart) {
+                m_stallStart = now;
+            }
+            statistics->skippedFrames.fetch_add(1, std::memory_order_relaxed);
+            return TriggerResult::Busy;
+        }
+
+        // The oldest fence is still in flight, grow the ring in front of it
+        makeOpenGLContextCurrent();
+        fence = m_createFence();
+        m_fences.insert(m_next, fence);
+        statistics->fenceCount.store(m_fences.count(), std::memory_order_relaxed);
+    }
+
+    if (m_stallStart) {
+        statistics->stallTime.record(now - *m_stallStart);
+        m_stallStart.reset();
+    }
+
+    m_currentFence = fence;
     m_next = (m_next + 1) % m_fences.count();
     m_currentFence->trigger();
+    return TriggerResult::Triggered;
 }
 
 void X11SyncManager::insertWait()
@@ -7,10 +7,15 @@
 #pragma once
 
 #include "deepin_kwinglutils.h"
+#include "deepin_kwinglobals.h"
 
 #include <xcb/xcb.h>
 #include <xcb/sync.h>
 
+#include <chrono>
+#include <functional>
+#include <optional>
+
 namespace KWin
 {
 
@@ -18,52 +23,96 @@ namespace KWin
  * SyncObject represents a fence used to synchronize operations in the kwin command stream
  * with operations in the X command stream.
  */
-class X11SyncObject
+class KWIN_EXPORT X11SyncObject
 {
 public:
     enum State { Ready, TriggerSent, Waiting, Done, Resetting, };
 
     X11SyncObject();
-    ~X11SyncObject();
+    virtual ~X11SyncObject();
 
     State state() const { return m_state; }
 
-    void trigger();
-    void wait();
-    bool finish();
-    void reset();
-    void finishResetting();
+    std::chrono::steady_clock::time_point triggerTime() const { return m_triggerTime; }
+
+    virtual void trigger();
+    virtual void wait();
+    virtual bool isSignaled();
+    virtual void reset();
+    virtual bool pollResetting();
+
+protected:
+    struct Unmanaged {};
+    /**
+     * Creates a fence without any X11 or OpenGL resources, the subclass implements
+     * the state transitions. Used by the tests.
+     */
+    explicit X11SyncObject(Unmanaged);
 
-private:
     State m_state;
-    GLsync m_sync;
-    xcb_sync_fence_t m_fence;
+    std::chrono::steady_clock::time_point m_triggerTime;
+
+private:
+    GLsync m_sync = nullptr;
+    xcb_sync_fence_t m_fence = XCB_NONE;
     xcb_get_input_focus_cookie_t m_reset_cookie;
 };
 
 /**
  * SyncManager manages a set of fences used for explicit synchronization with the X command
  * stream.
+ *
+ * The fences are polled without blocking. If the X server falls behind, more fences are
+ * added to the ring, up to MaxFences. Once all of them are in use, triggerFence() fails
+ * and the frame has to be skipped. The ring shrinks again when fewer fences are in flight.
  */
-class X11SyncManager
+class KWIN_EXPORT X11SyncManager
 {
 public:
-    enum { MaxFences = 4 };
+    enum { MinFences = 4, MaxFences = 16 };
+
+    enum class TriggerResult {
+        Triggered,
+        // all fences are in flight, the frame should be skipped
+        Busy,
+        // a fence has not been signaled in time, synchronization should be given up
+        TimedOut,
+    };
+
+    using FenceFactory = std::function<X11SyncObject *()>;
 
     static X11SyncManager *create();
+    /**
+     * Creates a manager whose fences are made by @p createFence. Used by the tests.
+     */
+    explicit X11SyncManager(const FenceFactory &createFence);
     ~X11SyncManager();
 
+    /**
+     * Returns @c false if a fence has not been signaled in time, in which case the
+     * synchronization with the X command stream should be given up.
+     */
     bool endFrame();
 
-    void triggerFence();
+    TriggerResult triggerFence();
     void insertWait();
 
+    int fenceCount() const { return m_fences.count(); }
+
 private:
     X11SyncManager();
 
+    void pollFences();
+    void resizeRing();
+
+    FenceFactory m_createFence;
     X11SyncObject *m_currentFence = nullptr;
     QVector<X11SyncObject *> m_fences;
     int m_next = 0;
+    int m_peakInFlight = 0;
+    int m_framesSinceResize = 0;
+    bool m_timedOut = false;
+    std::optional<std::chrono::steady_clock::time_point> m_stallStart;
 };
 
 } // namespace KWin
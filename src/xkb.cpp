@@ -15,6 +15,12 @@
 #include <DWayland/Server/seat_interface.h>
 #include <DWayland/Server/ddeseat_interface.h>
 // Qt
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QTemporaryFile>
 #include <QKeyEvent>
 #include <QtXkbCommonSupport/private/qxkbcommon_p.h>
@@ -24,6 +30,7 @@
 // system
 #include <sys/mman.h>
 #include <unistd.h>
+#include <algorithm>
 #include <bitset>
 
 Q_LOGGING_CATEGORY(KWIN_XKB, "kwin_xkbcommon", QtWarningMsg)
@@ -31,6 +38,10 @@ Q_LOGGING_CATEGORY(KWIN_XKB, "kwin_xkbcommon", QtWarningMsg)
 namespace KWin
 {
 
+// compiled keymaps kept in memory and serialized keymaps kept on disk
+static const int s_maxCachedKeymaps = 8;
+static const int s_maxCachedKeymapFiles = 16;
+
 static void xkbLogHandler(xkb_context *context, xkb_log_level priority, const char *format, va_list args)
 {
     Q_UNUSED(context)
@@ -114,6 +125,7 @@ Xkb::~Xkb()
     xkb_compose_table_unref(m_compose.table);
     xkb_state_unref(m_state);
     xkb_keymap_unref(m_keymap);
+    clearKeymapCache();
     xkb_context_unref(m_context);
 }
 
@@ -125,12 +137,53 @@ void Xkb::setNumLockConfig(const KSharedConfigPtr &config) {
     m_numLockConfig = config;
 }
 
+static qint64 newestModification(const QString &path, QDirIterator::IteratorFlags flags)
+{
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        return 0;
+    }
+    qint64 newest = info.lastModified().toMSecsSinceEpoch();
+    QDirIterator it(path, QDir::AllEntries | QDir::NoDotAndDotDot, flags);
+    while (it.hasNext()) {
+        it.next();
+        newest = std::max(newest, it.fileInfo().lastModified().toMSecsSinceEpoch());
+    }
+    return newest;
+}
+
+/**
+ * Changes whenever any of the xkb data files is updated, so that keymaps compiled from older
+ * files are not reused. The system data is installed by packages, which replace files rather
+ * than editing them, so the times of its component directories (rules, symbols, ...) are
+ * enough and the hundreds of files in them are not stat'ed. The few files in the per-user
+ * include paths may be edited in place and are looked at one by one.
+ **/
+static QByteArray xkbDataStamp(xkb_context *context)
+{
+    const QString home = QDir::homePath() + QLatin1Char('/');
+    QByteArray stamp;
+    for (unsigned int i = 0; i < xkb_context_num_include_paths(context); ++i) {
+        const QString path = QFile::decodeName(xkb_context_include_path_get(context, i));
+        const QDirIterator::IteratorFlags flags = path.startsWith(home) ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags;
+        stamp += path.toLocal8Bit() + ':' + QByteArray::number(newestModification(path, flags)) + ';';
+    }
+    return stamp;
+}
+
 void Xkb::reconfigure()
 {
     if (!m_context) {
         return;
     }
 
+    // the xkb data files may have been edited since the cached keymaps were compiled
+    const QByteArray dataStamp = xkbDataStamp(m_context);
+    if (dataStamp != m_keymapDataStamp) {
+        clearKeymapCache();
+        m_keymapDataStamp = dataStamp;
+    }
+
     xkb_keymap *keymap = nullptr;
     if (!qEnvironmentVariableIsSet("KWIN_XKB_DEFAULT_KEYMAP")) {
         keymap = loadKeymapFromConfig();
@@ -203,7 +256,7 @@ xkb_keymap *Xkb::loadKeymapFromConfig()
 
     m_layoutList = QString::fromLatin1(ruleNames.layout).split(QLatin1Char(','));
 
-    return xkb_keymap_new_from_names(m_context, &ruleNames, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    return compileKeymap(ruleNames);
 }
 
 xkb_keymap *Xkb::loadDefaultKeymap()
@@ -211,7 +264,117 @@ xkb_keymap *Xkb::loadDefaultKeymap()
     xkb_rule_names ruleNames = {};
     applyEnvironmentRules(ruleNames);
     m_layoutList = QString::fromLatin1(ruleNames.layout).split(QLatin1Char(','));
-    return xkb_keymap_new_from_names(m_context, &ruleNames, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    return compileKeymap(ruleNames);
+}
+
+static QByteArray ruleNamesKey(const xkb_rule_names &ruleNames)
+{
+    // a null name selects the default while an empty one may not, so keep them apart
+    auto name = [](const char *value) {
+        return value ? QByteArrayLiteral("=") + value : QByteArray();
+    };
+    return name(ruleNames.rules) + '\n' + name(ruleNames.model) + '\n' + name(ruleNames.layout) + '\n'
+        + name(ruleNames.variant) + '\n' + name(ruleNames.options);
+}
+
+static QString keymapCacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/xkb");
+}
+
+/**
+ * Compiling a keymap from rule names takes tens of milliseconds. The compiled keymaps
+ * are kept in memory, and their text form is stored on disk, where loading it again
+ * is much cheaper than compiling the rules.
+ **/
+xkb_keymap *Xkb::compileKeymap(const xkb_rule_names &ruleNames)
+{
+    const QByteArray key = ruleNamesKey(ruleNames);
+    auto it = m_keymapCache.find(key);
+    if (it != m_keymapCache.end()) {
+        it->lastUsed = ++m_keymapCacheClock;
+        return xkb_keymap_ref(it->keymap);
+    }
+
+    if (m_keymapDataStamp.isEmpty()) {
+        m_keymapDataStamp = xkbDataStamp(m_context);
+    }
+    const QByteArray hash = QCryptographicHash::hash(key + '\n' + m_keymapDataStamp, QCryptographicHash::Sha1);
+    const QString fileName = QString::fromLatin1(hash.toHex()) + QStringLiteral(".xkb");
+
+    CachedKeymap cached;
+    cached.keymap = loadCachedKeymap(fileName, cached.contents);
+    if (!cached.keymap) {
+        cached.keymap = xkb_keymap_new_from_names(m_context, &ruleNames, XKB_KEYMAP_COMPILE_NO_FLAGS);
+        if (!cached.keymap) {
+            return nullptr;
+        }
+        ScopedCPointer<char> keymapString(xkb_keymap_get_as_string(cached.keymap, XKB_KEYMAP_FORMAT_TEXT_V1));
+        if (!keymapString.isNull()) {
+            cached.contents = keymapString.data();
+            storeCachedKeymap(fileName, cached.contents);
+        }
+    }
+
+    if (m_keymapCache.count() >= s_maxCachedKeymaps) {
+        // drop the least recently used keymap, unless it is the one in use
+        auto oldest = m_keymapCache.end();
+        for (auto it = m_keymapCache.begin(); it != m_keymapCache.end(); ++it) {
+            if (it->keymap != m_keymap && (oldest == m_keymapCache.end() || it->lastUsed < oldest->lastUsed)) {
+                oldest = it;
+            }
+        }
+        if (oldest != m_keymapCache.end()) {
+            xkb_keymap_unref(oldest->keymap);
+            m_keymapCache.erase(oldest);
+        }
+    }
+    cached.lastUsed = ++m_keymapCacheClock;
+    m_keymapCache.insert(key, cached);
+    return xkb_keymap_ref(cached.keymap);
+}
+
+void Xkb::clearKeymapCache()
+{
+    for (const CachedKeymap &cached : qAsConst(m_keymapCache)) {
+        xkb_keymap_unref(cached.keymap);
+    }
+    m_keymapCache.clear();
+}
+
+xkb_keymap *Xkb::loadCachedKeymap(const QString &fileName, QByteArray &contents)
+{
+    QFile file(keymapCacheDirectory() + QLatin1Char('/') + fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    contents = file.readAll();
+    xkb_keymap *keymap = xkb_keymap_new_from_string(m_context, contents.constData(), XKB_KEYMAP_FORMAT_TEXT_V1, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    if (!keymap) {
+        qCDebug(KWIN_XKB) << "Discarding invalid cached keymap" << file.fileName();
+        file.remove();
+        contents.clear();
+    }
+    return keymap;
+}
+
+void Xkb::storeCachedKeymap(const QString &fileName, const QByteArray &contents)
+{
+    QDir directory(keymapCacheDirectory());
+    if (!directory.mkpath(QStringLiteral("."))) {
+        return;
+    }
+    QSaveFile file(directory.filePath(fileName));
+    if (!file.open(QIODevice::WriteOnly) || file.write(contents) != contents.size() || !file.commit()) {
+        qCDebug(KWIN_XKB) << "Could not store keymap in cache" << file.fileName();
+        return;
+    }
+
+    // drop the least recently written keymaps
+    const QFileInfoList entries = directory.entryInfoList({QStringLiteral("*.xkb")}, QDir::Files, QDir::Time);
+    for (int i = s_maxCachedKeymapFiles; i < entries.count(); ++i) {
+        QFile::remove(entries[i].filePath());
+    }
 }
 
 void Xkb::installKeymap(int fd, uint32_t size)
@@ -258,6 +421,20 @@ void Xkb::updateKeymap(xkb_keymap *keymap)
     m_keymap = keymap;
     m_state = state;
 
+    m_keymapContents.clear();
+    for (const CachedKeymap &cached : qAsConst(m_keymapCache)) {
+        if (cached.keymap == m_keymap) {
+            m_keymapContents = cached.contents;
+            break;
+        }
+    }
+    if (m_keymapContents.isEmpty()) {
+        ScopedCPointer<char> keymapString(xkb_keymap_get_as_string(m_keymap, XKB_KEYMAP_FORMAT_TEXT_V1));
+        if (!keymapString.isNull()) {
+            m_keymapContents = keymapString.data();
+        }
+    }
+
     m_shiftModifier   = xkb_keymap_mod_get_index(m_keymap, XKB_MOD_NAME_SHIFT);
     m_capsModifier    = xkb_keymap_mod_get_index(m_keymap, XKB_MOD_NAME_CAPS);
     m_controlModifier = xkb_keymap_mod_get_index(m_keymap, XKB_MOD_NAME_CTRL);
@@ -314,7 +491,14 @@ void Xkb::createKeymapFile()
     if (currentKeymap.isEmpty()) {
         return;
     }
-    m_seat->keyboard()->setKeymap(currentKeymap);
+    // reloading the same layouts must not make every client reload its keymap
+    KWaylandServer::KeyboardInterface *keyboard = m_seat->keyboard();
+    if (m_sentKeymapKeyboard == keyboard && m_sentKeymap == currentKeymap) {
+        return;
+    }
+    m_sentKeymapKeyboard = keyboard;
+    m_sentKeymap = currentKeymap;
+    keyboard->setKeymap(currentKeymap);
 }
 
 QByteArray Xkb::keymapContents() const
@@ -326,12 +510,7 @@ QByteArray Xkb::keymapContents() const
     if (!m_keymap) {
         return {};
     }
-
-    ScopedCPointer<char> keymapString(xkb_keymap_get_as_string(m_keymap, XKB_KEYMAP_FORMAT_TEXT_V1));
-    if (keymapString.isNull()) {
-        return {};
-    }
-    return keymapString.data();
+    return m_keymapContents;
 }
 
 void Xkb::updateModifiers(uint32_t modsDepressed, uint32_t modsLatched, uint32_t modsLocked, uint32_t group)
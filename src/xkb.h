@@ -11,6 +11,7 @@
 #include "input.h"
 #include <xkbcommon/xkbcommon.h>
 
+#include <QHash>
 #include <QObject>
 #include <QtDBus>
 
@@ -35,6 +36,7 @@ namespace KWaylandServer
 {
     class SeatInterface;
     class DDESeatInterface;
+    class KeyboardInterface;
 }
 
 namespace KWin
@@ -103,6 +105,10 @@ public:
     void forwardModifiers();
 
     void setSeat(KWaylandServer::SeatInterface *seat);
+    /**
+     * The current keymap serialized as text, as it is sent to the clients. The
+     * returned array shares its data with the keymap cache.
+     */
     QByteArray keymapContents() const;
 
     void setDDESeat(KWaylandServer::DDESeatInterface *ddeseat);
@@ -120,6 +126,10 @@ private:
     void applyEnvironmentRules(xkb_rule_names &);
     xkb_keymap *loadKeymapFromConfig();
     xkb_keymap *loadDefaultKeymap();
+    xkb_keymap *compileKeymap(const xkb_rule_names &ruleNames);
+    xkb_keymap *loadCachedKeymap(const QString &fileName, QByteArray &contents);
+    void storeCachedKeymap(const QString &fileName, const QByteArray &contents);
+    void clearKeymapCache();
     void updateKeymap(xkb_keymap *keymap);
     void createKeymapFile();
     void updateModifiers();
@@ -162,6 +172,21 @@ private:
     };
     Ownership m_ownership = Ownership::Server;
 
+    struct CachedKeymap {
+        xkb_keymap *keymap = nullptr;
+        QByteArray contents;
+        quint64 lastUsed = 0;
+    };
+    // compiled keymaps by their rule names, each of them holds a reference on the keymap
+    QHash<QByteArray, CachedKeymap> m_keymapCache;
+    quint64 m_keymapCacheClock = 0;
+    // state of the xkb data files the cached keymaps have been compiled from
+    QByteArray m_keymapDataStamp;
+    QByteArray m_keymapContents;
+    // the keymap the seat's keyboard was given last
+    QByteArray m_sentKeymap;
+    QPointer<KWaylandServer::KeyboardInterface> m_sentKeymapKeyboard;
+
     QPointer<KWaylandServer::SeatInterface> m_seat;
     QPointer<KWaylandServer::DDESeatInterface> m_ddeSeat;
 };